@@ -85,3 +85,13 @@ static constexpr uint32_t CALC_E_OVERFLOW = (uint32_t)0x80000008;
 //
 // The result of this operation is undefined
 static constexpr uint32_t CALC_E_NORESULT = (uint32_t)0x80000009;
+
+// CALC_E_CANCELLED
+//
+// The operation was cancelled by the poll callback of the context
+static constexpr uint32_t CALC_E_CANCELLED = (uint32_t)0x8000000A;
+
+// CALC_E_TIMELIMIT
+//
+// The operation was not started, its estimated time exceeds the time limit
+static constexpr uint32_t CALC_E_TIMELIMIT = (uint32_t)0x8000000B;
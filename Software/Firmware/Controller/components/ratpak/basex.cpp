@@ -17,7 +17,7 @@
 #include "ratpak.h"
 #include <cstring> // for memmove
 
-void _mulnumx(PNUMBER *pa, PNUMBER b);
+PNUMBER _mulnumx(PNUMBER a, PNUMBER b);
 
 //----------------------------------------------------------------------------
 //
@@ -43,7 +43,9 @@ void mulnumx(PNUMBER *pa, PNUMBER b)
     if ((*pa)->cdigit > 1 || (*pa)->mant[0] != 1 || (*pa)->exp != 0)
     {
       // pa and b are both non-one.
-      _mulnumx(pa, b);
+      PNUMBER c = _mulnumx(*pa, b);
+      destroynum(*pa);
+      *pa = c;
     }
     else
     {
@@ -62,25 +64,60 @@ void mulnumx(PNUMBER *pa, PNUMBER b)
 
 //----------------------------------------------------------------------------
 //
-//    FUNCTION: _mulnumx
+//    FUNCTION: mulnumx_into
 //
-//    ARGUMENTS: pointer to a number and a second number, the
-//               base is always BASEX.
+//    ARGUMENTS: pointer to the result and two numbers, the base is always
+//               BASEX.
 //
 //    RETURN: None, changes first pointer.
 //
-//    DESCRIPTION: Does the number equivalent of *pa *= b.
+//    DESCRIPTION: Does the number equivalent of *pc = a * b without
+//    touching a and b. The old *pc is destroyed, it may be a or b.
+//
+//----------------------------------------------------------------------------
+
+void mulnumx_into(PNUMBER *pc, PNUMBER a, PNUMBER b)
+
+{
+  PNUMBER c = nullptr;
+  if (b->cdigit == 1 && b->mant[0] == 1 && b->exp == 0)
+  {
+    // b is +/- 1, the result is a with the sign of both.
+    DUPNUM(c, a);
+    c->sign *= b->sign;
+  }
+  else if (a->cdigit == 1 && a->mant[0] == 1 && a->exp == 0)
+  {
+    DUPNUM(c, b);
+    c->sign *= a->sign;
+  }
+  else
+  {
+    c = _mulnumx(a, b);
+  }
+  destroynum(*pc);
+  *pc = c;
+}
+
+//----------------------------------------------------------------------------
+//
+//    FUNCTION: _mulnumx
+//
+//    ARGUMENTS: two numbers, the base is always BASEX.
+//
+//    RETURN: the product as a new number.
+//
+//    DESCRIPTION: Does the number equivalent of a * b.
 //    Assumes the base is BASEX of both numbers.  This algorithm is the
 //    same one you learned in grade school, except the base isn't 10 it's
 //    BASEX.
 //
 //----------------------------------------------------------------------------
 
-void _mulnumx(PNUMBER *pa, PNUMBER b)
+PNUMBER _mulnumx(PNUMBER a, PNUMBER b)
 
 {
   PNUMBER c = nullptr;  // c will contain the result.
-  PNUMBER a = nullptr;  // a is the dereferenced number pointer from *pa
   MANTTYPE *ptra;       // ptra is a pointer to the mantissa of a.
   MANTTYPE *ptrb;       // ptrb is a pointer to the mantissa of b.
   MANTTYPE *ptrc;       // ptrc is a pointer to the mantissa of c.
@@ -95,8 +132,6 @@ void _mulnumx(PNUMBER *pa, PNUMBER b)
                         // multiply, AND the carry of that multiply.
   int32_t icdigit = 0;  // Index of digit being calculated in final result.
 
-  a = *pa;
-
   ibdigit = a->cdigit + b->cdigit - 1;
   createnum(c, ibdigit + 1);
   c->cdigit = ibdigit;
@@ -131,19 +166,20 @@ void _mulnumx(PNUMBER *pa, PNUMBER b)
       while (mcy || cy)
       {
         // update carry from addition(s) and multiply.
-        cy += (TWO_MANTTYPE)ptrc[icdigit] + ((uint32_t)mcy & ((uint32_t)~BASEX));
+        cy += (TWO_MANTTYPE)ptrc[icdigit] + (mcy % BASEX);
 
         // update result digit from
-        ptrc[icdigit++] = (MANTTYPE)((uint32_t)cy & ((uint32_t)~BASEX));
+        ptrc[icdigit++] = (MANTTYPE)(cy % BASEX);
 
         // update carries from
-        mcy >>= BASEXPWR;
-        cy >>= BASEXPWR;
+        mcy /= BASEX;
+        cy /= BASEX;
       }
 
       ptrb++;
       ptrc++;
     }
+    RATPAK_POLL(b->cdigit);
   }
 
   // prevent different kinds of zeros, by stripping leading duplicate zeros.
@@ -153,8 +189,7 @@ void _mulnumx(PNUMBER *pa, PNUMBER b)
     c->cdigit--;
   }
 
-  destroynum(*pa);
-  *pa = c;
+  return (c);
 }
 //-----------------------------------------------------------------------------
 //
@@ -330,6 +365,7 @@ void _divnumx(PNUMBER *pa, PNUMBER b, int32_t precision)
     }
     rem->exp++;
     ptrc--;
+    RATPAK_POLL(b->cdigit);
   }
   cdigits--;
   if (c->mant != ++ptrc)
@@ -29,12 +29,6 @@ static constexpr int MAX_ZEROS_AFTER_DECIMAL = 2;
 // digits 0..64 used by bases 2 .. 64
 static constexpr string_view DIGITS = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz_@";
 
-// ratio of internal 'digits' to output 'digits'
-// Calculated elsewhere as part of initialization and when base is changed
-int32_t g_ratio; // int(log(2L^BASEXPWR)/log(radix))
-// Default decimal separator
-char g_decimalSeparator = '.';
-
 
 #ifndef Calc_UInt32x32To64
 #define Calc_UInt32x32To64(a, b) ((uint64_t)((uint32_t)(a)) * (uint64_t)((uint32_t)(b)))
@@ -91,11 +85,57 @@ void SetDecimalSeparator(char decimalSeparator)
 }
 
 //
-// Windows heap allocation
+// Heap allocation, uses the allocator of the current context if it has one.
+// With RATPAK_ALLOC_STATS the block starts with its size, the caller gets
+// the memory behind it.
 //
 void *zmalloc(size_t a)
 {
+#if RATPAK_ALLOC_STATS
+  size_t *p = (size_t *)(g_ratctx->alloc != nullptr ? g_ratctx->alloc(a + sizeof(size_t)) : calloc(a + sizeof(size_t), sizeof(unsigned char)));
+  if (p == nullptr)
+  {
+    return (nullptr);
+  }
+  *p = a;
+  RATALLOCSTATS &stats = g_ratctx->allocStats;
+  stats.allocs++;
+  stats.bytes += a;
+  stats.liveBytes += (uint32_t)a;
+  if (stats.liveBytes > stats.peakBytes)
+  {
+    stats.peakBytes = stats.liveBytes;
+  }
+  return (p + 1);
+#else
+  if (g_ratctx->alloc != nullptr)
+  {
+    return (g_ratctx->alloc(a));
+  }
   return calloc(a, sizeof(unsigned char));
+#endif
+}
+
+//
+// Releases memory allocated by zmalloc
+//
+void zfree(void *p)
+{
+#if RATPAK_ALLOC_STATS
+  size_t *block = (size_t *)p - 1;
+  RATALLOCSTATS &stats = g_ratctx->allocStats;
+  stats.frees++;
+  stats.liveBytes -= (uint32_t)*block;
+  p = block;
+#endif
+  if (g_ratctx->release != nullptr)
+  {
+    g_ratctx->release(p);
+  }
+  else
+  {
+    free(p);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -132,7 +172,7 @@ void _destroynum(PNUMBER pnum)
 {
   if (pnum != nullptr)
   {
-    free(pnum);
+    zfree(pnum);
   }
 }
 
@@ -156,7 +196,7 @@ void _destroyrat(PRAT prat)
   {
     destroynum(prat->pp);
     destroynum(prat->pq);
-    free(prat);
+    zfree(prat);
   }
 }
 
@@ -184,12 +224,12 @@ PNUMBER _createnum(uint32_t size)
     pnumret = (PNUMBER)zmalloc(cbAlloc);
     if (pnumret == nullptr)
     {
-      throw(CALC_E_OUTOFMEMORY);
+      RATPAK_FATAL(CALC_E_OUTOFMEMORY);
     }
   }
   else
   {
-    throw(CALC_E_INVALIDRANGE);
+    RATPAK_FATAL(CALC_E_INVALIDRANGE);
   }
   return (pnumret);
 }
@@ -217,7 +257,7 @@ PRAT _createrat(void)
 
   if (prat == nullptr)
   {
-    throw(CALC_E_OUTOFMEMORY);
+    RATPAK_FATAL(CALC_E_OUTOFMEMORY);
   }
   prat->pp = nullptr;
   prat->pq = nullptr;
@@ -284,9 +324,6 @@ PRAT numtorat(PNUMBER pin, uint32_t radix)
 PNUMBER nRadixxtonum(PNUMBER a, uint32_t radix, int32_t precision)
 
 {
-  PNUMBER sum = i32tonum(0, radix);
-  PNUMBER powofnRadix = i32tonum(BASEX, radix);
-
   // A large penalty is paid for conversion of digits no one will see anyway.
   // limit the digits to the minimum of the existing precision or the
   // requested precision.
@@ -296,12 +333,55 @@ PNUMBER nRadixxtonum(PNUMBER a, uint32_t radix, int32_t precision)
     cdigits = (uint32_t)a->cdigit;
   }
 
+#if RATPAK_DECIMAL_BASE
+  if (radix == 10)
+  {
+    // every internal digit holds BASEXDIGITS decimal digits, slice them
+    PNUMBER pnumret = nullptr;
+    createnum(pnumret, cdigits * BASEXDIGITS);
+    MANTTYPE *pdigit = pnumret->mant;
+    for (MANTTYPE *ptr = &(a->mant[a->cdigit - cdigits]); ptr < &(a->mant[a->cdigit]); ptr++)
+    {
+      MANTTYPE digit = *ptr;
+      for (uint32_t i = 0; i < BASEXDIGITS; i++)
+      {
+        *pdigit++ = digit % 10;
+        digit /= 10;
+      }
+    }
+    pnumret->cdigit = cdigits * BASEXDIGITS;
+    pnumret->exp = (a->exp + (a->cdigit - cdigits)) * BASEXDIGITS;
+    while (pnumret->cdigit > 1 && pnumret->mant[pnumret->cdigit - 1] == 0)
+    {
+      pnumret->cdigit--;
+    }
+    if (zernum(pnumret))
+    {
+      pnumret->exp = 0;
+    }
+    pnumret->sign = a->sign;
+    return (pnumret);
+  }
+#endif
+
+  PNUMBER sum = i32tonum(0, radix);
+  PNUMBER powofnRadix = i32tonum(BASEX, radix);
+
   // scale by the internal base to the internal exponent offset of the LSD
   numpowi32(&powofnRadix, a->exp + (a->cdigit - cdigits), radix, precision);
 
   // Loop over all the relative digits from MSD to LSD
   for (MANTTYPE *ptr = &(a->mant[a->cdigit - 1]); cdigits > 0; ptr--, cdigits--)
   {
+#if RATPAK_DECIMAL_BASE
+    // sum = sum * BASEX + digit
+    PNUMBER thisdigit = i32tonum(*ptr, radix);
+    PNUMBER base = i32tonum(BASEX, radix);
+    mulnum(&sum, base, radix);
+    addnum(&sum, thisdigit, radix);
+    destroynum(base);
+    destroynum(thisdigit);
+#else
     // Loop over all the bits from MSB to LSB
     for (uint32_t bitmask = BASEX / 2; bitmask > 0; bitmask /= 2)
     {
@@ -311,6 +391,7 @@ PNUMBER nRadixxtonum(PNUMBER a, uint32_t radix, int32_t precision)
         sum->mant[0] |= 1;
       }
     }
+#endif
   }
 
   // Scale answer by power of internal exponent.
@@ -337,6 +418,43 @@ PNUMBER nRadixxtonum(PNUMBER a, uint32_t radix, int32_t precision)
 
 PNUMBER numtonRadixx(PNUMBER a, uint32_t radix)
 {
+#if RATPAK_DECIMAL_BASE
+  if (radix == 10)
+  {
+    // pack BASEXDIGITS decimal digits into every internal digit, the decimal
+    // exponent is split into internal digits and a shift inside a digit
+    static constexpr MANTTYPE powers[BASEXDIGITS] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+    int32_t q = a->exp / static_cast<int32_t>(BASEXDIGITS);
+    int32_t r = a->exp % static_cast<int32_t>(BASEXDIGITS);
+    if (r < 0)
+    {
+      q--;
+      r += BASEXDIGITS;
+    }
+    int32_t cdigits = (a->cdigit + r + BASEXDIGITS - 1) / BASEXDIGITS;
+    PNUMBER pnumret = nullptr;
+    createnum(pnumret, cdigits);
+    memset(pnumret->mant, 0, cdigits * sizeof(MANTTYPE));
+    for (int32_t idigit = 0; idigit < a->cdigit; idigit++)
+    {
+      int32_t pos = idigit + r;
+      pnumret->mant[pos / BASEXDIGITS] += a->mant[idigit] * powers[pos % BASEXDIGITS];
+    }
+    pnumret->cdigit = cdigits;
+    pnumret->exp = q;
+    while (pnumret->cdigit > 1 && pnumret->mant[pnumret->cdigit - 1] == 0)
+    {
+      pnumret->cdigit--;
+    }
+    if (zernum(pnumret))
+    {
+      pnumret->exp = 0;
+    }
+    pnumret->sign = a->sign;
+    return (pnumret);
+  }
+#endif
+
   PNUMBER pnumret = i32tonum(0, BASEX); // pnumret is the number in internal form.
   PNUMBER num_radix = i32tonum(radix, BASEX);
   MANTTYPE *ptrdigit = a->mant; // pointer to digit being worked on.
@@ -877,10 +995,11 @@ PNUMBER Ui32tonum(uint32_t ini32, uint32_t radix)
 
 int32_t rattoi32(PRAT prat, uint32_t radix, int32_t precision)
 {
-  if (rat_gt(prat, rat_max_i32, precision) || rat_lt(prat, rat_min_i32, precision))
+  if (rat_gt(prat, rat_max_i32(), precision) || rat_lt(prat, rat_min_i32(), precision))
   {
     // Don't attempt rattoi32 of anything too big or small
-    throw(CALC_E_DOMAIN);
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return (0);
   }
 
   PRAT pint = nullptr;
@@ -912,10 +1031,11 @@ int32_t rattoi32(PRAT prat, uint32_t radix, int32_t precision)
 //-----------------------------------------------------------------------------
 uint32_t rattoUi32(PRAT prat, uint32_t radix, int32_t precision)
 {
-  if (rat_gt(prat, rat_dword, precision) || rat_lt(prat, rat_zero, precision))
+  if (rat_gt(prat, rat_dword(), precision) || rat_lt(prat, rat_zero, precision))
   {
     // Don't attempt rattoui32 of anything too big or small
-    throw(CALC_E_DOMAIN);
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return (0);
   }
 
   PRAT pint = nullptr;
@@ -953,14 +1073,14 @@ uint64_t rattoUi64(PRAT prat, uint32_t radix, int32_t precision)
 
   // first get the LO 32 bit word
   DUPRAT(pint, prat);
-  andrat(&pint, rat_dword, radix, precision);      // & 0xFFFFFFFF   (2 ^ 32 -1)
+  andrat(&pint, rat_dword(), radix, precision);      // & 0xFFFFFFFF   (2 ^ 32 -1)
   uint32_t lo = rattoUi32(pint, radix, precision); // wont throw exception because already hi-dword chopped off
 
   DUPRAT(pint, prat); // previous pint will get freed by this as well
   PRAT prat32 = i32torat(32);
   rshrat(&pint, prat32, radix, precision);
   intrat(&pint, radix, precision);
-  andrat(&pint, rat_dword, radix, precision); // & 0xFFFFFFFF   (2 ^ 32 -1)
+  andrat(&pint, rat_dword(), radix, precision); // & 0xFFFFFFFF   (2 ^ 32 -1)
   uint32_t hi = rattoUi32(pint, radix, precision);
 
   destroyrat(prat32);
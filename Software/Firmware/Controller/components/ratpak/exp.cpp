@@ -67,10 +67,11 @@ void exprat(PRAT *px, uint32_t radix, int32_t precision)
   if (rat_gt(*px, rat_max_exp, precision) || rat_lt(*px, rat_min_exp, precision))
   {
     // Don't attempt exp of anything large.
-    throw(CALC_E_DOMAIN);
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return;
   }
 
-  DUPRAT(pwr, rat_exp);
+  DUPRAT(pwr, rat_exp());
   DUPRAT(pint, *px);
 
   intrat(&pint, radix, precision);
@@ -160,7 +161,8 @@ void _lograt(PRAT *px, int32_t precision)
   // Check for someone taking the log of zero or a negative number.
   if (rat_le(*px, rat_zero, precision))
   {
-    throw(CALC_E_DOMAIN);
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return;
   }
 
   // Get number > 1, for scaling
@@ -174,12 +176,18 @@ void _lograt(PRAT *px, int32_t precision)
 
   // Scale the number within BASEX factor of 1, for the large scale.
   // log(x*2^(BASEXPWR*k)) = BASEXPWR*k*log(2)+log(x)
+  // log(x*10^(BASEXDIGITS*k)) = BASEXDIGITS*k*log(10)+log(x)
   if (LOGRAT2(*px) > 1)
   {
     const int32_t intpwr = LOGRAT2(*px) - 1;
     (*px)->pq->exp += intpwr;
+#if RATPAK_DECIMAL_BASE
+    pwr = i32torat(intpwr * BASEXDIGITS);
+    mulrat(&pwr, ln_ten(), precision);
+#else
     pwr = i32torat(intpwr * BASEXPWR);
-    mulrat(&pwr, ln_two, precision);
+    mulrat(&pwr, ln_two(), precision);
+#endif
     // ln(x+e)-ln(x) looks close to e when x is close to one using some
     // expansions.  This means we can trim past precision digits+1.
     TRIMTOP(*px, precision);
@@ -191,9 +199,9 @@ void _lograt(PRAT *px, int32_t precision)
 
   DUPRAT(offset, rat_zero);
   // Scale the number between 1 and e_to_one_half, for the small scale.
-  while (rat_gt(*px, e_to_one_half, precision))
+  while (rat_gt(*px, e_to_one_half(), precision))
   {
-    divrat(px, e_to_one_half, precision);
+    divrat(px, e_to_one_half(), precision);
     _addrat(&offset, rat_one, precision);
   }
 
@@ -236,7 +244,7 @@ void log10rat(PRAT *px, int32_t precision)
 
 {
   lograt(px, precision);
-  divrat(px, ln_ten, precision);
+  divrat(px, ln_ten(), precision);
 }
 
 //
@@ -289,6 +297,7 @@ void powrat(PRAT *px, PRAT y, uint32_t radix, int32_t precision)
     return;
   }
 
+#if RATPAK_EXCEPTIONS
   try
   {
     powratNumeratorDenominator(px, y, radix, precision);
@@ -300,6 +309,19 @@ void powrat(PRAT *px, PRAT y, uint32_t radix, int32_t precision)
     // passing in the original y
     powratcomp(px, y, radix, precision);
   }
+#else
+  // An error raised before has to stay, only errors of the
+  // numerator/denominator method select the fallback.
+  if (!RATPAK_FAILED())
+  {
+    powratNumeratorDenominator(px, y, radix, precision);
+    if (RATPAK_FAILED())
+    {
+      ClearRatError();
+      powratcomp(px, y, radix, precision);
+    }
+  }
+#endif
 }
 
 void powratNumeratorDenominator(PRAT *px, PRAT y, uint32_t radix, int32_t precision)
@@ -329,16 +351,17 @@ void powratNumeratorDenominator(PRAT *px, PRAT y, uint32_t radix, int32_t precis
 
   if (!rat_equ(yNumerator, rat_one, precision))
   {
-    try
+    RATPAK_TRY
     {
       powratcomp(&pxPow, yNumerator, radix, precision);
     }
-    catch (uint32_t error)
+    RATPAK_CATCH(error)
     {
       destroyrat(pxPow);
       destroyrat(yNumerator);
       destroyrat(yDenominator);
-      throw(error);
+      RATPAK_THROW(error);
+      return;
     }
   }
 
@@ -356,18 +379,19 @@ void powratNumeratorDenominator(PRAT *px, PRAT y, uint32_t radix, int32_t precis
     // ##################################
     PRAT originalResult = nullptr;
     DUPRAT(originalResult, pxPow);
-    try
+    RATPAK_TRY
     {
       powratcomp(&originalResult, oneoveryDenom, radix, precision);
     }
-    catch (uint32_t error)
+    RATPAK_CATCH(error)
     {
       destroyrat(originalResult);
       destroyrat(oneoveryDenom);
       destroyrat(pxPow);
       destroyrat(yNumerator);
       destroyrat(yDenominator);
-      throw(error);
+      RATPAK_THROW(error);
+      return;
     }
     // ##################################
     // Round the originalResult to roundedResult
@@ -389,11 +413,11 @@ void powratNumeratorDenominator(PRAT *px, PRAT y, uint32_t radix, int32_t precis
     // ##################################
     PRAT roundedPower = nullptr;
     DUPRAT(roundedPower, roundedResult);
-    try
+    RATPAK_TRY
     {
       powratcomp(&roundedPower, yDenominator, radix, precision);
     }
-    catch (uint32_t error)
+    RATPAK_CATCH(error)
     {
       destroyrat(roundedPower);
       destroyrat(roundedResult);
@@ -402,7 +426,8 @@ void powratNumeratorDenominator(PRAT *px, PRAT y, uint32_t radix, int32_t precis
       destroyrat(pxPow);
       destroyrat(yNumerator);
       destroyrat(yDenominator);
-      throw(error);
+      RATPAK_THROW(error);
+      return;
     }
     // ##################################
     // if roundedPower == px,
@@ -458,7 +483,8 @@ void powratcomp(PRAT *px, PRAT y, uint32_t radix, int32_t precision)
     // *px is zero.
     if (rat_lt(y, rat_zero, precision))
     {
-      throw(CALC_E_DOMAIN);
+      RATPAK_THROW(CALC_E_DOMAIN);
+      return;
     }
     else if (zerrat(y))
     {
@@ -493,16 +519,17 @@ void powratcomp(PRAT *px, PRAT y, uint32_t radix, int32_t precision)
         DUPRAT(iy, y);
         _subrat(&iy, podd, precision);
         int32_t inty;
-        try
+        RATPAK_TRY
         {
           inty = rattoi32(iy, radix, precision);
         }
-        catch (uint32_t error)
+        RATPAK_CATCH(error)
         {
           destroyrat(iy);
           destroyrat(pxint);
           destroyrat(podd);
-          throw(error);
+          RATPAK_THROW(error);
+          return;
         }
         PRAT plnx = nullptr;
         DUPRAT(plnx, *px);
@@ -515,7 +542,8 @@ void powratcomp(PRAT *px, PRAT y, uint32_t radix, int32_t precision)
           destroyrat(iy);
           destroyrat(pxint);
           destroyrat(podd);
-          throw(CALC_E_DOMAIN);
+          RATPAK_THROW(CALC_E_DOMAIN);
+          return;
         }
         destroyrat(plnx);
         ratpowi32(px, inty, precision);
@@ -567,7 +595,8 @@ void powratcomp(PRAT *px, PRAT y, uint32_t radix, int32_t precision)
           {
             destroyrat(podd);
             destroyrat(pxint);
-            throw(CALC_E_DOMAIN);
+            RATPAK_THROW(CALC_E_DOMAIN);
+            return;
           }
         }
         else
@@ -93,18 +93,19 @@ void _gamma(PRAT *pn, uint32_t radix, int32_t precision)
   divrat(&one_pt_five, rat_two, precision);
   _addrat(&tmp, one_pt_five, precision);
   DUPRAT(term, a);
-  try
+  RATPAK_TRY
   {
     powratcomp(&term, tmp, radix, precision);
   }
-  catch (uint32_t error)
+  RATPAK_CATCH(error)
   {
     destroyrat(ratprec);
     destroyrat(a);
     destroyrat(one_pt_five);
     destroyrat(tmp);
     destroyrat(term);
-    throw(error);
+    RATPAK_THROW(error);
+    return;
   }
   DUPRAT(tmp, a);
   exprat(&tmp, radix, precision);
@@ -121,11 +122,11 @@ void _gamma(PRAT *pn, uint32_t radix, int32_t precision)
   count = i32tonum(0L, BASEX);
 
   DUPRAT(mpy, a);
-  try
+  RATPAK_TRY
   {
     powratcomp(&mpy, *pn, radix, precision);
   }
-  catch (uint32_t error)
+  RATPAK_CATCH(error)
   {
     destroyrat(ratprec);
     destroyrat(a);
@@ -136,7 +137,8 @@ void _gamma(PRAT *pn, uint32_t radix, int32_t precision)
     destroyrat(factorial);
     destroynum(count);
     destroyrat(mpy);
-    throw(error);
+    RATPAK_THROW(error);
+    return;
   }
   // a2=a^2
   DUPRAT(a2, a);
@@ -153,11 +155,11 @@ void _gamma(PRAT *pn, uint32_t radix, int32_t precision)
 
   DUPRAT(err, ratRadix);
   NEGATE(ratprec);
-  try
+  RATPAK_TRY
   {
     powratcomp(&err, ratprec, radix, precision);
   }
-  catch (uint32_t error)
+  RATPAK_CATCH(error)
   {
     destroyrat(ratprec);
     destroyrat(a);
@@ -171,7 +173,8 @@ void _gamma(PRAT *pn, uint32_t radix, int32_t precision)
     destroyrat(a2);
     destroyrat(sum);
     destroyrat(err);   
-    throw(error);
+    RATPAK_THROW(error);
+    return;
   }
   divrat(&err, ratRadix, precision);
 
@@ -179,7 +182,7 @@ void _gamma(PRAT *pn, uint32_t radix, int32_t precision)
   DUPRAT(term, rat_two);
 
   // Loop until precision is reached, or asked to halt.
-  while (!zerrat(term) && rat_gt(term, err, precision))
+  while (!zerrat(term) && rat_gt(term, err, precision) && !RATPAK_FAILED())
   {
     _addrat(pn, rat_two, precision);
 
@@ -242,7 +245,8 @@ void factrat(PRAT *px, uint32_t radix, int32_t precision)
   if (rat_gt(*px, rat_max_fact, precision) || rat_lt(*px, rat_min_fact, precision))
   {
     // Don't attempt factorial of anything too large or small.
-    throw CALC_E_OVERFLOW;
+    RATPAK_THROW(CALC_E_OVERFLOW);
+    return;
   }
 
   DUPRAT(fact, rat_one);
@@ -259,9 +263,10 @@ void factrat(PRAT *px, uint32_t radix, int32_t precision)
     destroyrat(fact);
     destroyrat(frac);
     destroyrat(neg_rat_one);
-    throw CALC_E_DOMAIN;
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return;
   }
-  while (rat_gt(*px, rat_zero, precision) && (LOGRATRADIX(*px) > -precision))
+  while (rat_gt(*px, rat_zero, precision) && (LOGRATRADIX(*px) > -precision) && !RATPAK_FAILED())
   {
     mulrat(&fact, *px, precision);
     _subrat(px, rat_one, precision);
@@ -274,12 +279,21 @@ void factrat(PRAT *px, uint32_t radix, int32_t precision)
     intrat(&fact, radix, precision);
   }
 
-  while (rat_lt(*px, neg_rat_one, precision))
+  while (rat_lt(*px, neg_rat_one, precision) && !RATPAK_FAILED())
   {
     _addrat(px, rat_one, precision);
     divrat(&fact, *px, precision);
   }
 
+  if (RATPAK_FAILED())
+  {
+    // Cancelled, skip the gamma function.
+    destroyrat(fact);
+    destroyrat(frac);
+    destroyrat(neg_rat_one);
+    return;
+  }
+
   if (rat_neq(*px, rat_zero, precision))
   {
     _addrat(px, rat_one, precision);
@@ -24,11 +24,11 @@ void ascalerat(PRAT *pa, AngleType angletype, int32_t precision)
 	case AngleType::Radians:
 		break;
 	case AngleType::Degrees:
-		divrat(pa, two_pi, precision);
+		divrat(pa, two_pi(), precision);
 		mulrat(pa, rat_360, precision);
 		break;
 	case AngleType::Gradians:
-		divrat(pa, two_pi, precision);
+		divrat(pa, two_pi(), precision);
 		mulrat(pa, rat_400, precision);
 		break;
 	}
@@ -100,7 +100,7 @@ void asinrat(PRAT *px, uint32_t radix, int32_t precision)
 	if (rat_le(phack, rat_smallest, precision) && rat_ge(phack, rat_negsmallest, precision))
 	{
 		destroyrat(phack);
-		DUPRAT(*px, pi_over_two);
+		DUPRAT(*px, pi_over_two());
 	}
 	else
 	{
@@ -112,7 +112,8 @@ void asinrat(PRAT *px, uint32_t radix, int32_t precision)
 				_subrat(px, rat_one, precision);
 				if (rat_gt(*px, rat_smallest, precision))
 				{
-					throw(CALC_E_DOMAIN);
+					RATPAK_THROW(CALC_E_DOMAIN);
+					return;
 				}
 				else
 				{
@@ -126,7 +127,7 @@ void asinrat(PRAT *px, uint32_t radix, int32_t precision)
 			rootrat(px, rat_two, radix, precision);
 			_asinrat(px, precision);
 			(*px)->pp->sign *= -1;
-			_addrat(px, pi_over_two, precision);
+			_addrat(px, pi_over_two(), precision);
 			destroyrat(pret);
 		}
 		else
@@ -202,7 +203,7 @@ void acosrat(PRAT *px, uint32_t radix, int32_t precision)
 	{
 		if (sgn == -1)
 		{
-			DUPRAT(*px, pi);
+			DUPRAT(*px, pi());
 		}
 		else
 		{
@@ -214,7 +215,7 @@ void acosrat(PRAT *px, uint32_t radix, int32_t precision)
 		(*px)->pp->sign = sgn;
 		asinrat(px, radix, precision);
 		(*px)->pp->sign *= -1;
-		_addrat(px, pi_over_two, precision);
+		_addrat(px, pi_over_two(), precision);
 	}
 }
 
@@ -296,7 +297,7 @@ void atanrat(PRAT *px, uint32_t radix, int32_t precision)
 			_atanrat(&tmpx, precision);
 			tmpx->pp->sign = sgn;
 			tmpx->pq->sign = 1;
-			DUPRAT(*px, pi_over_two);
+			DUPRAT(*px, pi_over_two());
 			_subrat(px, tmpx, precision);
 			destroyrat(tmpx);
 		}
@@ -320,8 +321,8 @@ void atanrat(PRAT *px, uint32_t radix, int32_t precision)
 		(*px)->pq->sign = 1;
 		_atanrat(px, precision);
 	}
-	if (rat_gt(*px, pi_over_two, precision))
+	if (rat_gt(*px, pi_over_two(), precision))
 	{
-		_subrat(px, pi, precision);
+		_subrat(px, pi(), precision);
 	}
 }
@@ -106,7 +106,8 @@ void acoshrat(PRAT *px, uint32_t radix, int32_t precision)
 {
   if (rat_lt(*px, rat_one, precision))
   {
-    throw CALC_E_DOMAIN;
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return;
   }
   else
   {
@@ -29,7 +29,8 @@ void lshrat(PRAT *pa, PRAT b, uint32_t radix, int32_t precision)
     if (rat_gt(b, rat_max_exp, precision))
     {
       // Don't attempt lsh of anything big
-      throw(CALC_E_DOMAIN);
+      RATPAK_THROW(CALC_E_DOMAIN);
+      return;
     }
     const int32_t intb = rattoi32(b, radix, precision);
     DUPRAT(pwr, rat_two);
@@ -51,7 +52,8 @@ void rshrat(PRAT *pa, PRAT b, uint32_t radix, int32_t precision)
     if (rat_lt(b, rat_min_exp, precision))
     {
       // Don't attempt rsh of anything big and negative.
-      throw(CALC_E_DOMAIN);
+      RATPAK_THROW(CALC_E_DOMAIN);
+      return;
     }
     const int32_t intb = rattoi32(b, radix, precision);
     DUPRAT(pwr, rat_two);
@@ -109,7 +111,19 @@ void boolrat(PRAT *pa, PRAT b, int func, uint32_t radix, int32_t precision)
   DUPRAT(tmp, b);
   intrat(&tmp, radix, precision);
 
+#if RATPAK_DECIMAL_BASE
+  // the logicals work on bits, go through base 2 and back
+  int32_t cbits = (max((*pa)->pp->cdigit + (*pa)->pp->exp, tmp->pp->cdigit + tmp->pp->exp) + 1) * 32;
+  PNUMBER pnuma = nRadixxtonum((*pa)->pp, 2, cbits);
+  PNUMBER pnumb = nRadixxtonum(tmp->pp, 2, cbits);
+  boolnum(&pnuma, pnumb, func);
+  destroynum((*pa)->pp);
+  (*pa)->pp = numtonRadixx(pnuma, 2);
+  destroynum(pnuma);
+  destroynum(pnumb);
+#else
   boolnum(&((*pa)->pp), tmp->pp, func);
+#endif
   destroyrat(tmp);
 }
 
@@ -194,7 +208,8 @@ void remrat(PRAT *pa, PRAT b)
 {
   if (zerrat(b))
   {
-    throw CALC_E_INDEFINITE;
+    RATPAK_THROW(CALC_E_INDEFINITE);
+    return;
   }
 
   PRAT tmp = nullptr;
@@ -213,14 +228,17 @@ void remrat(PRAT *pa, PRAT b)
 
 //-----------------------------------------------------------------------------
 //
-//    FUNCTION: modrat
+//    FUNCTION: modrat, modrat_into
 //
-//    ARGUMENTS: pointer to a rational a second rational.
+//    ARGUMENTS: pointer to a rational a second rational, modrat_into takes
+//               a pointer to the result and two rationals.
 //
 //    RETURN: None, changes pointer.
 //
 //    DESCRIPTION: Calculate the remainder of *pa / b, with the sign of the result
 //                 either zero or has the same sign as the divisor.
+//                 modrat_into sets *pc to the remainder of a / b, a and b
+//                 keep their values and the old *pc may be a or b.
 //    NOTE: When *pa or b are negative, the result won't be the same as
 //          the C/C++ operator %, use remrat if it's the behavior you expect.
 //
@@ -228,29 +246,41 @@ void remrat(PRAT *pa, PRAT b)
 
 void modrat(PRAT *pa, PRAT b)
 {
+  modrat_into(pa, *pa, b);
+}
+
+void modrat_into(PRAT *pc, PRAT a, PRAT b)
+{
+  PRAT c = nullptr;
+  createrat(c);
+
   // contrary to remrat(X, 0) returning 0, modrat(X, 0) must return X
   if (zerrat(b))
   {
-    return;
+    DUPNUM(c->pp, a->pp);
+    DUPNUM(c->pq, a->pq);
   }
+  else
+  {
+    PNUMBER tmp = nullptr;
 
-  PRAT tmp = nullptr;
-  DUPRAT(tmp, b);
+    auto needAdjust = (SIGN(a) == -1 ? (SIGN(b) == 1) : (SIGN(b) == -1));
 
-  auto needAdjust = (SIGN(*pa) == -1 ? (SIGN(b) == 1) : (SIGN(b) == -1));
+    mulnumx_into(&(c->pp), a->pp, b->pq);
+    mulnumx_into(&tmp, b->pp, a->pq);
+    remnum(&(c->pp), tmp, BASEX);
+    mulnumx_into(&(c->pq), a->pq, b->pq);
+    destroynum(tmp);
 
-  mulnumx(&((*pa)->pp), tmp->pq);
-  mulnumx(&(tmp->pp), (*pa)->pq);
-  remnum(&((*pa)->pp), tmp->pp, BASEX);
-  mulnumx(&((*pa)->pq), tmp->pq);
+    if (needAdjust && !zerrat(c))
+    {
+      _addrat(&c, b, BASEX);
+    }
 
-  if (needAdjust && !zerrat(*pa))
-  {
-    _addrat(pa, b, BASEX);
+    // Get c back in the integer over integer form.
+    RENORMALIZE(c);
   }
 
-  // Get *pa back in the integer over integer form.
-  RENORMALIZE(*pa);
-
-  destroyrat(tmp);
+  destroyrat(*pc);
+  *pc = c;
 }
@@ -41,7 +41,7 @@ using namespace std;
 //
 //----------------------------------------------------------------------------
 
-void _addnum(PNUMBER *pa, PNUMBER b, uint32_t radix);
+PNUMBER _addnum(PNUMBER a, PNUMBER b, uint32_t radix);
 
 void addnum(PNUMBER *pa, PNUMBER b, uint32_t radix)
 
@@ -50,7 +50,9 @@ void addnum(PNUMBER *pa, PNUMBER b, uint32_t radix)
   { // If b is zero we are done.
     if ((*pa)->cdigit > 1 || (*pa)->mant[0] != 0)
     { // pa and b are both nonzero.
-      _addnum(pa, b, radix);
+      PNUMBER c = _addnum(*pa, b, radix);
+      destroynum(*pa);
+      *pa = c;
     }
     else
     { // if pa is zero and b isn't just copy b.
@@ -59,11 +61,43 @@ void addnum(PNUMBER *pa, PNUMBER b, uint32_t radix)
   }
 }
 
-void _addnum(PNUMBER *pa, PNUMBER b, uint32_t radix)
+//----------------------------------------------------------------------------
+//
+//    FUNCTION: addnum_into
+//
+//    ARGUMENTS: pointer to the result, two numbers and the radix.
+//
+//    RETURN: None, changes first pointer.
+//
+//    DESCRIPTION: Does the number equivalent of *pc = a + b without
+//    touching a and b. The old *pc is destroyed, it may be a or b.
+//
+//----------------------------------------------------------------------------
+
+void addnum_into(PNUMBER *pc, PNUMBER a, PNUMBER b, uint32_t radix)
+
+{
+  PNUMBER c = nullptr;
+  if (b->cdigit == 1 && b->mant[0] == 0)
+  {
+    DUPNUM(c, a);
+  }
+  else if (a->cdigit == 1 && a->mant[0] == 0)
+  {
+    DUPNUM(c, b);
+  }
+  else
+  {
+    c = _addnum(a, b, radix);
+  }
+  destroynum(*pc);
+  *pc = c;
+}
+
+PNUMBER _addnum(PNUMBER a, PNUMBER b, uint32_t radix)
 
 {
   PNUMBER c = nullptr; // c will contain the result.
-  PNUMBER a = nullptr; // a is the dereferenced number pointer from *pa
   MANTTYPE *pcha;      // pcha is a pointer to the mantissa of a.
   MANTTYPE *pchb;      // pchb is a pointer to the mantissa of b.
   MANTTYPE *pchc;      // pchc is a pointer to the mantissa of c.
@@ -75,8 +109,6 @@ void _addnum(PNUMBER *pa, PNUMBER b, uint32_t radix)
   int32_t fcompla = 0; // fcompla is a flag to signal a is negative.
   int32_t fcomplb = 0; // fcomplb is a flag to signal b is negative.
 
-  a = *pa;
-
   // Calculate the overlap of the numbers after alignment, this includes
   // necessary padding 0's
   cdigits = max(a->cdigit + a->exp, b->cdigit + b->exp) - min(a->exp, b->exp);
@@ -164,8 +196,7 @@ void _addnum(PNUMBER *pa, PNUMBER b, uint32_t radix)
   {
     c->cdigit--;
   }
-  destroynum(*pa);
-  *pa = c;
+  return (c);
 }
 
 //----------------------------------------------------------------------------
@@ -273,6 +304,7 @@ void _mulnum(PNUMBER *pa, PNUMBER b, uint32_t radix)
       pchb++;
       pchc++;
     }
+    RATPAK_POLL(b->cdigit);
   }
 
   // prevent different kinds of zeros, by stripping leading duplicate zeros.
@@ -315,9 +347,11 @@ void remnum(PNUMBER *pa, PNUMBER b, uint32_t radix)
     {
       // Start off close to the right answer for subtraction.
       tmp->exp = (*pa)->cdigit + (*pa)->exp - tmp->cdigit;
-      if (MSD(*pa) <= MSD(tmp))
+      if ((MSD(*pa) <= MSD(tmp)) && (tmp->exp > b->exp))
       {
-        // Don't take the chance that the numbers are equal.
+        // Don't take the chance that the numbers are equal. Never go below
+        // b, doubling only gives multiples of b from there if BASEX is a
+        // power of two.
         tmp->exp--;
       }
     }
@@ -441,6 +475,7 @@ void _divnum(PNUMBER *pa, PNUMBER b, uint32_t radix, int32_t precision)
     }
     rem->exp++;
     *ptrc-- = (MANTTYPE)digit;
+    RATPAK_POLL(b->cdigit);
   }
   cdigits--;
 
@@ -144,7 +144,9 @@ void divrat(PRAT *pa, PRAT b, int32_t precision)
     if (zernum((*pa)->pq))
     {
       // raise an exception if the bottom is 0.
-      throw(CALC_E_DIVIDEBYZERO);
+      RATPAK_THROW(CALC_E_DIVIDEBYZERO);
+      DUPNUM((*pa)->pq, num_one); // keep *pa a valid number
+      return;
     }
     trimit(pa, precision);
   }
@@ -155,7 +157,8 @@ void divrat(PRAT *pa, PRAT b, int32_t precision)
     {
       // If bottom is zero
       // 0 / 0 is indefinite, raise an exception.
-      throw(CALC_E_INDEFINITE);
+      RATPAK_THROW(CALC_E_INDEFINITE);
+      return;
     }
     else
     {
@@ -188,13 +191,7 @@ void divrat(PRAT *pa, PRAT b, int32_t precision)
 void subrat(PRAT* pa, PRAT b, int32_t precision)
 
 {
-    PRAT a = nullptr;
-    DUPRAT(a, *pa);
-
-    _subrat(pa, b, precision);
-
-    _snaprat(pa, a, b, precision);
-    destroyrat(a);
+  subrat_into(pa, *pa, b, precision);
 }
 
 void _subrat(PRAT *pa, PRAT b, int32_t precision)
@@ -223,13 +220,7 @@ void _subrat(PRAT *pa, PRAT b, int32_t precision)
 
 void addrat(PRAT* pa, PRAT b, int32_t precision)
 {
-    PRAT a = nullptr;
-    DUPRAT(a, *pa);
-
-    _addrat(pa, b, precision);
-
-    _snaprat(pa, a, b, precision);
-    destroyrat(a);
+  addrat_into(pa, *pa, b, precision);
 }
 
 void _addrat(PRAT *pa, PRAT b, int32_t precision)
@@ -271,6 +262,194 @@ void _addrat(PRAT *pa, PRAT b, int32_t precision)
 #endif
 }
 
+//-----------------------------------------------------------------------------
+//
+//    FUNCTION: addrat_into, subrat_into, _addrat_into
+//
+//    ARGUMENTS: pointer to the result and two rationals.
+//
+//    RETURN: None, changes first pointer.
+//
+//    DESCRIPTION: Does the rational equivalent of *pc = a + b and
+//    *pc = a - b. a and b keep their values, the old *pc is destroyed and
+//    may be a or b. Nothing is copied but the denominator when both
+//    denominators match. Snaps to zero like addrat and subrat.
+//
+//-----------------------------------------------------------------------------
+
+static void _addrat_into(PRAT *pc, PRAT a, PRAT b, int32_t bsign, int32_t precision)
+
+{
+  PRAT c = nullptr;
+  createrat(c);
+
+  if (equnum(a->pq, b->pq))
+  {
+    // Very special case, q's match, normalizing the signs does not change
+    // the values of a and b.
+    a->pp->sign *= a->pq->sign;
+    a->pq->sign = 1;
+    b->pp->sign *= b->pq->sign;
+    b->pq->sign = 1;
+    if (a == b)
+    {
+      // Same rational, a - a is exactly zero.
+      if (bsign == -1)
+      {
+        DUPNUM(c->pp, rat_zero->pp);
+      }
+      else
+      {
+        addnum_into(&(c->pp), a->pp, a->pp, BASEX);
+      }
+    }
+    else
+    {
+      b->pp->sign *= bsign;
+      addnum_into(&(c->pp), a->pp, b->pp, BASEX);
+      b->pp->sign *= bsign;
+    }
+    DUPNUM(c->pq, a->pq);
+  }
+  else
+  {
+    // Usual case q's aren't the same.
+    PNUMBER tmp = nullptr;
+    mulnumx_into(&(c->pq), a->pq, b->pq);
+    mulnumx_into(&(c->pp), a->pp, b->pq);
+    mulnumx_into(&tmp, a->pq, b->pp);
+    tmp->sign *= bsign;
+    addnum(&(c->pp), tmp, BASEX);
+    destroynum(tmp);
+    trimit(&c, precision);
+
+    // Get rid of negative zeros here.
+    c->pp->sign *= c->pq->sign;
+    c->pq->sign = 1;
+  }
+
+  destroyrat(*pc);
+  *pc = c;
+}
+
+void addrat_into(PRAT *pc, PRAT a, PRAT b, int32_t precision)
+
+{
+  PRAT c = nullptr;
+  _addrat_into(&c, a, b, 1, precision);
+  _snaprat(&c, a, b, precision);
+  destroyrat(*pc);
+  *pc = c;
+}
+
+void subrat_into(PRAT *pc, PRAT a, PRAT b, int32_t precision)
+
+{
+  PRAT c = nullptr;
+  _addrat_into(&c, a, b, -1, precision);
+  _snaprat(&c, a, b, precision);
+  destroyrat(*pc);
+  *pc = c;
+}
+
+//-----------------------------------------------------------------------------
+//
+//    FUNCTION: mulrat_into, divrat_into
+//
+//    ARGUMENTS: pointer to the result and two rationals.
+//
+//    RETURN: None, changes first pointer.
+//
+//    DESCRIPTION: Does the rational equivalent of *pc = a * b and
+//    *pc = a / b. a and b keep their values, the old *pc is destroyed and
+//    may be a or b. The products are built straight into the result.
+//
+//-----------------------------------------------------------------------------
+
+void mulrat_into(PRAT *pc, PRAT a, PRAT b, int32_t precision)
+
+{
+  PRAT c = nullptr;
+  createrat(c);
+  if (!zernum(a->pp))
+  {
+    mulnumx_into(&(c->pp), a->pp, b->pp);
+    mulnumx_into(&(c->pq), a->pq, b->pq);
+    trimit(&c, precision);
+  }
+  else
+  {
+    // If it is zero, blast a one in the denominator.
+    DUPNUM(c->pp, a->pp);
+    DUPNUM(c->pq, num_one);
+  }
+  destroyrat(*pc);
+  *pc = c;
+}
+
+void divrat_into(PRAT *pc, PRAT a, PRAT b, int32_t precision)
+
+{
+  PRAT c = nullptr;
+  createrat(c);
+  if (!zernum(a->pp))
+  {
+    mulnumx_into(&(c->pp), a->pp, b->pq);
+    mulnumx_into(&(c->pq), a->pq, b->pp);
+    if (zernum(c->pq))
+    {
+      // Keep *pc a valid number and raise an exception.
+      DUPNUM(c->pq, num_one);
+      destroyrat(*pc);
+      *pc = c;
+      RATPAK_THROW(CALC_E_DIVIDEBYZERO);
+      return;
+    }
+    trimit(&c, precision);
+  }
+  else
+  {
+    // Top is zero, 0/x make a unique 0.
+    DUPNUM(c->pp, a->pp);
+    DUPNUM(c->pq, num_one);
+    if (zerrat(b))
+    {
+      // 0 / 0 is indefinite, raise an exception.
+      destroyrat(*pc);
+      *pc = c;
+      RATPAK_THROW(CALC_E_INDEFINITE);
+      return;
+    }
+  }
+  destroyrat(*pc);
+  *pc = c;
+}
+
+//-----------------------------------------------------------------------------
+//
+//    FUNCTION: subrat_rev, divrat_rev
+//
+//    ARGUMENTS: pointer to a rational a second rational.
+//
+//    RETURN: None, changes first pointer.
+//
+//    DESCRIPTION: Does the rational equivalent of *pa = b - *pa and
+//    *pa = b / *pa, the reversed operands of subrat and divrat.
+//
+//-----------------------------------------------------------------------------
+
+void subrat_rev(PRAT *pa, PRAT b, int32_t precision)
+
+{
+  subrat_into(pa, b, *pa, precision);
+}
+
+void divrat_rev(PRAT *pa, PRAT b, int32_t precision)
+
+{
+  divrat_into(pa, b, *pa, precision);
+}
+
 //-----------------------------------------------------------------------------
 //
 //  FUNCTION: rootrat
@@ -291,14 +470,15 @@ void rootrat(PRAT *py, PRAT n, uint32_t radix, int32_t precision)
   DUPRAT(oneovern, rat_one);
   divrat(&oneovern, n, precision);
 
-  try
+  RATPAK_TRY
   {
     powrat(py, oneovern, radix, precision);
   }
-  catch (uint32_t error)
+  RATPAK_CATCH(error)
   {
     destroyrat(oneovern);
-    throw(error);
+    RATPAK_THROW(error);
+    return;
   }
   destroyrat(oneovern);
 }
@@ -353,44 +533,38 @@ bool zerrat(PRAT a)
 
 void _snaprat(PRAT* pr, PRAT a, PRAT b, int32_t precision)
 {
-    PRAT threshold = nullptr;
-    if (!b)
+    // The magnitudes are compared with the signs set aside for a moment
+    // instead of on copies, a and b may be the same rational.
+    PRAT big = a;
+    if (b)
     {
-        DUPRAT(threshold, a);
-        ABSRAT(threshold);
-    }
-    else
-    {
-        PRAT absA = nullptr;
-        PRAT absB = nullptr;
-        DUPRAT(absA, a);
-        DUPRAT(absB, b);
-        ABSRAT(absA);
-        ABSRAT(absB);
-
-        if (rat_lt(absA, absB, precision))
+        int32_t signs[4] = {a->pp->sign, a->pq->sign, b->pp->sign, b->pq->sign};
+        ABSRAT(a);
+        ABSRAT(b);
+        if (rat_lt(a, b, precision))
         {
-            DUPRAT(threshold, absB);
+            big = b;
         }
-        else
-        {
-            DUPRAT(threshold, absA);
-        }
-        destroyrat(absA);
-        destroyrat(absB);
+        b->pp->sign = signs[2];
+        b->pq->sign = signs[3];
+        a->pp->sign = signs[0];
+        a->pq->sign = signs[1];
     }
-    mulrat(&threshold, rat_smallest, precision);
-
-    PRAT absR = nullptr;
-    DUPRAT(absR, *pr);
-    ABSRAT(absR);
+    PRAT threshold = nullptr;
+    mulrat_into(&threshold, big, rat_smallest, precision);
+    ABSRAT(threshold);
+
+    int32_t rsignp = (*pr)->pp->sign;
+    int32_t rsignq = (*pr)->pq->sign;
+    ABSRAT(*pr);
+    bool snap = rat_lt(*pr, threshold, precision);
+    (*pr)->pp->sign = rsignp;
+    (*pr)->pq->sign = rsignq;
+    destroyrat(threshold);
 
     // if absResult < threshold => snap to zero
-    if (rat_lt(absR, threshold, precision))
+    if (snap)
     {
         DUPRAT(*pr, rat_zero);
     }
-
-    destroyrat(absR);
-    destroyrat(threshold);
 }
\ No newline at end of file
@@ -21,6 +21,8 @@
 #include <string>
 #include "CalcErr.h"
 #include <cstring> // for memmove
+#include <cstddef> // for size_t
+#include <cstdlib> // for abort
 
 #define S_OK 0x0
 
@@ -28,10 +30,42 @@
 #define FAILED(hr) (((ResultCode)(hr)) < 0)
 #define SCODE_CODE(sc) ((sc) & 0xFFFF)
 
+// Internal radix. 0 selects 2^31, which keeps the arithmetic cheap, 1 selects
+// 10^9, which turns conversions from and to decimal into digit slicing.
+// Bitwise operations need the binary radix.
+#ifndef RATPAK_DECIMAL_BASE
+#define RATPAK_DECIMAL_BASE 0
+#endif
+
+#if RATPAK_DECIMAL_BASE
+static constexpr uint32_t BASEXDIGITS = 9L;     // Internal log10(BASEX)
+static constexpr uint32_t BASEX = 1000000000L;  // Internal radix used in calculations
+#else
 static constexpr uint32_t BASEXPWR = 31L;     // Internal log2(BASEX)
 static constexpr uint32_t BASEX = 0x80000000; // Internal radix used in calculations, hope to raise
                                               // this to 2^32 after solving scaling problems with
                                               // overflow detection esp. in mul
+#endif
+
+// Error reporting. With exceptions ratpak throws its CALC_E_* codes. Built
+// with -fno-exceptions it records the first error in the current context
+// instead, the failing function returns with a valid value and the callers
+// run to completion. Callers clear the error before a calculation and check
+// it afterwards, see ClearRatError and GetRatError.
+#ifndef RATPAK_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define RATPAK_EXCEPTIONS 1
+#else
+#define RATPAK_EXCEPTIONS 0
+#endif
+#endif
+
+// Allocation accounting. 1 counts the allocations, frees and bytes of every
+// context, each block carries its size in a small header for that. 0 removes
+// the header and the counters stay zero.
+#ifndef RATPAK_ALLOC_STATS
+#define RATPAK_ALLOC_STATS 1
+#endif
 
 typedef uint32_t MANTTYPE;
 typedef uint64_t TWO_MANTTYPE;
@@ -79,58 +113,199 @@ typedef struct _rat
 {
   PNUMBER pp;
   PNUMBER pq;
+  uint32_t cshare; // Number of additional owners of this rational, 0 if it
+                   // has a single owner. Maintained by the C++ Rational
+                   // wrapper, ratpak itself never shares a rational.
 } RAT, *PRAT;
 
 static constexpr uint32_t MAX_LONG_SIZE = 33; // Base 2 requires 32 'digits'
 
 //-----------------------------------------------------------------------------
 //
-// List of useful constants for evaluation, note this list needs to be
-// initialized.
+//  RATCONTEXT holds the state of the math package: radix, precision, the
+//  constants and the allocator. Every thread works on its current context
+//  g_ratctx. Threads that never bind a context of their own share the
+//  default context, so single threaded callers can ignore contexts.
 //
 //-----------------------------------------------------------------------------
 
-extern PNUMBER num_one;
-extern PNUMBER num_two;
-extern PNUMBER num_five;
-extern PNUMBER num_six;
-extern PNUMBER num_ten;
-
-extern PRAT ln_ten;
-extern PRAT ln_two;
-extern PRAT rat_zero;
-extern PRAT rat_neg_one;
-extern PRAT rat_one;
-extern PRAT rat_two;
-extern PRAT rat_six;
-extern PRAT rat_half;
-extern PRAT rat_ten;
-extern PRAT pt_eight_five;
-extern PRAT pi;
-extern PRAT pi_over_two;
-extern PRAT two_pi;
-extern PRAT one_pt_five_pi;
-extern PRAT e_to_one_half;
-extern PRAT rat_exp;
-extern PRAT rad_to_deg;
-extern PRAT rad_to_grad;
-extern PRAT rat_qword;
-extern PRAT rat_dword;
-extern PRAT rat_word;
-extern PRAT rat_byte;
-extern PRAT rat_360;
-extern PRAT rat_400;
-extern PRAT rat_180;
-extern PRAT rat_200;
-extern PRAT rat_nRadix;
-extern PRAT rat_smallest;
-extern PRAT rat_negsmallest;
-extern PRAT rat_max_exp;
-extern PRAT rat_min_exp;
-extern PRAT rat_max_fact;
-extern PRAT rat_min_fact;
-extern PRAT rat_max_i32;
-extern PRAT rat_min_i32;
+static constexpr int LAZY_RAT_COUNT = 16;
+
+typedef struct
+{
+  PRAT value;
+  int32_t precision; // precision the value was built for
+  bool touched;      // set once the constant was requested
+} LAZYRAT;
+
+// called while calculating, returns true to cancel the calculation
+typedef bool (*RATPOLL)(void *param);
+
+// allocation counters of a context, see GetRatAllocStats
+typedef struct
+{
+  uint32_t allocs;    // blocks allocated
+  uint32_t frees;     // blocks released
+  uint64_t bytes;     // bytes allocated in total
+  uint32_t liveBytes; // bytes allocated and not yet released
+  uint32_t peakBytes; // highest liveBytes since ResetRatAllocPeak
+} RATALLOCSTATS;
+
+// how trimit bounds the denominator of a result, see SetRatBound
+typedef enum
+{
+  RATBOUND_EXACT, // denominators are only cut together with numerators
+  RATBOUND_TRIM,  // long denominators are cut to precision plus guard digits
+} RATBOUND;
+
+typedef struct _ratcontext
+{
+  uint32_t radix;
+  int32_t precision;
+  int32_t ratio;         // ratio of internal radix to radix, see g_ratio
+  bool ftrueinfinite;    // see g_ftrueinfinite
+  char decimalSeparator; // see SetDecimalSeparator
+
+  void *(*alloc)(size_t size); // returns zeroed memory or nullptr
+  void (*release)(void *p);
+
+  PNUMBER num_one;
+  PNUMBER num_two;
+  PNUMBER num_five;
+  PNUMBER num_six;
+  PNUMBER num_ten;
+
+  PRAT rat_zero;
+  PRAT rat_neg_one;
+  PRAT rat_one;
+  PRAT rat_two;
+  PRAT rat_six;
+  PRAT rat_half;
+  PRAT rat_ten;
+  PRAT pt_eight_five;
+  PRAT rat_360;
+  PRAT rat_400;
+  PRAT rat_180;
+  PRAT rat_200;
+  PRAT rat_nRadix;
+  PRAT rat_smallest;
+  PRAT rat_negsmallest;
+  PRAT rat_max_exp;
+  PRAT rat_min_exp;
+  PRAT rat_max_fact;
+  PRAT rat_min_fact;
+
+  // constants built on first use, see support.cpp
+  LAZYRAT lazy[LAZY_RAT_COUNT];
+
+  uint32_t error; // first error since ClearRatError
+
+  RATPOLL poll;          // see SetRatPoll
+  void *pollParam;       // passed to poll
+  int32_t pollInterval;  // units of work between two poll calls
+  int32_t pollBudget;    // units of work left until the next poll call
+
+  RATBOUND bound;        // see SetRatBound
+  int32_t boundGuard;    // digits kept beyond the precision
+
+  RATALLOCSTATS allocStats; // see GetRatAllocStats
+} RATCONTEXT, *PRATCONTEXT;
+
+// context of the calling thread
+extern thread_local PRATCONTEXT g_ratctx;
+
+//-----------------------------------------------------------------------------
+//
+//  Error handling. RATPAK_THROW raises an error, the statement after it has
+//  to leave a valid result and return. RATPAK_TRY/RATPAK_CATCH clean up and
+//  pass the error on, RATPAK_FAILED lets long loops stop early. Errors that
+//  leave nothing to return with, like running out of memory, abort without
+//  exceptions just like new does.
+//
+//  RATPAK_POLL counts units of work, one unit is about one limb
+//  multiplication, and calls the poll callback of the context when the
+//  interval is used up. A cancel is never thrown, it is recorded like an
+//  error without exceptions so the loops unwind on their own.
+//
+//-----------------------------------------------------------------------------
+
+#if RATPAK_EXCEPTIONS
+#define RATPAK_THROW(e) throw(e)
+#define RATPAK_FATAL(e) throw(e)
+#define RATPAK_TRY try
+#define RATPAK_CATCH(e) catch (uint32_t e)
+#else
+#define RATPAK_THROW(e) SetRatError(e)
+#define RATPAK_FATAL(e) abort()
+#define RATPAK_TRY
+#define RATPAK_CATCH(e) if (uint32_t e = g_ratctx->error)
+#endif
+
+#define RATPAK_FAILED() (g_ratctx->error != 0)
+
+#define RATPAK_POLL(work)                                \
+  if ((g_ratctx->pollBudget -= (int32_t)(work)) < 0)     \
+  {                                                      \
+    RatPoll();                                           \
+  }
+
+//-----------------------------------------------------------------------------
+//
+// List of useful constants for evaluation, they live in the current context
+// and are initialized by ChangeConstants.
+//
+//-----------------------------------------------------------------------------
+
+#define num_one (g_ratctx->num_one)
+#define num_two (g_ratctx->num_two)
+#define num_five (g_ratctx->num_five)
+#define num_six (g_ratctx->num_six)
+#define num_ten (g_ratctx->num_ten)
+
+#define rat_zero (g_ratctx->rat_zero)
+#define rat_neg_one (g_ratctx->rat_neg_one)
+#define rat_one (g_ratctx->rat_one)
+#define rat_two (g_ratctx->rat_two)
+#define rat_six (g_ratctx->rat_six)
+#define rat_half (g_ratctx->rat_half)
+#define rat_ten (g_ratctx->rat_ten)
+#define pt_eight_five (g_ratctx->pt_eight_five)
+#define rat_360 (g_ratctx->rat_360)
+#define rat_400 (g_ratctx->rat_400)
+#define rat_180 (g_ratctx->rat_180)
+#define rat_200 (g_ratctx->rat_200)
+#define rat_nRadix (g_ratctx->rat_nRadix)
+#define rat_smallest (g_ratctx->rat_smallest)
+#define rat_negsmallest (g_ratctx->rat_negsmallest)
+#define rat_max_exp (g_ratctx->rat_max_exp)
+#define rat_min_exp (g_ratctx->rat_min_exp)
+#define rat_max_fact (g_ratctx->rat_max_fact)
+#define rat_min_fact (g_ratctx->rat_min_fact)
+
+//-----------------------------------------------------------------------------
+//
+// Constants that are expensive to build or rarely used. They are created on
+// first access for the current radix and precision and invalidated by
+// ChangeConstants when either of them changes.
+//
+//-----------------------------------------------------------------------------
+
+extern PRAT ln_ten();
+extern PRAT ln_two();
+extern PRAT pi();
+extern PRAT pi_over_two();
+extern PRAT two_pi();
+extern PRAT one_pt_five_pi();
+extern PRAT e_to_one_half();
+extern PRAT rat_exp();
+extern PRAT rad_to_deg();
+extern PRAT rad_to_grad();
+extern PRAT rat_qword();
+extern PRAT rat_dword();
+extern PRAT rat_word();
+extern PRAT rat_byte();
+extern PRAT rat_max_i32();
+extern PRAT rat_min_i32();
 
 // DUPNUM Duplicates a number taking care of allocation and internals
 #define DUPNUM(a, b)         \
@@ -217,7 +392,7 @@ extern PRAT rat_min_i32;
     (x)->pq->exp -= trim;                                                                          \
   }
 
-#define SMALL_ENOUGH_RAT(a, precision) (zernum((a)->pp) || ((((a)->pq->cdigit + (a)->pq->exp) - ((a)->pp->cdigit + (a)->pp->exp) - 1) * g_ratio > precision))
+#define SMALL_ENOUGH_RAT(a, precision) (RATPAK_FAILED() || zernum((a)->pp) || ((((a)->pq->cdigit + (a)->pq->exp) - ((a)->pp->cdigit + (a)->pp->exp) - 1) * g_ratio > precision))
 
 //-----------------------------------------------------------------------------
 //
@@ -282,11 +457,15 @@ extern PRAT rat_min_i32;
 //
 //-----------------------------------------------------------------------------
 
-extern bool g_ftrueinfinite; // set to true to allow infinite precision
-                             // don't use unless you know what you are doing
-                             // used to help decide when to stop calculating.
+// set to true to allow infinite precision
+// don't use unless you know what you are doing
+// used to help decide when to stop calculating.
+#define g_ftrueinfinite (g_ratctx->ftrueinfinite)
+
+// Internally calculated ratio of internal radix
+#define g_ratio (g_ratctx->ratio)
 
-extern int32_t g_ratio; // Internally calculated ratio of internal radix
+#define g_decimalSeparator (g_ratctx->decimalSeparator)
 
 //-----------------------------------------------------------------------------
 //
@@ -300,6 +479,67 @@ extern void SetDecimalSeparator(char decimalSeparator);
 // Call whenever either radix or precision changes, is smarter about recalculating constants.
 extern void ChangeConstants(uint32_t radix, int32_t precision);
 
+// returns a text report of the lazily built constants and the precision they were built for
+extern std::string LazyConstantsReport();
+
+// creates a context with its own constants for radix and precision,
+// alloc and release default to calloc and free
+extern PRATCONTEXT CreateRatContext(uint32_t radix, int32_t precision, void *(*alloc)(size_t size) = nullptr, void (*release)(void *p) = nullptr);
+
+// frees a context and its constants, it must not be current on any thread
+extern void DestroyRatContext(PRATCONTEXT pctx);
+
+// makes pctx the context of the calling thread, nullptr selects the default context.
+// Returns the previous context of the thread.
+extern PRATCONTEXT SetRatContext(PRATCONTEXT pctx);
+
+// binds a context to the calling thread for the lifetime of the scope
+class RatContextScope
+{
+public:
+  explicit RatContextScope(PRATCONTEXT pctx) : _prev(SetRatContext(pctx)) {}
+  ~RatContextScope() { SetRatContext(_prev); }
+  RatContextScope(const RatContextScope &) = delete;
+  RatContextScope &operator=(const RatContextScope &) = delete;
+
+private:
+  PRATCONTEXT _prev;
+};
+
+// first error raised in the current context since ClearRatError, 0 if none.
+// When ratpak throws its errors only CALC_E_CANCELLED is recorded here.
+extern uint32_t GetRatError();
+
+// forgets the error of the current context
+extern void ClearRatError();
+
+// records an error in the current context unless one is already pending
+extern void SetRatError(uint32_t error);
+
+// sets the poll callback of the current context. It is called about every
+// interval units of work, where a unit is one limb multiplication, and may
+// yield or feed a watchdog. Returning true cancels the calculation, it ends
+// early with CALC_E_CANCELLED. nullptr removes the callback.
+extern void SetRatPoll(RATPOLL poll, void *param, uint32_t interval);
+
+// calls the poll callback and starts the next interval, returns true if
+// the calculation has to stop. Used by RATPAK_POLL.
+extern bool RatPoll();
+
+// sets how the current context bounds denominators. With RATBOUND_TRIM a
+// denominator longer than precision plus guardDigits is cut to that length,
+// the value changes by less than the guard digits. Chained divisions of
+// small numbers keep their size instead of growing without end.
+extern void SetRatBound(RATBOUND bound, int32_t guardDigits);
+
+// allocation counters of the current context, they include the constants.
+// Always zero when ratpak is built without RATPAK_ALLOC_STATS.
+extern RATALLOCSTATS GetRatAllocStats();
+
+// restarts the peak of the current context at the bytes allocated now,
+// the peak of a single calculation is measured from there
+extern void ResetRatAllocPeak();
+
 extern bool equnum(PNUMBER a, PNUMBER b);  // returns true of a == b
 extern bool lessnum(PNUMBER a, PNUMBER b); // returns true of a < b
 extern bool zernum(PNUMBER a);             // returns true of a == 0
@@ -459,6 +699,20 @@ extern void _dumprawnum(const char *varname, PNUMBER num, std::ostream &out);
 // if |pr| is magnitude smaller than |a| or |b| beyond precision, snap pr to 0
 extern void _snaprat(PRAT* pr, PRAT a, PRAT b, int32_t precision);
 
+// destination passing, *pc = a op b without touching a and b. The old *pc is
+// destroyed and may be a or b, so results need no temporary copies.
+extern void addnum_into(PNUMBER *pc, PNUMBER a, PNUMBER b, uint32_t radix);
+extern void mulnumx_into(PNUMBER *pc, PNUMBER a, PNUMBER b);
+extern void addrat_into(PRAT *pc, PRAT a, PRAT b, int32_t precision);
+extern void subrat_into(PRAT *pc, PRAT a, PRAT b, int32_t precision);
+extern void mulrat_into(PRAT *pc, PRAT a, PRAT b, int32_t precision);
+extern void divrat_into(PRAT *pc, PRAT a, PRAT b, int32_t precision);
+extern void modrat_into(PRAT *pc, PRAT a, PRAT b);
+
+// reversed operands, *pa = b op *pa
+extern void subrat_rev(PRAT *pa, PRAT b, int32_t precision);
+extern void divrat_rev(PRAT *pa, PRAT b, int32_t precision);
+
 // added functions
 extern std::string RatToScientificString(PRAT &prat, uint32_t radix, int32_t precision);
 extern std::string NumberToScientificString(PNUMBER &pnum, uint32_t radix, int32_t precision);
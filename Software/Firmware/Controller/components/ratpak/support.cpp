@@ -26,12 +26,9 @@
 
 using namespace std;
 
-void _readconstants();
-
 #if defined(GEN_CONST)
 static int cbitsofprecision = 0;
-#define READRAWRAT(v)
-#define READRAWNUM(v)
+#define LOADRAWRAT(r, v)
 #define DUMPRAWRAT(v) _dumprawrat(#v, v, wcout)
 #define DUMPRAWNUM(v)                                                  \
   fprintf(stderr, "// Autogenerated by _dumprawrat in support.cpp\n"); \
@@ -43,11 +40,15 @@ static int cbitsofprecision = 0;
 
 #define DUMPRAWRAT(v)
 #define DUMPRAWNUM(v)
-#define READRAWRAT(v)               \
-  createrat(v);                     \
-  DUPNUM((v)->pp, (&(init_p_##v))); \
-  DUPNUM((v)->pq, (&(init_q_##v)));
-#define READRAWNUM(v) DUPNUM(v, (&(init_##v)))
+#if RATPAK_DECIMAL_BASE
+// the pregenerated constants are in base 2^31, compute them instead
+#define LOADRAWRAT(r, v)
+#else
+#define LOADRAWRAT(r, v)            \
+  createrat(r);                     \
+  DUPNUM((r)->pp, (&(init_p_##v))); \
+  DUPNUM((r)->pq, (&(init_q_##v)));
+#endif
 
 #define INIT_AND_DUMP_RAW_NUM_IF_NULL(r, v) \
   if (r == nullptr)                         \
@@ -66,57 +67,72 @@ static constexpr int RATIO_FOR_DECIMAL = 9;
 static constexpr int DECIMAL = 10;
 static constexpr int CALC_DECIMAL_DIGITS_DEFAULT = 32;
 
+#if RATPAK_DECIMAL_BASE
+static int cbitsofprecision = 0;
+#else
 static int cbitsofprecision = RATIO_FOR_DECIMAL * DECIMAL * CALC_DECIMAL_DIGITS_DEFAULT;
 
 #include "ratconst.h"
+#endif
 
 #endif
 
-bool g_ftrueinfinite = false; // Set to true if you don't want
-                              // chopping internally
-                              // precision used internally
-
-PNUMBER num_one = nullptr;
-PNUMBER num_two = nullptr;
-PNUMBER num_five = nullptr;
-PNUMBER num_six = nullptr;
-PNUMBER num_ten = nullptr;
-
-PRAT ln_ten = nullptr;
-PRAT ln_two = nullptr;
-PRAT rat_zero = nullptr;
-PRAT rat_one = nullptr;
-PRAT rat_neg_one = nullptr;
-PRAT rat_two = nullptr;
-PRAT rat_six = nullptr;
-PRAT rat_half = nullptr;
-PRAT rat_ten = nullptr;
-PRAT pt_eight_five = nullptr;
-PRAT pi = nullptr;
-PRAT pi_over_two = nullptr;
-PRAT two_pi = nullptr;
-PRAT one_pt_five_pi = nullptr;
-PRAT e_to_one_half = nullptr;
-PRAT rat_exp = nullptr;
-PRAT rad_to_deg = nullptr;
-PRAT rad_to_grad = nullptr;
-PRAT rat_qword = nullptr;
-PRAT rat_dword = nullptr; // unsigned max ui32
-PRAT rat_word = nullptr;
-PRAT rat_byte = nullptr;
-PRAT rat_360 = nullptr;
-PRAT rat_400 = nullptr;
-PRAT rat_180 = nullptr;
-PRAT rat_200 = nullptr;
-PRAT rat_nRadix = nullptr;
-PRAT rat_smallest = nullptr;
-PRAT rat_negsmallest = nullptr;
-PRAT rat_max_exp = nullptr;
-PRAT rat_min_exp = nullptr;
-PRAT rat_max_fact = nullptr;
-PRAT rat_min_fact = nullptr;
-PRAT rat_min_i32 = nullptr; // min signed i32
-PRAT rat_max_i32 = nullptr; // max signed i32
+// lazily built constants, see _lazyrat
+enum LAZY_CONST
+{
+  LAZY_LN_TEN,
+  LAZY_LN_TWO,
+  LAZY_PI,
+  LAZY_PI_OVER_TWO,
+  LAZY_TWO_PI,
+  LAZY_ONE_PT_FIVE_PI,
+  LAZY_E_TO_ONE_HALF,
+  LAZY_RAT_EXP,
+  LAZY_RAD_TO_DEG,
+  LAZY_RAD_TO_GRAD,
+  LAZY_RAT_QWORD,
+  LAZY_RAT_DWORD,
+  LAZY_RAT_WORD,
+  LAZY_RAT_BYTE,
+  LAZY_RAT_MAX_I32,
+  LAZY_RAT_MIN_I32,
+  LAZY_COUNT
+};
+
+static_assert(LAZY_COUNT == LAZY_RAT_COUNT, "LAZY_RAT_COUNT does not match LAZY_CONST");
+
+static const char *const g_lazyratnames[LAZY_COUNT] = {
+    "ln_ten",
+    "ln_two",
+    "pi",
+    "pi_over_two",
+    "two_pi",
+    "one_pt_five_pi",
+    "e_to_one_half",
+    "rat_exp",
+    "rad_to_deg",
+    "rad_to_grad",
+    "rat_qword",
+    "rat_dword",
+    "rat_word",
+    "rat_byte",
+    "rat_max_i32",
+    "rat_min_i32",
+};
+
+// context used by threads that did not bind one, radix and precision are
+// set by the first ChangeConstants call. The constants start out as nullptr.
+// Built by a constexpr function, so it is initialized before any constructor runs.
+static constexpr RATCONTEXT DefaultRatContext()
+{
+  RATCONTEXT ctx = {};
+  ctx.decimalSeparator = '.';
+  return (ctx);
+}
+
+static RATCONTEXT g_defaultratctx = DefaultRatContext();
+
+thread_local PRATCONTEXT g_ratctx = &g_defaultratctx;
 
 //----------------------------------------------------------------------------
 //
@@ -126,160 +142,648 @@ PRAT rat_max_i32 = nullptr; // max signed i32
 //
 //  RETURN: None
 //
-//  SIDE EFFECTS: sets a mess of constants.
+//  SIDE EFFECTS: sets the cheap constants, invalidates the lazy constants
+//  built for a different radix or precision.
 //
 //
 //----------------------------------------------------------------------------
 
 void ChangeConstants(uint32_t radix, int32_t precision)
 {
+  // the constants are built without the pending error, the loops would end
+  // early otherwise
+  uint32_t error = g_ratctx->error;
+  g_ratctx->error = 0;
+
   // ratio is set to the number of digits in the current radix, you can get
   // in the internal BASEX radix, this is important for length calculations
   // in translating from radix to BASEX and back.
 
+#if RATPAK_DECIMAL_BASE
+  g_ratio = 0;
+  for (uint64_t power = radix; power <= BASEX; power *= radix)
+  {
+    g_ratio++;
+  }
+#else
   g_ratio = static_cast<int32_t>(ceil(BASEXPWR / log2(radix))) - 1;
+#endif
 
   destroyrat(rat_nRadix);
   rat_nRadix = i32torat(radix);
 
-  // Check to see what we have to recalculate and what we don't
-  if (cbitsofprecision < (g_ratio * static_cast<int32_t>(radix) * precision))
-  {
-    g_ftrueinfinite = false;
-
-    INIT_AND_DUMP_RAW_NUM_IF_NULL(num_one, 1L);
-    INIT_AND_DUMP_RAW_NUM_IF_NULL(num_two, 2L);
-    INIT_AND_DUMP_RAW_NUM_IF_NULL(num_five, 5L);
-    INIT_AND_DUMP_RAW_NUM_IF_NULL(num_six, 6L);
-    INIT_AND_DUMP_RAW_NUM_IF_NULL(num_ten, 10L);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_six, 6L);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_two, 2L);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_zero, 0L);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_one, 1L);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_neg_one, -1L);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_ten, 10L);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_word, 0xffff);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_word, 0xff);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_400, 400);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_360, 360);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_200, 200);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_180, 180);
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_max_exp, 100000);
-
-    // 3248, is the max number for which calc is able to compute factorial, after that it is unable to compute due to overflow.
-    // Hence restricted factorial range as at most 3248.Beyond that calc will throw overflow error immediately.
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_max_fact, 3249);
-
-    // -1000, is the min number for which calc is able to compute factorial, after that it takes too long to compute.
-    INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_min_fact, -1000);
-
-    DUPRAT(rat_smallest, rat_nRadix);
-    ratpowi32(&rat_smallest, -precision, precision);
-    DUPRAT(rat_negsmallest, rat_smallest);
-    rat_negsmallest->pp->sign = -1;
-    DUMPRAWRAT(rat_smallest);
-    DUMPRAWRAT(rat_negsmallest);
-
-    if (rat_half == nullptr)
+  g_ftrueinfinite = false;
+
+  INIT_AND_DUMP_RAW_NUM_IF_NULL(num_one, 1L);
+  INIT_AND_DUMP_RAW_NUM_IF_NULL(num_two, 2L);
+  INIT_AND_DUMP_RAW_NUM_IF_NULL(num_five, 5L);
+  INIT_AND_DUMP_RAW_NUM_IF_NULL(num_six, 6L);
+  INIT_AND_DUMP_RAW_NUM_IF_NULL(num_ten, 10L);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_six, 6L);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_two, 2L);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_zero, 0L);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_one, 1L);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_neg_one, -1L);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_ten, 10L);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_400, 400);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_360, 360);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_200, 200);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_180, 180);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_max_exp, 100000);
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_min_exp, -100000);
+
+  // 3248, is the max number for which calc is able to compute factorial, after that it is unable to compute due to overflow.
+  // Hence restricted factorial range as at most 3248.Beyond that calc will throw overflow error immediately.
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_max_fact, 3249);
+
+  // -1000, is the min number for which calc is able to compute factorial, after that it takes too long to compute.
+  INIT_AND_DUMP_RAW_RAT_IF_NULL(rat_min_fact, -1000);
+
+  if (rat_half == nullptr)
+  {
+    createrat(rat_half);
+    DUPNUM(rat_half->pp, num_one);
+    DUPNUM(rat_half->pq, num_two);
+    DUMPRAWRAT(rat_half);
+  }
+
+  if (pt_eight_five == nullptr)
+  {
+    createrat(pt_eight_five);
+    pt_eight_five->pp = i32tonum(85L, BASEX);
+    pt_eight_five->pq = i32tonum(100L, BASEX);
+    DUMPRAWRAT(pt_eight_five);
+  }
+
+  DUPRAT(rat_smallest, rat_nRadix);
+  ratpowi32(&rat_smallest, -precision, precision);
+  DUPRAT(rat_negsmallest, rat_smallest);
+  rat_negsmallest->pp->sign = -1;
+  DUMPRAWRAT(rat_smallest);
+  DUMPRAWRAT(rat_negsmallest);
+
+  // Drop the lazy constants, they are rebuilt on next use.
+  if ((radix != g_ratctx->radix) || (precision != g_ratctx->precision))
+  {
+    for (int i = 0; i < LAZY_COUNT; i++)
+    {
+      destroyrat(g_ratctx->lazy[i].value);
+    }
+    g_ratctx->radix = radix;
+    g_ratctx->precision = precision;
+  }
+  g_ratctx->error = error;
+}
+
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: _buildlazyrat
+//
+//  ARGUMENTS:  index of the lazy constant
+//
+//  RETURN: the new constant
+//
+//  DESCRIPTION: Loads the constant from the pregenerated tables if they
+//  cover the current precision, calculates it otherwise.
+//
+//----------------------------------------------------------------------------
+
+static PRAT _buildlazyrat(int index)
+{
+  PRAT ret = nullptr;
+  uint32_t radix = g_ratctx->radix;
+  int32_t precision = g_ratctx->precision;
+
+  // Apparently when dividing 180 by pi, another (internal) digit of
+  // precision is needed.
+  int32_t extraPrecision = precision + g_ratio;
+
+  if (cbitsofprecision >= (g_ratio * static_cast<int32_t>(radix) * precision))
+  {
+    switch (index)
     {
-      createrat(rat_half);
-      DUPNUM(rat_half->pp, num_one);
-      DUPNUM(rat_half->pq, num_two);
-      DUMPRAWRAT(rat_half);
+    case LAZY_LN_TEN:
+      LOADRAWRAT(ret, ln_ten);
+      break;
+    case LAZY_LN_TWO:
+      LOADRAWRAT(ret, ln_two);
+      break;
+    case LAZY_PI:
+      LOADRAWRAT(ret, pi);
+      break;
+    case LAZY_PI_OVER_TWO:
+      LOADRAWRAT(ret, pi_over_two);
+      break;
+    case LAZY_TWO_PI:
+      LOADRAWRAT(ret, two_pi);
+      break;
+    case LAZY_ONE_PT_FIVE_PI:
+      LOADRAWRAT(ret, one_pt_five_pi);
+      break;
+    case LAZY_E_TO_ONE_HALF:
+      LOADRAWRAT(ret, e_to_one_half);
+      break;
+    case LAZY_RAT_EXP:
+      LOADRAWRAT(ret, rat_exp);
+      break;
+    case LAZY_RAD_TO_DEG:
+      LOADRAWRAT(ret, rad_to_deg);
+      break;
+    case LAZY_RAD_TO_GRAD:
+      LOADRAWRAT(ret, rad_to_grad);
+      break;
+    case LAZY_RAT_QWORD:
+      LOADRAWRAT(ret, rat_qword);
+      break;
+    case LAZY_RAT_DWORD:
+      LOADRAWRAT(ret, rat_dword);
+      break;
+    case LAZY_RAT_WORD:
+      LOADRAWRAT(ret, rat_word);
+      break;
+    case LAZY_RAT_BYTE:
+      LOADRAWRAT(ret, rat_byte);
+      break;
+    case LAZY_RAT_MAX_I32:
+      LOADRAWRAT(ret, rat_max_i32);
+      break;
+    case LAZY_RAT_MIN_I32:
+      LOADRAWRAT(ret, rat_min_i32);
+      break;
     }
+    if (ret != nullptr)
+    {
+      return (ret);
+    }
+  }
 
-    if (pt_eight_five == nullptr)
+  switch (index)
+  {
+  case LAZY_LN_TEN:
+    // WARNING: remember _lograt uses e_to_one_half and ln_two
+    DUPRAT(ret, rat_ten);
+    _lograt(&ret, extraPrecision);
+    break;
+
+  case LAZY_LN_TWO:
+    DUPRAT(ret, rat_two);
+    _lograt(&ret, extraPrecision);
+    break;
+
+  case LAZY_PI:
+    DUPRAT(ret, rat_half);
+    asinrat(&ret, radix, extraPrecision);
+    mulrat(&ret, rat_six, extraPrecision);
+    break;
+
+  case LAZY_PI_OVER_TWO:
+    DUPRAT(ret, pi());
+    divrat(&ret, rat_two, extraPrecision);
+    break;
+
+  case LAZY_TWO_PI:
+    DUPRAT(ret, pi());
+    _addrat(&ret, pi(), extraPrecision);
+    break;
+
+  case LAZY_ONE_PT_FIVE_PI:
+    DUPRAT(ret, pi());
+    _addrat(&ret, pi_over_two(), extraPrecision);
+    break;
+
+  case LAZY_E_TO_ONE_HALF:
+    DUPRAT(ret, rat_half);
+    _exprat(&ret, extraPrecision);
+    break;
+
+  case LAZY_RAT_EXP:
+    DUPRAT(ret, rat_one);
+    _exprat(&ret, extraPrecision);
+    break;
+
+  case LAZY_RAD_TO_DEG:
+    ret = i32torat(180L);
+    divrat(&ret, pi(), extraPrecision);
+    break;
+
+  case LAZY_RAD_TO_GRAD:
+    ret = i32torat(200L);
+    divrat(&ret, pi(), extraPrecision);
+    break;
+
+  case LAZY_RAT_QWORD:
+    DUPRAT(ret, rat_two);
+    numpowi32(&(ret->pp), 64, BASEX, precision);
+    _subrat(&ret, rat_one, precision);
+    break;
+
+  case LAZY_RAT_DWORD:
+    DUPRAT(ret, rat_two);
+    numpowi32(&(ret->pp), 32, BASEX, precision);
+    _subrat(&ret, rat_one, precision);
+    break;
+
+  case LAZY_RAT_WORD:
+    ret = i32torat(0xffff);
+    break;
+
+  case LAZY_RAT_BYTE:
+    ret = i32torat(0xff);
+    break;
+
+  case LAZY_RAT_MAX_I32:
+    // rat_max_i32 = 2^31 -1
+    DUPRAT(ret, rat_two);
+    numpowi32(&(ret->pp), 31, BASEX, precision);
+    _subrat(&ret, rat_one, precision);
+    break;
+
+  case LAZY_RAT_MIN_I32:
+    // rat_min_i32 = -2^31
+    DUPRAT(ret, rat_two);
+    numpowi32(&(ret->pp), 31, BASEX, precision);
+    ret->pp->sign *= -1;
+    break;
+  }
+  return (ret);
+}
+
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: _lazyrat
+//
+//  ARGUMENTS:  index of the lazy constant
+//
+//  RETURN: the constant, built for the current radix and precision
+//
+//  DESCRIPTION: The constant is built without the pending error. A build
+//  that fails or is cancelled is returned but not kept, the next use
+//  builds it again.
+//
+//----------------------------------------------------------------------------
+
+static PRAT _lazyrat(int index)
+{
+  LAZYRAT *plazy = &g_ratctx->lazy[index];
+  if ((plazy->value == nullptr) || (plazy->precision < 0))
+  {
+    uint32_t error = g_ratctx->error;
+    g_ratctx->error = 0;
+    destroyrat(plazy->value);
+    plazy->value = _buildlazyrat(index);
+    plazy->precision = RATPAK_FAILED() ? -1 : g_ratctx->precision;
+    if (error != 0)
     {
-      createrat(pt_eight_five);
-      pt_eight_five->pp = i32tonum(85L, BASEX);
-      pt_eight_five->pq = i32tonum(100L, BASEX);
-      DUMPRAWRAT(pt_eight_five);
+      g_ratctx->error = error;
     }
+  }
+  plazy->touched = true;
+  return (plazy->value);
+}
+
+PRAT ln_ten()
+{
+  return (_lazyrat(LAZY_LN_TEN));
+}
+
+PRAT ln_two()
+{
+  return (_lazyrat(LAZY_LN_TWO));
+}
+
+PRAT pi()
+{
+  return (_lazyrat(LAZY_PI));
+}
+
+PRAT pi_over_two()
+{
+  return (_lazyrat(LAZY_PI_OVER_TWO));
+}
+
+PRAT two_pi()
+{
+  return (_lazyrat(LAZY_TWO_PI));
+}
+
+PRAT one_pt_five_pi()
+{
+  return (_lazyrat(LAZY_ONE_PT_FIVE_PI));
+}
+
+PRAT e_to_one_half()
+{
+  return (_lazyrat(LAZY_E_TO_ONE_HALF));
+}
+
+PRAT rat_exp()
+{
+  return (_lazyrat(LAZY_RAT_EXP));
+}
 
-    DUPRAT(rat_qword, rat_two);
-    numpowi32(&(rat_qword->pp), 64, BASEX, precision);
-    _subrat(&rat_qword, rat_one, precision);
-    DUMPRAWRAT(rat_qword);
+PRAT rad_to_deg()
+{
+  return (_lazyrat(LAZY_RAD_TO_DEG));
+}
 
-    DUPRAT(rat_dword, rat_two);
-    numpowi32(&(rat_dword->pp), 32, BASEX, precision);
-    _subrat(&rat_dword, rat_one, precision);
-    DUMPRAWRAT(rat_dword);
+PRAT rad_to_grad()
+{
+  return (_lazyrat(LAZY_RAD_TO_GRAD));
+}
 
-    DUPRAT(rat_max_i32, rat_two);
-    numpowi32(&(rat_max_i32->pp), 31, BASEX, precision);
-    DUPRAT(rat_min_i32, rat_max_i32);
-    _subrat(&rat_max_i32, rat_one, precision); // rat_max_i32 = 2^31 -1
-    DUMPRAWRAT(rat_max_i32);
+PRAT rat_qword()
+{
+  return (_lazyrat(LAZY_RAT_QWORD));
+}
 
-    rat_min_i32->pp->sign *= -1; // rat_min_i32 = -2^31
-    DUMPRAWRAT(rat_min_i32);
+PRAT rat_dword()
+{
+  return (_lazyrat(LAZY_RAT_DWORD));
+}
 
-    DUPRAT(rat_min_exp, rat_max_exp);
-    rat_min_exp->pp->sign *= -1;
-    DUMPRAWRAT(rat_min_exp);
+PRAT rat_word()
+{
+  return (_lazyrat(LAZY_RAT_WORD));
+}
 
-    cbitsofprecision = g_ratio * radix * precision;
+PRAT rat_byte()
+{
+  return (_lazyrat(LAZY_RAT_BYTE));
+}
 
-    // Apparently when dividing 180 by pi, another (internal) digit of
-    // precision is needed.
-    int32_t extraPrecision = precision + g_ratio;
-    DUPRAT(pi, rat_half);
-    asinrat(&pi, radix, extraPrecision);
-    mulrat(&pi, rat_six, extraPrecision);
-    DUMPRAWRAT(pi);
+PRAT rat_max_i32()
+{
+  return (_lazyrat(LAZY_RAT_MAX_I32));
+}
 
-    DUPRAT(two_pi, pi);
-    DUPRAT(pi_over_two, pi);
-    DUPRAT(one_pt_five_pi, pi);
-    _addrat(&two_pi, pi, extraPrecision);
-    DUMPRAWRAT(two_pi);
+PRAT rat_min_i32()
+{
+  return (_lazyrat(LAZY_RAT_MIN_I32));
+}
 
-    divrat(&pi_over_two, rat_two, extraPrecision);
-    DUMPRAWRAT(pi_over_two);
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: LazyConstantsReport
+//
+//  ARGUMENTS:  none
+//
+//  RETURN: text listing the lazy constants that were requested so far and
+//  the precision they were built for, followed by the untouched ones.
+//
+//----------------------------------------------------------------------------
 
-    _addrat(&one_pt_five_pi, pi_over_two, extraPrecision);
-    DUMPRAWRAT(one_pt_five_pi);
+string LazyConstantsReport()
+{
+  string touched;
+  string untouched;
+  for (int i = 0; i < LAZY_COUNT; i++)
+  {
+    if (g_ratctx->lazy[i].touched)
+    {
+      touched += " ";
+      touched += g_lazyratnames[i];
+      touched += "(" + to_string(g_ratctx->lazy[i].precision) + ")";
+    }
+    else
+    {
+      untouched += " ";
+      untouched += g_lazyratnames[i];
+    }
+  }
+  return ("ratpak constants touched:" + touched + ", untouched:" + untouched);
+}
 
-    DUPRAT(e_to_one_half, rat_half);
-    _exprat(&e_to_one_half, extraPrecision);
-    DUMPRAWRAT(e_to_one_half);
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: CreateRatContext
+//
+//  ARGUMENTS:  radix and precision for the constants, optional allocator
+//
+//  RETURN: new context, owned by the caller and released with
+//  DestroyRatContext
+//
+//  DESCRIPTION: Creates a context with its own copies of the constants.
+//  The context is allocated and filled with the given allocator, the
+//  constants are built while the new context is current on the calling
+//  thread.
+//
+//----------------------------------------------------------------------------
 
-    DUPRAT(rat_exp, rat_one);
-    _exprat(&rat_exp, extraPrecision);
-    DUMPRAWRAT(rat_exp);
+PRATCONTEXT CreateRatContext(uint32_t radix, int32_t precision, void *(*alloc)(size_t size), void (*release)(void *p))
+{
+  PRATCONTEXT pctx = (PRATCONTEXT)(alloc != nullptr ? alloc(sizeof(RATCONTEXT)) : calloc(1, sizeof(RATCONTEXT)));
+  if (pctx == nullptr)
+  {
+    RATPAK_THROW(CALC_E_OUTOFMEMORY);
+    return (nullptr);
+  }
+  if (alloc != nullptr)
+  {
+    memset(pctx, 0, sizeof(RATCONTEXT));
+  }
+  pctx->decimalSeparator = '.';
+  pctx->alloc = alloc;
+  pctx->release = release;
 
-    // WARNING: remember _lograt uses exponent constants calculated above...
+  RatContextScope scope(pctx);
+  ChangeConstants(radix, precision);
+  return (pctx);
+}
 
-    DUPRAT(ln_ten, rat_ten);
-    _lograt(&ln_ten, extraPrecision);
-    DUMPRAWRAT(ln_ten);
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: DestroyRatContext
+//
+//  ARGUMENTS:  context created by CreateRatContext
+//
+//  RETURN: None
+//
+//  DESCRIPTION: Frees the constants of the context and the context itself.
+//
+//----------------------------------------------------------------------------
 
-    DUPRAT(ln_two, rat_two);
-    _lograt(&ln_two, extraPrecision);
-    DUMPRAWRAT(ln_two);
+void DestroyRatContext(PRATCONTEXT pctx)
+{
+  if ((pctx == nullptr) || (pctx == &g_defaultratctx))
+  {
+    return;
+  }
 
-    destroyrat(rad_to_deg);
-    rad_to_deg = i32torat(180L);
-    divrat(&rad_to_deg, pi, extraPrecision);
-    DUMPRAWRAT(rad_to_deg);
+  {
+    RatContextScope scope(pctx);
+    destroynum(num_one);
+    destroynum(num_two);
+    destroynum(num_five);
+    destroynum(num_six);
+    destroynum(num_ten);
+    destroyrat(rat_zero);
+    destroyrat(rat_neg_one);
+    destroyrat(rat_one);
+    destroyrat(rat_two);
+    destroyrat(rat_six);
+    destroyrat(rat_half);
+    destroyrat(rat_ten);
+    destroyrat(pt_eight_five);
+    destroyrat(rat_360);
+    destroyrat(rat_400);
+    destroyrat(rat_180);
+    destroyrat(rat_200);
+    destroyrat(rat_nRadix);
+    destroyrat(rat_smallest);
+    destroyrat(rat_negsmallest);
+    destroyrat(rat_max_exp);
+    destroyrat(rat_min_exp);
+    destroyrat(rat_max_fact);
+    destroyrat(rat_min_fact);
+    for (int i = 0; i < LAZY_COUNT; i++)
+    {
+      destroyrat(pctx->lazy[i].value);
+    }
+  }
 
-    destroyrat(rad_to_grad);
-    rad_to_grad = i32torat(200L);
-    divrat(&rad_to_grad, pi, extraPrecision);
-    DUMPRAWRAT(rad_to_grad);
+  if (pctx->release != nullptr)
+  {
+    pctx->release(pctx);
   }
   else
   {
-    _readconstants();
+    free(pctx);
+  }
+}
+
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: SetRatContext
+//
+//  ARGUMENTS:  context to use on the calling thread, nullptr for the
+//  default context
+//
+//  RETURN: the context that was current before
+//
+//----------------------------------------------------------------------------
+
+PRATCONTEXT SetRatContext(PRATCONTEXT pctx)
+{
+  PRATCONTEXT prev = g_ratctx;
+  g_ratctx = (pctx != nullptr) ? pctx : &g_defaultratctx;
+  return (prev);
+}
+
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: GetRatError, ClearRatError, SetRatError
+//
+//  ARGUMENTS:  error to record for SetRatError
+//
+//  RETURN: the pending error of the current context for GetRatError
+//
+//  DESCRIPTION: Without exceptions errors are recorded in the current
+//  context, with exceptions only cancels are. Only the first error is
+//  kept, the values computed after it are meaningless.
+//
+//----------------------------------------------------------------------------
 
-    DUPRAT(rat_smallest, rat_nRadix);
-    ratpowi32(&rat_smallest, -precision, precision);
-    DUPRAT(rat_negsmallest, rat_smallest);
-    rat_negsmallest->pp->sign = -1;
+uint32_t GetRatError()
+{
+  return (g_ratctx->error);
+}
+
+void ClearRatError()
+{
+  g_ratctx->error = 0;
+}
+
+void SetRatError(uint32_t error)
+{
+  if (g_ratctx->error == 0)
+  {
+    g_ratctx->error = error;
   }
 }
 
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: SetRatPoll, RatPoll
+//
+//  ARGUMENTS:  callback, its parameter and the units of work between two
+//  calls for SetRatPoll
+//
+//  RETURN: true from RatPoll if the calculation has to stop
+//
+//  DESCRIPTION: The poll callback lets long calculations yield and be
+//  cancelled. RATPAK_POLL counts the work and calls RatPoll when the
+//  interval is used up. A cancel is recorded as CALC_E_CANCELLED, the loops
+//  of the math package check for a pending error and end early.
+//
+//----------------------------------------------------------------------------
+
+void SetRatPoll(RATPOLL poll, void *param, uint32_t interval)
+{
+  g_ratctx->poll = poll;
+  g_ratctx->pollParam = param;
+  g_ratctx->pollInterval = (int32_t)std::min(interval, (uint32_t)INT32_MAX);
+  g_ratctx->pollBudget = g_ratctx->pollInterval;
+}
+
+bool RatPoll()
+{
+  if (g_ratctx->poll == nullptr)
+  {
+    g_ratctx->pollBudget = INT32_MAX;
+    return (RATPAK_FAILED());
+  }
+  g_ratctx->pollBudget = g_ratctx->pollInterval;
+  if (g_ratctx->poll(g_ratctx->pollParam))
+  {
+    SetRatError(CALC_E_CANCELLED);
+  }
+  return (RATPAK_FAILED());
+}
+
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: SetRatBound
+//
+//  ARGUMENTS:  bounding policy and the digits kept beyond the precision
+//
+//  RETURN: None
+//
+//  DESCRIPTION: Sets how trimit bounds the denominators of the current
+//  context.
+//
+//----------------------------------------------------------------------------
+
+void SetRatBound(RATBOUND bound, int32_t guardDigits)
+{
+  g_ratctx->bound = bound;
+  g_ratctx->boundGuard = max<int32_t>(guardDigits, 0);
+}
+
+//----------------------------------------------------------------------------
+//
+//  FUNCTION: GetRatAllocStats, ResetRatAllocPeak
+//
+//  ARGUMENTS:  None
+//
+//  RETURN: the allocation counters of the current context for
+//  GetRatAllocStats
+//
+//  DESCRIPTION: zmalloc and zfree count the blocks and bytes of the current
+//  context. Resetting the peak before a calculation and reading it after
+//  gives the most memory the calculation held at once.
+//
+//----------------------------------------------------------------------------
+
+RATALLOCSTATS GetRatAllocStats()
+{
+  return (g_ratctx->allocStats);
+}
+
+void ResetRatAllocPeak()
+{
+  g_ratctx->allocStats.peakBytes = g_ratctx->allocStats.liveBytes;
+}
+
 //----------------------------------------------------------------------------
 //
 //  FUNCTION: intrat
@@ -318,27 +822,192 @@ void intrat(PRAT *px, uint32_t radix, int32_t precision)
   }
 }
 
+// Digits of the cross products _cmprat builds on the stack, bigger operands
+// are compared by subtraction.
+static constexpr int32_t MAX_CMP_DIGITS = 48;
+
 //---------------------------------------------------------------------------
 //
-//  FUNCTION: rat_equ
+//  FUNCTION: _lognum2
 //
-//  ARGUMENTS:  PRAT a and PRAT b
+//  ARGUMENTS:  nonzero number in BASEX
 //
-//  RETURN: true if equal false otherwise.
+//  RETURN: count of BASEX digits left of the radix point, leading zero
+//  digits are not counted.
 //
+//---------------------------------------------------------------------------
+
+static int32_t _lognum2(PNUMBER pnum)
+{
+  int32_t cdigit = pnum->cdigit;
+  while ((cdigit > 1) && (pnum->mant[cdigit - 1] == 0))
+  {
+    cdigit--;
+  }
+  return (cdigit + pnum->exp);
+}
+
+//---------------------------------------------------------------------------
+//
+//  FUNCTION: _mulmant
+//
+//  ARGUMENTS:  numbers a and b in BASEX, mantissa buffer with room for
+//  a->cdigit + b->cdigit digits.
+//
+//  RETURN: count of digits written to pmant
+//
+//  DESCRIPTION: Multiplies the mantissas of a and b into the caller's
+//  buffer, signs and exponents are ignored. Grade school, like _mulnumx.
 //
 //---------------------------------------------------------------------------
 
-bool rat_equ(PRAT a, PRAT b, int32_t precision)
+static int32_t _mulmant(PNUMBER a, PNUMBER b, MANTTYPE *pmant)
+{
+  int32_t cdigit = a->cdigit + b->cdigit;
+  memset(pmant, 0, sizeof(MANTTYPE) * cdigit);
+  for (int32_t ia = 0; ia < a->cdigit; ia++)
+  {
+    TWO_MANTTYPE cy = 0;
+    for (int32_t ib = 0; ib < b->cdigit; ib++)
+    {
+      cy += static_cast<TWO_MANTTYPE>(a->mant[ia]) * b->mant[ib] + pmant[ia + ib];
+      pmant[ia + ib] = static_cast<MANTTYPE>(cy % BASEX);
+      cy /= BASEX;
+    }
+    pmant[ia + b->cdigit] = static_cast<MANTTYPE>(cy);
+  }
+  return (cdigit);
+}
+
+//---------------------------------------------------------------------------
+//
+//  FUNCTION: _cmpmant
+//
+//  ARGUMENTS:  two nonzero mantissas with their digit count and exponent
+//
+//  RETURN: -1, 0 or 1 as the magnitude of a is less, equal or greater than
+//  the magnitude of b.
+//
+//---------------------------------------------------------------------------
 
+static int _cmpmant(const MANTTYPE *pa, int32_t cadigit, int32_t aexp, const MANTTYPE *pb, int32_t cbdigit, int32_t bexp)
 {
+  while ((cadigit > 1) && (pa[cadigit - 1] == 0))
+  {
+    cadigit--;
+  }
+  while ((cbdigit > 1) && (pb[cbdigit - 1] == 0))
+  {
+    cbdigit--;
+  }
+  if ((cadigit + aexp) != (cbdigit + bexp))
+  {
+    return (((cadigit + aexp) < (cbdigit + bexp)) ? -1 : 1);
+  }
+
+  // Same length, walk down from the most significant digit.
+  int32_t cdigits = max(cadigit, cbdigit);
+  for (int32_t i = 1; i <= cdigits; i++)
+  {
+    MANTTYPE da = (i <= cadigit) ? pa[cadigit - i] : 0;
+    MANTTYPE db = (i <= cbdigit) ? pb[cbdigit - i] : 0;
+    if (da != db)
+    {
+      return ((da < db) ? -1 : 1);
+    }
+  }
+  return (0);
+}
+
+//---------------------------------------------------------------------------
+//
+//  FUNCTION: _cmprat
+//
+//  ARGUMENTS:  PRAT a, PRAT b and int32_t precision
+//
+//  RETURN: -1, 0 or 1 as a is less, equal or greater than b
+//
+//  DESCRIPTION: Exact comparison without heap allocation for the usual
+//  operands. Decides by sign first, then by the digit count estimate of
+//  LOGRAT2, then by the numerators if the denominators match, and last by
+//  comparing a.p*b.q with b.p*a.q built on the stack. Only operands too big
+//  for the stack buffers are compared by subtraction.
+//
+//---------------------------------------------------------------------------
+
+static int _cmprat(PRAT a, PRAT b, int32_t precision)
+{
+  int sa = zernum(a->pp) ? 0 : SIGN(a);
+  int sb = zernum(b->pp) ? 0 : SIGN(b);
+  if (sa != sb)
+  {
+    return ((sa < sb) ? -1 : 1);
+  }
+  if (sa == 0)
+  {
+    return (0);
+  }
+
+  // |x| lies between BASEX^(LOGRAT2(x) - 1) and BASEX^(LOGRAT2(x) + 1), a
+  // difference of two digits decides.
+  int32_t diff = (_lognum2(a->pp) - _lognum2(a->pq)) - (_lognum2(b->pp) - _lognum2(b->pq));
+  if (diff > 1)
+  {
+    return (sa);
+  }
+  if (diff < -1)
+  {
+    return (-sa);
+  }
+
+  if (equnum(a->pq, b->pq))
+  {
+    return (sa * _cmpmant(a->pp->mant, a->pp->cdigit, a->pp->exp, b->pp->mant, b->pp->cdigit, b->pp->exp));
+  }
+
+  if (((a->pp->cdigit + b->pq->cdigit) <= MAX_CMP_DIGITS) && ((b->pp->cdigit + a->pq->cdigit) <= MAX_CMP_DIGITS))
+  {
+    MANTTYPE left[MAX_CMP_DIGITS];
+    MANTTYPE right[MAX_CMP_DIGITS];
+    int32_t cleft = _mulmant(a->pp, b->pq, left);
+    int32_t cright = _mulmant(b->pp, a->pq, right);
+    return (sa * _cmpmant(left, cleft, a->pp->exp + b->pq->exp, right, cright, b->pp->exp + a->pq->exp));
+  }
+
+  // a - b is -(b - a), b stays unchanged
   PRAT rattmp = nullptr;
   DUPRAT(rattmp, a);
   rattmp->pp->sign *= -1;
-  _addrat(&rattmp, b, precision);
-  bool bret = zernum(rattmp->pp);
+  RATPAK_TRY
+  {
+    _addrat(&rattmp, b, precision);
+  }
+  RATPAK_CATCH(error)
+  {
+    destroyrat(rattmp);
+    RATPAK_THROW(error);
+    return (0);
+  }
+  int ret = zernum(rattmp->pp) ? 0 : -SIGN(rattmp);
   destroyrat(rattmp);
-  return (bret);
+  return (ret);
+}
+
+//---------------------------------------------------------------------------
+//
+//  FUNCTION: rat_equ
+//
+//  ARGUMENTS:  PRAT a and PRAT b
+//
+//  RETURN: true if equal false otherwise.
+//
+//
+//---------------------------------------------------------------------------
+
+bool rat_equ(PRAT a, PRAT b, int32_t precision)
+
+{
+  return (_cmprat(a, b, precision) == 0);
 }
 
 //---------------------------------------------------------------------------
@@ -355,14 +1024,7 @@ bool rat_equ(PRAT a, PRAT b, int32_t precision)
 bool rat_ge(PRAT a, PRAT b, int32_t precision)
 
 {
-  PRAT rattmp = nullptr;
-  DUPRAT(rattmp, a);
-  b->pp->sign *= -1;
-  _addrat(&rattmp, b, precision);
-  b->pp->sign *= -1;
-  bool bret = (zernum(rattmp->pp) || SIGN(rattmp) == 1);
-  destroyrat(rattmp);
-  return (bret);
+  return (_cmprat(a, b, precision) >= 0);
 }
 
 //---------------------------------------------------------------------------
@@ -379,14 +1041,7 @@ bool rat_ge(PRAT a, PRAT b, int32_t precision)
 bool rat_gt(PRAT a, PRAT b, int32_t precision)
 
 {
-  PRAT rattmp = nullptr;
-  DUPRAT(rattmp, a);
-  b->pp->sign *= -1;
-  _addrat(&rattmp, b, precision);
-  b->pp->sign *= -1;
-  bool bret = (!zernum(rattmp->pp) && SIGN(rattmp) == 1);
-  destroyrat(rattmp);
-  return (bret);
+  return (_cmprat(a, b, precision) > 0);
 }
 
 //---------------------------------------------------------------------------
@@ -403,14 +1058,7 @@ bool rat_gt(PRAT a, PRAT b, int32_t precision)
 bool rat_le(PRAT a, PRAT b, int32_t precision)
 
 {
-  PRAT rattmp = nullptr;
-  DUPRAT(rattmp, a);
-  b->pp->sign *= -1;
-  _addrat(&rattmp, b, precision);
-  b->pp->sign *= -1;
-  bool bret = (zernum(rattmp->pp) || SIGN(rattmp) == -1);
-  destroyrat(rattmp);
-  return (bret);
+  return (_cmprat(a, b, precision) <= 0);
 }
 
 //---------------------------------------------------------------------------
@@ -427,14 +1075,7 @@ bool rat_le(PRAT a, PRAT b, int32_t precision)
 bool rat_lt(PRAT a, PRAT b, int32_t precision)
 
 {
-  PRAT rattmp = nullptr;
-  DUPRAT(rattmp, a);
-  b->pp->sign *= -1;
-  _addrat(&rattmp, b, precision);
-  b->pp->sign *= -1;
-  bool bret = (!zernum(rattmp->pp) && SIGN(rattmp) == -1);
-  destroyrat(rattmp);
-  return (bret);
+  return (_cmprat(a, b, precision) < 0);
 }
 
 //---------------------------------------------------------------------------
@@ -451,13 +1092,7 @@ bool rat_lt(PRAT a, PRAT b, int32_t precision)
 bool rat_neq(PRAT a, PRAT b, int32_t precision)
 
 {
-  PRAT rattmp = nullptr;
-  DUPRAT(rattmp, a);
-  rattmp->pp->sign *= -1;
-  _addrat(&rattmp, b, precision);
-  bool bret = !(zernum(rattmp->pp));
-  destroyrat(rattmp);
-  return (bret);
+  return (_cmprat(a, b, precision) != 0);
 }
 
 //---------------------------------------------------------------------------
@@ -523,7 +1158,7 @@ void scale2pi(PRAT *px, uint32_t radix, int32_t precision)
   }
   else
   {
-    DUPRAT(my_two_pi, two_pi);
+    DUPRAT(my_two_pi, two_pi());
     logscale = 0;
   }
 
@@ -572,7 +1207,7 @@ void inbetween(PRAT *px, PRAT range, int32_t precision)
 //  ARGUMENTS:  const wchar *name of variable, PRAT x, output stream out
 //
 //  RETURN: none, prints the results of a dump of the internal structures
-//          of a PRAT, suitable for READRAWRAT to stderr.
+//          of a PRAT, suitable for LOADRAWRAT to stderr.
 //
 //---------------------------------------------------------------------------
 
@@ -590,7 +1225,7 @@ void _dumprawrat(const char *varname, PRAT rat, ostream &out)
 //  ARGUMENTS:  const wchar *name of variable, PNUMBER num, output stream out
 //
 //  RETURN: none, prints the results of a dump of the internal structures
-//          of a PNUMBER, suitable for READRAWNUM to stderr.
+//          of a PNUMBER, suitable for ratconst.h to stderr.
 //
 //---------------------------------------------------------------------------
 
@@ -611,50 +1246,6 @@ void _dumprawnum(const char *varname, PNUMBER num, wostream &out)
   out << "};\n";
 }
 
-void _readconstants(void)
-
-{
-  READRAWNUM(num_one);
-  READRAWNUM(num_two);
-  READRAWNUM(num_five);
-  READRAWNUM(num_six);
-  READRAWNUM(num_ten);
-  READRAWRAT(pt_eight_five);
-  READRAWRAT(rat_six);
-  READRAWRAT(rat_two);
-  READRAWRAT(rat_zero);
-  READRAWRAT(rat_one);
-  READRAWRAT(rat_neg_one);
-  READRAWRAT(rat_half);
-  READRAWRAT(rat_ten);
-  READRAWRAT(pi);
-  READRAWRAT(two_pi);
-  READRAWRAT(pi_over_two);
-  READRAWRAT(one_pt_five_pi);
-  READRAWRAT(e_to_one_half);
-  READRAWRAT(rat_exp);
-  READRAWRAT(ln_ten);
-  READRAWRAT(ln_two);
-  READRAWRAT(rad_to_deg);
-  READRAWRAT(rad_to_grad);
-  READRAWRAT(rat_qword);
-  READRAWRAT(rat_dword);
-  READRAWRAT(rat_word);
-  READRAWRAT(rat_byte);
-  READRAWRAT(rat_360);
-  READRAWRAT(rat_400);
-  READRAWRAT(rat_180);
-  READRAWRAT(rat_200);
-  READRAWRAT(rat_smallest);
-  READRAWRAT(rat_negsmallest);
-  READRAWRAT(rat_max_exp);
-  READRAWRAT(rat_min_exp);
-  READRAWRAT(rat_max_fact);
-  READRAWRAT(rat_min_fact);
-  READRAWRAT(rat_min_i32);
-  READRAWRAT(rat_max_i32);
-}
-
 //---------------------------------------------------------------------------
 //
 //  FUNCTION: trimit
@@ -671,6 +1262,12 @@ void _readconstants(void)
 //  involving hundreds of digits or more.
 //  The last part of this trim dealing with exponents never affects accuracy
 //
+//  With RATBOUND_TRIM a denominator that is still longer than the precision
+//  plus the guard digits is cut on its own. p stays short in that case, a
+//  tiny value or the result of chained divisions, and would otherwise carry
+//  an ever growing exact q. The cut changes the value by less than one unit
+//  in the last guard digit.
+//
 //  RETURN: none, modifies the pointed to PRAT
 //
 //---------------------------------------------------------------------------
@@ -709,6 +1306,17 @@ void trimit(PRAT *px, int32_t precision)
         pq->exp = 0;
       }
     }
+    if (g_ratctx->bound == RATBOUND_TRIM)
+    {
+      int32_t keep = (precision + g_ratctx->boundGuard) / g_ratio + 2;
+      if (pq->cdigit > keep)
+      {
+        trim = pq->cdigit - keep;
+        memmove(pq->mant, &(pq->mant[trim]), sizeof(MANTTYPE) * keep);
+        pq->cdigit = keep;
+        pq->exp += trim;
+      }
+    }
     trim = min(pp->exp, pq->exp);
     pp->exp -= trim;
     pq->exp -= trim;
@@ -110,7 +110,7 @@ void sinanglerat(PRAT *pa, AngleType angletype, uint32_t radix, int32_t precisio
       _subrat(pa, rat_360, precision);
     }
     divrat(pa, rat_180, precision);
-    mulrat(pa, pi, precision);
+    mulrat(pa, pi(), precision);
     break;
   case AngleType::Gradians:
     if (rat_gt(*pa, rat_200, precision))
@@ -118,7 +118,7 @@ void sinanglerat(PRAT *pa, AngleType angletype, uint32_t radix, int32_t precisio
       _subrat(pa, rat_400, precision);
     }
     divrat(pa, rat_200, precision);
-    mulrat(pa, pi, precision);
+    mulrat(pa, pi(), precision);
     break;
 
   default:
@@ -213,7 +213,7 @@ void cosanglerat(PRAT *pa, AngleType angletype, uint32_t radix, int32_t precisio
       *pa = ptmp;
     }
     divrat(pa, rat_180, precision);
-    mulrat(pa, pi, precision);
+    mulrat(pa, pi(), precision);
     break;
   case AngleType::Gradians:
     if (rat_gt(*pa, rat_200, precision))
@@ -225,7 +225,7 @@ void cosanglerat(PRAT *pa, AngleType angletype, uint32_t radix, int32_t precisio
       *pa = ptmp;
     }
     divrat(pa, rat_200, precision);
-    mulrat(pa, pi, precision);
+    mulrat(pa, pi(), precision);
     break;
 
   default:
@@ -258,7 +258,8 @@ void _tanrat(PRAT *px, uint32_t radix, int32_t precision)
   if (zerrat(ptmp))
   {
     destroyrat(ptmp);
-    throw(CALC_E_DOMAIN);
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return;
   }
   divrat(px, ptmp, precision);
 
@@ -283,7 +284,7 @@ void tananglerat(PRAT *pa, AngleType angletype, uint32_t radix, int32_t precisio
       _subrat(pa, rat_180, precision);
     }
     divrat(pa, rat_180, precision);
-    mulrat(pa, pi, precision);
+    mulrat(pa, pi(), precision);
     break;
   case AngleType::Gradians:
     if (rat_gt(*pa, rat_200, precision))
@@ -291,7 +292,7 @@ void tananglerat(PRAT *pa, AngleType angletype, uint32_t radix, int32_t precisio
       _subrat(pa, rat_200, precision);
     }
     divrat(pa, rat_200, precision);
-    mulrat(pa, pi, precision);
+    mulrat(pa, pi(), precision);
     break;
 
   default:
@@ -70,7 +70,8 @@ void _sinhrat(PRAT *px, int32_t precision)
   if (!IsValidForHypFunc(*px, precision))
   {
     // Don't attempt exp of anything large or small
-    throw(CALC_E_DOMAIN);
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return;
   }
 
   CREATETAYLOR();
@@ -149,7 +150,8 @@ void _coshrat(PRAT *px, uint32_t radix, int32_t precision)
   if (!IsValidForHypFunc(*px, precision))
   {
     // Don't attempt exp of anything large or small
-    throw(CALC_E_DOMAIN);
+    RATPAK_THROW(CALC_E_DOMAIN);
+    return;
   }
 
   CREATETAYLOR();
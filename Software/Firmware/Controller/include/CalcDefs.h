@@ -27,3 +27,51 @@ constexpr uint8_t MEM_REGISTER_NONE = 255;
 
 // radix
 constexpr uint32_t RAT_RADIX = 10;
+
+// units of ratpak work between two checks for a cancel key, about 10 ms
+constexpr uint32_t RAT_POLL_INTERVAL = 50000;
+
+// digits a denominator keeps beyond the precision before it is cut
+constexpr int32_t RAT_BOUND_GUARD = 9;
+
+// results of slow operations kept for repeated calculations
+constexpr size_t CALC_CACHE_ENTRIES = 16;
+constexpr uint32_t CALC_CACHE_BYTES = 4096;
+
+// time of the operations in microseconds per unit of work, see CalcMath::estimateTime,
+// replaced by a benchmark at startup
+constexpr float CALC_COST_SERIES = 27.0f;
+constexpr float CALC_COST_LIMB = 0.3f;
+
+// operations estimated to run longer show the busy animation, in ms
+constexpr uint32_t CALC_LONG_OPERATION_TIME = 50;
+
+// limits of the permutation and combination loops
+constexpr int32_t CALC_MAX_PERMUTATIONS = 1000;
+constexpr int32_t CALC_MAX_COMBINATIONS = 5000;
+
+// size of a keystroke program, two bytes per step
+constexpr size_t CALC_PROGRAM_SIZE = 512;
+constexpr size_t CALC_PROGRAM_LITERALS = 64;
+
+// pending operations and parentheses of an algebraic expression
+constexpr size_t CALC_EXPRESSION_DEPTH = 32;
+
+// keys that can be undone, the memory is limited by the undomemory setting
+constexpr size_t CALC_UNDO_SIZE = 32;
+
+// levels below T of the unlimited RPN stack are allocated in chunks,
+// a new level needs this free heap, the web page shows the upper levels
+constexpr size_t CALC_STACK_CHUNK = 16;
+constexpr uint32_t CALC_STACK_HEAP_RESERVE = 32768;
+constexpr size_t CALC_STACK_WEB_LEVELS = 50;
+
+// a result calculated with doubles is shown if its error bound proves
+// this many digits more than the display has
+constexpr uint8_t CALC_CERTIFY_GUARD_DIGITS = 2;
+
+// the root solver iterates with this precision until the root is known to
+// its digits and ends with the full precision, a function evaluation is a run
+// of the program and a solve gives up after this many runs
+constexpr int32_t CALC_SOLVE_LOW_PRECISION = 12;
+constexpr uint32_t CALC_SOLVE_ITERATIONS = 100;
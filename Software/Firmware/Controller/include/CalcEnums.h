@@ -72,9 +72,31 @@ enum class operation : uint8_t
   recall_addition,
   recall_subtracion,
   recall_multiplication,
-  recall_division
+  recall_division,
+  program,             // start or stop recording a program
+  run,                 // run the program
+  test_x_le_y,         // program only, the next step runs if x <= y
+  test_x_eq_0,         // program only, the next step runs if x = 0
+  decrement_skip_zero, // program only, decrement memory 0 and skip the next step at 0
+  goto_start,          // program only, continue with the first step
+  undo,                // go back to the state before the last key
+  redo,                // take back an undo
+  view_down,           // show the next deeper stack level on the display
+  view_up,             // show the next stack level towards X on the display
+  stat_add,            // add the point (x, y) to the statistics
+  stat_subtract,       // remove the point (x, y) from the statistics
+  stat_count,          // number of points
+  stat_mean,           // means of x and y
+  stat_stdev,          // standard deviations of x and y as a sample
+  stat_pop_stdev,      // standard deviations of x and y as the whole population
+  stat_regression,     // intercept and slope of the least squares line
+  stat_correlation,    // correlation coefficient of x and y
+  stat_clear,          // forget the points
+  solve                // root of the program near the guesses in X and Y
 };
 
+constexpr size_t OPERATION_COUNT = static_cast<size_t>(operation::solve) + 1;
+
 #else
 
 enum class operation : uint8_t
@@ -128,8 +150,21 @@ enum class operation : uint8_t
   change_sign,
   decimal_separator,
   clear_error,
+  open_parenthesis,  // operator precedence only
+  close_parenthesis, // operator precedence only
+  undo,              // go back to the state before the last key
+  redo,              // take back an undo
+  stat_add,          // add x to the statistics
+  stat_subtract,     // remove x from the statistics
+  stat_count,        // number of values
+  stat_mean,         // mean of the values
+  stat_stdev,        // standard deviation of the values as a sample
+  stat_pop_stdev,    // standard deviation of the values as the whole population
+  stat_clear,        // forget the values
 };
 
+constexpr size_t OPERATION_COUNT = static_cast<size_t>(operation::stat_clear) + 1;
+
 #endif
 
 // angle types
@@ -138,3 +173,25 @@ enum class angle_type : uint8_t
   deg,
   rad
 };
+
+// operands of a math operation
+enum class op_arity : uint8_t
+{
+  none, // not a math operation, done by the engine
+  zero, // constant
+  one,  // x
+  two   // x and y
+};
+
+// how the running time of a math operation grows, see CalcMath::estimateTime
+enum class op_cost : uint8_t
+{
+  none,          // done by the engine
+  arithmetic,    // product of the operand sizes
+  series,        // cube of the precision
+  trigonometric, // series, large angles are reduced first
+  power,         // series, integer powers are exact and grow with the exponent
+  factorial,     // product of growing integers, gamma series for non-integers
+  permutations,  // product of growing integers
+  combinations   // product of growing integers
+};
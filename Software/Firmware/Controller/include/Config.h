@@ -8,6 +8,7 @@
 #pragma once
 
 #include <HardwareInfo.h>
+#include <SettingEnum.h>
 
 // -------------------------------------------------------------------------------
 // Display type
@@ -37,6 +38,16 @@ constexpr auto DISPLAY_TYPE = display_type::undefined;
 // -------------------------------------------------------------------------------
 #define CALC_TYPE CALC_TYPE_UNDEFINED
 
+// -------------------------------------------------------------------------------
+// Default math backend for transcendental operations
+// -------------------------------------------------------------------------------
+// calc_backend::rational     -> exact rationals
+// calc_backend::binary_float -> binary floating point numbers, faster
+// The basic operations always use exact rationals. The backend can be changed
+// with the calcbackend setting.
+// -------------------------------------------------------------------------------
+constexpr auto CALC_BACKEND = calc_backend::rational;
+
 // -------------------------------------------------------------------------------
 // Calculator access point SSID and password
 // -------------------------------------------------------------------------------
@@ -55,6 +66,10 @@ static_assert(DISPLAY_TYPE == display_type::in12a ||
                   DISPLAY_TYPE == display_type::led,
               "Display type configuration incorrect");
 
+static_assert(CALC_BACKEND == calc_backend::rational ||
+                  CALC_BACKEND == calc_backend::binary_float,
+              "Calculator backend configuration incorrect");
+
 #if CALC_TYPE != CALC_TYPE_RPN && CALC_TYPE != CALC_TYPE_ALG
 #error "CALC_TYPE configuration incorrect"
 #endif
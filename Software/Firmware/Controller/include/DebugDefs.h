@@ -23,4 +23,8 @@
 #define D_write(...)
 #define D_println(...)
 #define D_printf(...)
-#endif
\ No newline at end of file
+#endif
+
+// SET TO 1 TO TIME KEYSTROKE SEQUENCES FROM KEY PRESS TO DISPLAY AT STARTUP,
+// RESULTS ARE PRINTED TO SERIAL AND NEED DEBUG SET TO 1
+#define CALC_BENCHMARK 0
\ No newline at end of file
@@ -52,6 +52,14 @@ const char indexHTML[] PROGMEM = R"rawliteral(
       color: white;
       background-color: indigo;
     }
+
+    .alloc {
+      font-size: 0.8rem;
+    }
+
+    .deep {
+      margin: 0;
+    }
   </style>
   <title>RPN Nixie Calculator Server</title>
   <meta name="viewport" content="width=device-width, initial-scale=1">
@@ -68,6 +76,7 @@ const char indexHTML[] PROGMEM = R"rawliteral(
     <p class="regy">Y: <span id="regy"></span></p>
     <p class="regz">Z: <span id="regz"></span></p>
     <p class="regt">T: <span id="regt"></span></p>
+    <pre class="deep" id="deep"></pre>
     <p class="regl">L: <span id="regl"></span></p>
     <hr>
     <p class="reg0">0: <span id="reg0"></span></p>
@@ -80,6 +89,10 @@ const char indexHTML[] PROGMEM = R"rawliteral(
     <p class="reg7">7: <span id="reg7"></span></p>
     <p class="reg8">8: <span id="reg8"></span></p>
     <p class="reg9">9: <span id="reg9"></span></p>
+    <hr>
+    <pre class="deep" id="stat"></pre>
+    <hr>
+    <pre class="alloc" id="alloc"></pre>
   </div>
   <script>
     var gateway = `ws://${window.location.hostname}/ws`;
@@ -150,6 +163,15 @@ const char indexHTML[] PROGMEM = R"rawliteral(
         case "9:":
           document.getElementById('reg9').innerHTML = message.substring(2);
           break;
+        case "D:":
+          document.getElementById('deep').textContent = message.substring(2);
+          break;
+        case "S:":
+          document.getElementById('stat').textContent = message.substring(2);
+          break;
+        case "A:":
+          document.getElementById('alloc').textContent = message.substring(2);
+          break;
       }
     }
     function onLoad(event) {
@@ -203,6 +225,14 @@ const char indexHTML[] PROGMEM = R"rawliteral(
       color: white;
       background-color: indigo;
     }
+
+    .alloc {
+      font-size: 0.8rem;
+    }
+
+    .deep {
+      margin: 0;
+    }
   </style>
   <title>Nixie Calculator Server</title>
   <meta name="viewport" content="width=device-width, initial-scale=1">
@@ -220,6 +250,10 @@ const char indexHTML[] PROGMEM = R"rawliteral(
     <p class="regt">T: <span id="regt"></span></p>
     <hr>
     <p class="regm">M: <span id="regm"></span></p>
+    <hr>
+    <pre class="deep" id="stat"></pre>
+    <hr>
+    <pre class="alloc" id="alloc"></pre>
   </div>
   <script>
     var gateway = `ws://${window.location.hostname}/ws`;
@@ -257,6 +291,12 @@ const char indexHTML[] PROGMEM = R"rawliteral(
         case "M:":
           document.getElementById('regm').innerHTML = message.substring(2);
           break;
+        case "S:":
+          document.getElementById('stat').textContent = message.substring(2);
+          break;
+        case "A:":
+          document.getElementById('alloc').textContent = message.substring(2);
+          break;
       }
     }
     function onLoad(event) {
@@ -92,7 +92,13 @@ namespace setting_id
     maxexpdigits,    // Max exponent digits
     scrolldelay,     // Interval while scrolling result in 1/10 of seconds
     calcprecision,   // Precision of the calculations
-    brightness       // 7-segment LED brightness
+    brightness,      // 7-segment LED brightness
+    calcbackend,     // Rationals or binary floats for transcendental operations
+    calctimelimit,   // Longest estimated time of a calculation in seconds, 0 = no limit
+    algmode,         // Operator precedence or immediate evaluation in algebraic mode
+    undomemory,      // Memory for undo in KB, 0 = no undo
+    stackmode,       // Four level or unlimited RPN stack
+    fastdouble       // Show doubles with a proven error, the rationals calculate when needed
   };
 }
 
@@ -314,6 +320,43 @@ namespace show_busy_calc
   {
     off,
     moving_decimal_separator,
-    digit_flickering
+    digit_flickering,
+    progressive
+  };
+}
+
+namespace calc_backend
+{
+  enum calc_backend
+  {
+    rational,
+    binary_float
+  };
+}
+
+namespace alg_mode
+{
+  enum alg_mode
+  {
+    immediate,
+    precedence
+  };
+}
+
+namespace stack_mode
+{
+  enum stack_mode
+  {
+    classic,
+    unlimited
+  };
+}
+
+namespace fast_double
+{
+  enum fast_double
+  {
+    off,
+    on
   };
 }
\ No newline at end of file
@@ -0,0 +1,1187 @@
+// BigFloat.hpp
+
+// arbitrary-precision binary floating point numbers
+// alternative backend for the transcendental operations
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <ratpak.h>
+
+// mantissa limbs, least significant limb first
+typedef std::vector<uint32_t> LIMBS;
+
+// the value is mantissa * 2^exponent, the mantissa is a natural number without
+// leading zero limbs, zero has no limbs at all. Results of add, sub, mul, div
+// and sqrt are correctly rounded to nearest (ties to even) at the requested
+// number of bits. The transcendental functions work with guard bits and round
+// once at the end, their error stays below one unit in the last place.
+// Errors are raised like in ratpak, without exceptions the failing function
+// returns zero and the error is pending in the ratpak context.
+class BigFloat
+{
+public:
+  // zero
+  BigFloat() : _neg(false), _exp(0)
+  {
+  }
+
+  // float from an integer, always exact
+  explicit BigFloat(int32_t i) : _neg(i < 0), _exp(0)
+  {
+    uint32_t u = i < 0 ? 0 - static_cast<uint32_t>(i) : static_cast<uint32_t>(i);
+    if (u != 0)
+    {
+      _mant.push_back(u);
+    }
+  }
+
+  // number of bits needed for the given number of decimal digits
+  static uint32_t precisionToBits(int32_t precision)
+  {
+    // log2(10) = 3.3219..., plus one limb to keep the last digit correct
+    return ((static_cast<uint32_t>(precision) * 3402 + 1023) / 1024 + 32);
+  }
+
+  // float from a ratpak rational, rounded to bits
+  static BigFloat fromRat(PRAT p, uint32_t bits)
+  {
+#if RATPAK_DECIMAL_BASE
+    // the BASEX exponents are powers of ten, they go into the numerator or
+    // the denominator as exact factors
+    LIMBS num = fromDigits(p->pp);
+    LIMBS den = fromDigits(p->pq);
+    for (int32_t e = p->pp->exp - p->pq->exp; e != 0; e += (e > 0 ? -1 : 1))
+    {
+      LIMBS &m = (e > 0 ? num : den);
+      m = mulMag(m, LIMBS(1, BASEX));
+      trim(m);
+    }
+    return (div(make(p->pp->sign < 0, num, 0, bitLength(num), false), make(p->pq->sign < 0, den, 0, bitLength(den), false), bits));
+#else
+    BigFloat num = fromNum(p->pp);
+    BigFloat den = fromNum(p->pq);
+    return (div(num, den, bits));
+#endif
+  }
+
+  // float from a double, always exact, infinity and NaN give zero
+  static BigFloat fromDouble(double d)
+  {
+    if (!std::isfinite(d) || d == 0)
+    {
+      return (BigFloat());
+    }
+    int e;
+    uint64_t m = static_cast<uint64_t>(std::ldexp(std::frexp(std::fabs(d), &e), 53));
+    return (make(d < 0, LIMBS{static_cast<uint32_t>(m), static_cast<uint32_t>(m >> 32)}, e - 53, 53, false));
+  }
+
+  // nearest double, beyond its range the result is infinity or zero
+  double toDouble() const
+  {
+    BigFloat r = round(*this, 53);
+    double d = 0;
+    for (size_t i = r._mant.size(); i-- > 0;)
+    {
+      d = d * 4294967296.0 + r._mant[i];
+    }
+    d = std::ldexp(d, r._exp);
+    return (r._neg ? -d : d);
+  }
+
+  // exact ratpak rational from the float, the denominator is a power of two
+  PRAT toRat() const
+  {
+#if RATPAK_DECIMAL_BASE
+    // a negative binary exponent becomes the denominator 2^-exp
+    PRAT p = nullptr;
+    createrat(p);
+    p->cshare = 0;
+    p->pp = toDigits(_exp > 0 ? shl(_mant, static_cast<uint32_t>(_exp)) : _mant);
+    p->pp->sign = _neg ? -1 : 1;
+    p->pq = toDigits(shl(LIMBS(1, 1), static_cast<uint32_t>(_exp < 0 ? -_exp : 0)));
+    p->pq->sign = 1;
+    return (p);
+#else
+    // split the binary exponent into BASEX digits and a remaining shift
+    int32_t q = floorDiv(_exp, BASEXPWR);
+    uint32_t r = static_cast<uint32_t>(_exp - q * static_cast<int32_t>(BASEXPWR));
+    LIMBS m = shl(_mant, r);
+
+    PRAT p = nullptr;
+    createrat(p);
+    p->cshare = 0;
+    p->pp = toNum(m, q > 0 ? q : 0);
+    p->pp->sign = _neg ? -1 : 1;
+    p->pq = _createnum(1);
+    p->pq->sign = 1;
+    p->pq->cdigit = 1;
+    p->pq->exp = q < 0 ? -q : 0;
+    p->pq->mant[0] = 1;
+    return (p);
+#endif
+  }
+
+  bool isZero() const
+  {
+    return (_mant.empty());
+  }
+
+  bool isNegative() const
+  {
+    return (_neg);
+  }
+
+  // position of the highest bit, the magnitude is in [2^(n-1), 2^n)
+  int32_t magnitude() const
+  {
+    return (_exp + static_cast<int32_t>(bitLength(_mant)));
+  }
+
+  // true if the value is exactly one
+  bool isOne() const
+  {
+    return (!_neg && _exp == 0 && _mant.size() == 1 && _mant[0] == 1);
+  }
+
+  // nearest integer, only valid for values that fit into an int32_t
+  int32_t toInt() const
+  {
+    BigFloat r = nearestInt(*this);
+    if (r.isZero())
+    {
+      return (0);
+    }
+    int32_t i = static_cast<int32_t>(r._mant[0] << r._exp);
+    return (r._neg ? -i : i);
+  }
+
+  // change sign
+  void negate()
+  {
+    if (!isZero())
+    {
+      _neg = !_neg;
+    }
+  }
+
+  // multiply by 2^n, always exact
+  void scale(int32_t n)
+  {
+    if (!isZero())
+    {
+      _exp += n;
+      if (!checkRange(_exp))
+      {
+        *this = BigFloat();
+      }
+    }
+  }
+
+  // round to bits
+  static BigFloat round(const BigFloat &a, uint32_t bits)
+  {
+    return (make(a._neg, a._mant, a._exp, bits, false));
+  }
+
+  // nearest integer, ties to even
+  static BigFloat nearestInt(const BigFloat &a)
+  {
+    if (a.magnitude() <= 0)
+    {
+      BigFloat half(1);
+      half.scale(-1);
+      return (cmpAbs(a, half) > 0 ? BigFloat(a._neg ? -1 : 1) : BigFloat());
+    }
+    return (round(a, static_cast<uint32_t>(a.magnitude())));
+  }
+
+  static BigFloat add(const BigFloat &a, const BigFloat &b, uint32_t bits)
+  {
+    if (a.isZero())
+    {
+      return (round(b, bits));
+    }
+    if (b.isZero())
+    {
+      return (round(a, bits));
+    }
+
+    const BigFloat &l = a.magnitude() >= b.magnitude() ? a : b;
+    const BigFloat &s = a.magnitude() >= b.magnitude() ? b : a;
+
+    // if the smaller operand is far below the rounding position, only its
+    // leading bits and a sticky bit are needed for correct rounding
+    int32_t cut = l.magnitude() - static_cast<int32_t>(bits) - 8;
+    if (cut > l._exp)
+    {
+      cut = l._exp;
+    }
+    if ((l.magnitude() - s.magnitude() > 2) && (s._exp < cut))
+    {
+      bool sticky = false;
+      LIMBS sm = shr(s._mant, static_cast<uint32_t>(cut - s._exp), &sticky);
+      LIMBS lm = shl(l._mant, static_cast<uint32_t>(l._exp - cut));
+      LIMBS m;
+      if (l._neg == s._neg)
+      {
+        m = addMag(lm, sm);
+      }
+      else
+      {
+        m = subMag(lm, sm);
+        // the true sum is slightly smaller than m, step down one unit
+        if (sticky)
+        {
+          m = subMag(m, LIMBS(1, 1));
+        }
+      }
+      return (make(l._neg, m, cut, bits, sticky));
+    }
+
+    // exact sum
+    int32_t e = a._exp < b._exp ? a._exp : b._exp;
+    LIMBS am = shl(a._mant, static_cast<uint32_t>(a._exp - e));
+    LIMBS bm = shl(b._mant, static_cast<uint32_t>(b._exp - e));
+    if (a._neg == b._neg)
+    {
+      return (make(a._neg, addMag(am, bm), e, bits, false));
+    }
+    int c = cmpMag(am, bm);
+    if (c == 0)
+    {
+      return (BigFloat());
+    }
+    if (c > 0)
+    {
+      return (make(a._neg, subMag(am, bm), e, bits, false));
+    }
+    return (make(b._neg, subMag(bm, am), e, bits, false));
+  }
+
+  static BigFloat sub(const BigFloat &a, const BigFloat &b, uint32_t bits)
+  {
+    BigFloat n = b;
+    n.negate();
+    return (add(a, n, bits));
+  }
+
+  static BigFloat mul(const BigFloat &a, const BigFloat &b, uint32_t bits)
+  {
+    if (a.isZero() || b.isZero())
+    {
+      return (BigFloat());
+    }
+    return (make(a._neg != b._neg, mulMag(a._mant, b._mant), a._exp + b._exp, bits, false));
+  }
+
+  static BigFloat div(const BigFloat &a, const BigFloat &b, uint32_t bits)
+  {
+    if (b.isZero())
+    {
+      RATPAK_THROW(CALC_E_DIVIDEBYZERO);
+      return (BigFloat());
+    }
+    if (a.isZero())
+    {
+      return (BigFloat());
+    }
+    // two more quotient bits than needed, the remainder is the sticky bit
+    int32_t s = static_cast<int32_t>(bits + 3 + bitLength(b._mant)) - static_cast<int32_t>(bitLength(a._mant));
+    if (s < 0)
+    {
+      s = 0;
+    }
+    LIMBS q;
+    LIMBS r;
+    divMag(shl(a._mant, static_cast<uint32_t>(s)), b._mant, q, r);
+    return (make(a._neg != b._neg, q, a._exp - b._exp - s, bits, !r.empty()));
+  }
+
+  // division by a small integer
+  static BigFloat div(const BigFloat &a, uint32_t n, uint32_t bits)
+  {
+    BigFloat b;
+    b._mant.push_back(n);
+    return (div(a, b, bits));
+  }
+
+  // square root
+  static BigFloat sqrt(const BigFloat &a, uint32_t bits)
+  {
+    if (a._neg)
+    {
+      RATPAK_THROW(CALC_E_DOMAIN);
+      return (BigFloat());
+    }
+    if (a.isZero())
+    {
+      return (BigFloat());
+    }
+    // the radicand needs twice the bits of the root and an even exponent
+    int32_t s = static_cast<int32_t>(2 * (bits + 2)) - static_cast<int32_t>(bitLength(a._mant)) + 1;
+    if (s < 0)
+    {
+      s = 0;
+    }
+    if (((a._exp - s) & 1) != 0)
+    {
+      s++;
+    }
+    LIMBS n = shl(a._mant, static_cast<uint32_t>(s));
+    LIMBS r = isqrt(n);
+    bool sticky = cmpMag(mulMag(r, r), n) != 0;
+    return (make(false, r, (a._exp - s) / 2, bits, sticky));
+  }
+
+  // ln(2)
+  static BigFloat ln2(uint32_t bits)
+  {
+    // cached, rounded down to the requested precision on use
+    static BigFloat _ln2;
+    static uint32_t _ln2Bits = 0;
+    if (_ln2Bits < bits)
+    {
+      // ln(2) = 2 * atanh(1/3)
+      uint32_t wp = bits + 16;
+      BigFloat z = div(BigFloat(1), 3, wp);
+      BigFloat z2 = div(BigFloat(1), 9, wp);
+      _ln2 = atanhSeries(z, z2, wp);
+      _ln2.scale(1);
+      _ln2Bits = bits;
+    }
+    return (round(_ln2, bits));
+  }
+
+  // pi
+  static BigFloat pi(uint32_t bits)
+  {
+    // cached, rounded down to the requested precision on use
+    static BigFloat _pi;
+    static uint32_t _piBits = 0;
+    if (_piBits < bits)
+    {
+      // Machin: pi = 16 * atan(1/5) - 4 * atan(1/239)
+      uint32_t wp = bits + 16;
+      BigFloat a = atanInv(5, wp);
+      a.scale(2);
+      BigFloat b = atanInv(239, wp);
+      _pi = sub(a, b, wp);
+      _pi.scale(2);
+      _piBits = bits;
+    }
+    return (round(_pi, bits));
+  }
+
+  // e^x
+  static BigFloat exp(const BigFloat &x, uint32_t bits)
+  {
+    if (x.isZero())
+    {
+      return (BigFloat(1));
+    }
+    if (x.magnitude() > MAX_MAGNITUDE_BITS)
+    {
+      if (x._neg)
+      {
+        return (BigFloat());
+      }
+      RATPAK_THROW(CALC_E_OVERFLOW);
+      return (BigFloat());
+    }
+
+    // x = k * ln(2) + r, |r| <= ln(2) / 2
+    uint32_t wp = bits + 32;
+    int32_t k = div(x, ln2(64), 64).toInt();
+    BigFloat r = x;
+    if (k != 0)
+    {
+      uint32_t kp = wp + 32;
+      r = sub(x, mul(BigFloat(k), ln2(kp), kp), wp);
+    }
+
+    // e^r = (e^(r / 2^s))^(2^s), the small argument lets the series converge fast
+    const int32_t s = 8;
+    r.scale(-s);
+    r = round(r, wp);
+    BigFloat sum(1);
+    BigFloat term(1);
+    for (uint32_t i = 1; !term.isZero() && term.magnitude() > -static_cast<int32_t>(wp); i++)
+    {
+      term = div(mul(term, r, wp), i, wp);
+      sum = add(sum, term, wp);
+    }
+    for (int32_t i = 0; i < s; i++)
+    {
+      sum = mul(sum, sum, wp);
+    }
+    sum.scale(k);
+    return (round(sum, bits));
+  }
+
+  // natural logarithm
+  static BigFloat ln(const BigFloat &x, uint32_t bits)
+  {
+    if (x._neg || x.isZero())
+    {
+      RATPAK_THROW(CALC_E_DOMAIN);
+      return (BigFloat());
+    }
+    if (x.isOne())
+    {
+      return (BigFloat());
+    }
+
+    // x = m * 2^e, m in [0.75, 1.5)
+    uint32_t wp = bits + 32;
+    int32_t e = x.magnitude();
+    BigFloat m = x;
+    m.scale(-e);
+    if (!testBit(m._mant, bitLength(m._mant) - 2))
+    {
+      m.scale(1);
+      e--;
+    }
+
+    // ln(m) = 2 * atanh((m - 1) / (m + 1))
+    uint32_t mp = wp + bitLength(m._mant);
+    BigFloat z = div(sub(m, BigFloat(1), mp), add(m, BigFloat(1), mp), wp);
+    BigFloat sum = atanhSeries(z, mul(z, z, wp), wp);
+    sum.scale(1);
+    if (e != 0)
+    {
+      sum = add(sum, mul(BigFloat(e), ln2(wp + 32), wp + 32), wp);
+    }
+    return (round(sum, bits));
+  }
+
+  // sine of an angle in radians
+  static BigFloat sin(const BigFloat &x, uint32_t bits)
+  {
+    BigFloat s;
+    BigFloat c;
+    sinCos(x, bits + 8, &s, &c);
+    return (round(s, bits));
+  }
+
+  // cosine of an angle in radians
+  static BigFloat cos(const BigFloat &x, uint32_t bits)
+  {
+    BigFloat s;
+    BigFloat c;
+    sinCos(x, bits + 8, &s, &c);
+    return (round(c, bits));
+  }
+
+  // tangent of an angle in radians
+  static BigFloat tan(const BigFloat &x, uint32_t bits)
+  {
+    BigFloat s;
+    BigFloat c;
+    sinCos(x, bits + 8, &s, &c);
+    return (div(s, c, bits));
+  }
+
+  // arctangent in radians
+  static BigFloat atan(const BigFloat &x, uint32_t bits)
+  {
+    if (x.isZero())
+    {
+      return (BigFloat());
+    }
+    uint32_t wp = bits + 32;
+    BigFloat a = x;
+    a._neg = false;
+    bool inverted = a.magnitude() > 1;
+    if (inverted)
+    {
+      // atan(x) = pi / 2 - atan(1 / x)
+      a = div(BigFloat(1), a, wp);
+    }
+
+    // atan(x) = 2 * atan(x / (1 + sqrt(1 + x^2))), three times
+    const int32_t halvings = 3;
+    for (int32_t i = 0; i < halvings; i++)
+    {
+      BigFloat w = sqrt(add(BigFloat(1), mul(a, a, wp), wp), wp);
+      a = div(a, add(BigFloat(1), w, wp), wp);
+    }
+
+    // x - x^3 / 3 + x^5 / 5 - ...
+    BigFloat a2 = mul(a, a, wp);
+    a2.negate();
+    BigFloat sum = a;
+    BigFloat power = a;
+    for (uint32_t i = 3; !power.isZero() && power.magnitude() > sum.magnitude() - static_cast<int32_t>(wp); i += 2)
+    {
+      power = mul(power, a2, wp);
+      sum = add(sum, div(power, i, wp), wp);
+    }
+    sum.scale(halvings);
+
+    if (inverted)
+    {
+      BigFloat p = pi(wp);
+      p.scale(-1);
+      sum = sub(p, sum, wp);
+    }
+    if (x._neg)
+    {
+      sum.negate();
+    }
+    return (round(sum, bits));
+  }
+
+  // arcsine in radians
+  static BigFloat asin(const BigFloat &x, uint32_t bits)
+  {
+    uint32_t wp = bits + 16;
+    BigFloat one(1);
+    BigFloat a = x;
+    a._neg = false;
+    int c = cmpAbs(a, one);
+    if (c > 0)
+    {
+      RATPAK_THROW(CALC_E_DOMAIN);
+      return (BigFloat());
+    }
+    if (c == 0)
+    {
+      BigFloat p = pi(bits);
+      p.scale(-1);
+      p._neg = x._neg;
+      return (p);
+    }
+    // asin(x) = atan(x / sqrt((1 - x) * (1 + x)))
+    BigFloat w = sqrt(mul(sub(one, x, wp), add(one, x, wp), wp), wp);
+    return (atan(div(x, w, wp), bits));
+  }
+
+  // arccosine in radians
+  static BigFloat acos(const BigFloat &x, uint32_t bits)
+  {
+    uint32_t wp = bits + 16;
+    BigFloat one(1);
+    int c = cmpAbs(x, one);
+    if (c > 0)
+    {
+      RATPAK_THROW(CALC_E_DOMAIN);
+      return (BigFloat());
+    }
+    if (c == 0 && x._neg)
+    {
+      return (pi(bits));
+    }
+    // acos(x) = 2 * atan(sqrt((1 - x) / (1 + x)))
+    BigFloat w = sqrt(div(sub(one, x, wp), add(one, x, wp), wp), wp);
+    BigFloat a = atan(w, wp);
+    a.scale(1);
+    return (round(a, bits));
+  }
+
+  // hyperbolic sine
+  static BigFloat sinh(const BigFloat &x, uint32_t bits)
+  {
+    uint32_t wp = bits + 16;
+    if (x.magnitude() <= 0)
+    {
+      // small arguments, x + x^3 / 3! + x^5 / 5! + ... avoids cancellation
+      BigFloat x2 = mul(x, x, wp);
+      BigFloat sum = x;
+      BigFloat term = x;
+      for (uint32_t i = 2; !term.isZero() && term.magnitude() > sum.magnitude() - static_cast<int32_t>(wp); i += 2)
+      {
+        term = div(mul(term, x2, wp), i * (i + 1), wp);
+        sum = add(sum, term, wp);
+      }
+      return (round(sum, bits));
+    }
+    // (e^x - e^-x) / 2
+    BigFloat e = exp(x, wp);
+    BigFloat r = sub(e, div(BigFloat(1), e, wp), wp);
+    r.scale(-1);
+    return (round(r, bits));
+  }
+
+  // hyperbolic cosine
+  static BigFloat cosh(const BigFloat &x, uint32_t bits)
+  {
+    // (e^x + e^-x) / 2
+    uint32_t wp = bits + 16;
+    BigFloat e = exp(x, wp);
+    BigFloat r = add(e, div(BigFloat(1), e, wp), wp);
+    r.scale(-1);
+    return (round(r, bits));
+  }
+
+  // hyperbolic tangent
+  static BigFloat tanh(const BigFloat &x, uint32_t bits)
+  {
+    uint32_t wp = bits + 16;
+    if (x.magnitude() <= 0)
+    {
+      // sinh(x) / sqrt(1 + sinh(x)^2)
+      BigFloat s = sinh(x, wp);
+      return (div(s, sqrt(add(BigFloat(1), mul(s, s, wp), wp), wp), bits));
+    }
+    // 1 - 2 / (e^2|x| + 1), the result is 1 if e^2|x| is out of range
+    BigFloat a = x;
+    a._neg = false;
+    a.scale(1);
+    BigFloat r(1);
+    if (a.magnitude() <= MAX_MAGNITUDE_BITS)
+    {
+      BigFloat t = div(BigFloat(2), add(exp(a, wp), BigFloat(1), wp), wp);
+      r = sub(r, t, wp);
+    }
+    r._neg = x._neg;
+    return (round(r, bits));
+  }
+
+  // y^x, y has to be positive
+  static BigFloat pow(const BigFloat &y, const BigFloat &x, uint32_t bits)
+  {
+    if (y.isOne() || x.isZero())
+    {
+      return (BigFloat(1));
+    }
+    // e^(x * ln(y)), the error of ln(y) grows with the size of the product
+    uint32_t wp = bits + 16;
+    BigFloat t = mul(x, ln(y, wp), wp);
+    if (t.magnitude() > 0)
+    {
+      wp += static_cast<uint32_t>(t.magnitude() < MAX_MAGNITUDE_BITS ? t.magnitude() : MAX_MAGNITUDE_BITS);
+      t = mul(x, ln(y, wp), wp);
+    }
+    return (exp(t, bits));
+  }
+
+private:
+  // values beyond 2^(2^24) are treated as overflow
+  static constexpr int32_t MAX_MAGNITUDE_BITS = 24;
+  static constexpr int32_t MAX_EXPONENT = 1L << MAX_MAGNITUDE_BITS;
+
+  bool _neg;
+  int32_t _exp;
+  LIMBS _mant;
+
+  // rounds the exact value (-1)^neg * m * 2^e to bits, sticky tells that
+  // the true value is slightly larger than m * 2^e
+  static BigFloat make(bool neg, LIMBS m, int32_t e, uint32_t bits, bool sticky)
+  {
+    BigFloat r;
+    trim(m);
+    if (m.empty())
+    {
+      return (r);
+    }
+    uint32_t len = bitLength(m);
+    if (len > bits)
+    {
+      uint32_t shift = len - bits;
+      bool half = testBit(m, shift - 1);
+      bool rest = sticky || anyBelow(m, shift - 1);
+      m = shr(m, shift, nullptr);
+      e += static_cast<int32_t>(shift);
+      if (half && (rest || (m[0] & 1) != 0))
+      {
+        m = addMag(m, LIMBS(1, 1));
+        if (bitLength(m) > bits)
+        {
+          m = shr(m, 1, nullptr);
+          e++;
+        }
+      }
+    }
+    // drop trailing zero bits, every value has a single representation
+    uint32_t z = 0;
+    while (m[z / 32] == 0)
+    {
+      z += 32;
+    }
+    z += __builtin_ctz(m[z / 32]);
+    if (z > 0)
+    {
+      m = shr(m, z, nullptr);
+      e += static_cast<int32_t>(z);
+    }
+    if (!checkRange(e + static_cast<int32_t>(bitLength(m))))
+    {
+      return (r);
+    }
+    r._neg = neg;
+    r._exp = e;
+    r._mant = std::move(m);
+    return (r);
+  }
+
+  // false if the exponent is out of range, the result is zero then
+  static bool checkRange(int32_t e)
+  {
+    if (e > MAX_EXPONENT || e < -MAX_EXPONENT)
+    {
+      RATPAK_THROW(CALC_E_OVERFLOW);
+      return (false);
+    }
+    return (true);
+  }
+
+  static int32_t floorDiv(int32_t a, int32_t b)
+  {
+    int32_t q = a / b;
+    return ((a % b != 0 && a < 0) ? q - 1 : q);
+  }
+
+  static int cmpAbs(const BigFloat &a, const BigFloat &b)
+  {
+    if (a.magnitude() != b.magnitude())
+    {
+      return (a.magnitude() < b.magnitude() ? -1 : 1);
+    }
+    int32_t e = a._exp < b._exp ? a._exp : b._exp;
+    return (cmpMag(shl(a._mant, static_cast<uint32_t>(a._exp - e)), shl(b._mant, static_cast<uint32_t>(b._exp - e))));
+  }
+
+#if RATPAK_DECIMAL_BASE
+  // natural number from the mantissa of a ratpak number, without the exponent
+  static LIMBS fromDigits(PNUMBER pnum)
+  {
+    LIMBS m;
+    for (int32_t i = pnum->cdigit - 1; i >= 0; i--)
+    {
+      uint64_t carry = pnum->mant[i];
+      for (uint32_t &limb : m)
+      {
+        carry += static_cast<uint64_t>(limb) * BASEX;
+        limb = static_cast<uint32_t>(carry);
+        carry >>= 32;
+      }
+      if (carry != 0)
+      {
+        m.push_back(static_cast<uint32_t>(carry));
+      }
+    }
+    return (m);
+  }
+
+  // ratpak integer from a natural number
+  static PNUMBER toDigits(LIMBS m)
+  {
+    std::vector<MANTTYPE> digits;
+    trim(m);
+    do
+    {
+      uint64_t rem = 0;
+      for (size_t i = m.size(); i-- > 0;)
+      {
+        uint64_t cur = (rem << 32) | m[i];
+        m[i] = static_cast<uint32_t>(cur / BASEX);
+        rem = cur % BASEX;
+      }
+      trim(m);
+      digits.push_back(static_cast<MANTTYPE>(rem));
+    } while (!m.empty());
+    PNUMBER pnum = _createnum(static_cast<uint32_t>(digits.size()));
+    pnum->cdigit = static_cast<int32_t>(digits.size());
+    pnum->exp = 0;
+    std::copy(digits.begin(), digits.end(), pnum->mant);
+    return (pnum);
+  }
+#else
+  // exact float from a ratpak number
+  static BigFloat fromNum(PNUMBER pnum)
+  {
+    BigFloat r;
+    uint32_t bits = static_cast<uint32_t>(pnum->cdigit) * BASEXPWR;
+    r._mant.assign((bits + 31) / 32 + 1, 0);
+    for (int32_t i = 0; i < pnum->cdigit; i++)
+    {
+      uint32_t pos = static_cast<uint32_t>(i) * BASEXPWR;
+      uint64_t d = static_cast<uint64_t>(pnum->mant[i]) << (pos % 32);
+      r._mant[pos / 32] |= static_cast<uint32_t>(d);
+      r._mant[pos / 32 + 1] |= static_cast<uint32_t>(d >> 32);
+    }
+    trim(r._mant);
+    r._neg = pnum->sign < 0 && !r._mant.empty();
+    r._exp = pnum->exp * static_cast<int32_t>(BASEXPWR);
+    return (r);
+  }
+
+  // ratpak number from a natural number, exp in BASEX digits
+  static PNUMBER toNum(const LIMBS &m, int32_t exp)
+  {
+    uint32_t count = (bitLength(m) + BASEXPWR - 1) / BASEXPWR;
+    if (count == 0)
+    {
+      count = 1;
+    }
+    PNUMBER pnum = _createnum(count);
+    pnum->cdigit = static_cast<int32_t>(count);
+    pnum->exp = exp;
+    for (uint32_t i = 0; i < count; i++)
+    {
+      uint32_t pos = i * BASEXPWR;
+      uint64_t d = m.size() > pos / 32 ? m[pos / 32] : 0;
+      if (m.size() > pos / 32 + 1)
+      {
+        d |= static_cast<uint64_t>(m[pos / 32 + 1]) << 32;
+      }
+      pnum->mant[i] = static_cast<MANTTYPE>((d >> (pos % 32)) & (BASEX - 1));
+    }
+    return (pnum);
+  }
+#endif
+
+  // atanh series z + z^3 / 3 + z^5 / 5 + ..., z2 = z^2
+  static BigFloat atanhSeries(const BigFloat &z, const BigFloat &z2, uint32_t wp)
+  {
+    BigFloat sum = z;
+    BigFloat power = z;
+    for (uint32_t i = 3; !power.isZero() && power.magnitude() > sum.magnitude() - static_cast<int32_t>(wp); i += 2)
+    {
+      power = mul(power, z2, wp);
+      sum = add(sum, div(power, i, wp), wp);
+    }
+    return (sum);
+  }
+
+  // atan(1 / n) for an integer n > 1
+  static BigFloat atanInv(uint32_t n, uint32_t wp)
+  {
+    BigFloat power = div(BigFloat(1), n, wp);
+    BigFloat sum = power;
+    uint32_t n2 = n * n;
+    bool negative = true;
+    for (uint32_t i = 3; power.magnitude() > sum.magnitude() - static_cast<int32_t>(wp); i += 2)
+    {
+      power = div(power, n2, wp);
+      BigFloat term = div(power, i, wp);
+      sum = negative ? sub(sum, term, wp) : add(sum, term, wp);
+      negative = !negative;
+    }
+    return (sum);
+  }
+
+  // sine and cosine of an angle in radians
+  static void sinCos(const BigFloat &x, uint32_t bits, BigFloat *ps, BigFloat *pc)
+  {
+    uint32_t wp = bits + 16;
+
+    // x = k * pi / 2 + r, |r| <= pi / 4
+    BigFloat r = x;
+    int32_t quadrant = 0;
+    if (x.magnitude() > 0)
+    {
+      uint32_t kp = wp + static_cast<uint32_t>(x.magnitude()) + 16;
+      BigFloat halfPi = pi(kp);
+      halfPi.scale(-1);
+      BigFloat k = nearestInt(div(x, halfPi, static_cast<uint32_t>(x.magnitude()) + 8));
+      r = sub(x, mul(k, halfPi, kp), wp);
+      // k modulo 4 from the two lowest integer bits
+      if (!k.isZero() && k._exp <= 1)
+      {
+        quadrant = static_cast<int32_t>((k._mant[0] << k._exp) & 3);
+        if (k._neg)
+        {
+          quadrant = (4 - quadrant) & 3;
+        }
+      }
+    }
+
+    // Taylor series for both
+    BigFloat r2 = mul(r, r, wp);
+    r2.negate();
+    BigFloat s = r;
+    BigFloat c(1);
+    BigFloat term = r;
+    for (uint32_t i = 2; !term.isZero() && term.magnitude() > -static_cast<int32_t>(wp); i += 2)
+    {
+      term = div(mul(term, r2, wp), i * (i + 1), wp);
+      s = add(s, term, wp);
+    }
+    term = BigFloat(1);
+    for (uint32_t i = 1; !term.isZero() && term.magnitude() > -static_cast<int32_t>(wp); i += 2)
+    {
+      term = div(mul(term, r2, wp), i * (i + 1), wp);
+      c = add(c, term, wp);
+    }
+
+    switch (quadrant)
+    {
+    case 1:
+      std::swap(s, c);
+      c.negate();
+      break;
+    case 2:
+      s.negate();
+      c.negate();
+      break;
+    case 3:
+      std::swap(s, c);
+      s.negate();
+      break;
+    default:
+      break;
+    }
+    *ps = round(s, bits);
+    *pc = round(c, bits);
+  }
+
+  // natural number helpers
+
+  static void trim(LIMBS &m)
+  {
+    while (!m.empty() && m.back() == 0)
+    {
+      m.pop_back();
+    }
+  }
+
+  static uint32_t bitLength(const LIMBS &m)
+  {
+    if (m.empty())
+    {
+      return (0);
+    }
+    return (static_cast<uint32_t>(32 * m.size()) - __builtin_clz(m.back()));
+  }
+
+  static bool testBit(const LIMBS &m, uint32_t n)
+  {
+    return (n / 32 < m.size() && ((m[n / 32] >> (n % 32)) & 1) != 0);
+  }
+
+  // true if any bit below bit n is set
+  static bool anyBelow(const LIMBS &m, uint32_t n)
+  {
+    for (uint32_t i = 0; i < n / 32 && i < m.size(); i++)
+    {
+      if (m[i] != 0)
+      {
+        return (true);
+      }
+    }
+    return ((n % 32 != 0) && (n / 32 < m.size()) && (m[n / 32] & ((1UL << (n % 32)) - 1)) != 0);
+  }
+
+  static int cmpMag(const LIMBS &a, const LIMBS &b)
+  {
+    if (a.size() != b.size())
+    {
+      return (a.size() < b.size() ? -1 : 1);
+    }
+    for (size_t i = a.size(); i-- > 0;)
+    {
+      if (a[i] != b[i])
+      {
+        return (a[i] < b[i] ? -1 : 1);
+      }
+    }
+    return (0);
+  }
+
+  static LIMBS shl(const LIMBS &a, uint32_t n)
+  {
+    if (a.empty())
+    {
+      return (a);
+    }
+    uint32_t limbs = n / 32;
+    uint32_t bits = n % 32;
+    LIMBS r(a.size() + limbs + 1, 0);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+      uint64_t d = static_cast<uint64_t>(a[i]) << bits;
+      r[i + limbs] |= static_cast<uint32_t>(d);
+      r[i + limbs + 1] |= static_cast<uint32_t>(d >> 32);
+    }
+    trim(r);
+    return (r);
+  }
+
+  // shift right, sticky is set if a nonzero bit was shifted out
+  static LIMBS shr(const LIMBS &a, uint32_t n, bool *sticky)
+  {
+    if (sticky != nullptr)
+    {
+      *sticky = anyBelow(a, n);
+    }
+    uint32_t limbs = n / 32;
+    uint32_t bits = n % 32;
+    if (limbs >= a.size())
+    {
+      return (LIMBS());
+    }
+    LIMBS r(a.size() - limbs, 0);
+    for (size_t i = 0; i < r.size(); i++)
+    {
+      uint64_t d = a[i + limbs];
+      if (i + limbs + 1 < a.size())
+      {
+        d |= static_cast<uint64_t>(a[i + limbs + 1]) << 32;
+      }
+      r[i] = static_cast<uint32_t>(d >> bits);
+    }
+    trim(r);
+    return (r);
+  }
+
+  static LIMBS addMag(const LIMBS &a, const LIMBS &b)
+  {
+    const LIMBS &l = a.size() >= b.size() ? a : b;
+    const LIMBS &s = a.size() >= b.size() ? b : a;
+    LIMBS r(l.size() + 1, 0);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < l.size(); i++)
+    {
+      carry += static_cast<uint64_t>(l[i]) + (i < s.size() ? s[i] : 0);
+      r[i] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    r[l.size()] = static_cast<uint32_t>(carry);
+    trim(r);
+    return (r);
+  }
+
+  // a - b, a has to be greater or equal b
+  static LIMBS subMag(const LIMBS &a, const LIMBS &b)
+  {
+    LIMBS r(a.size(), 0);
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+      int64_t d = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+      borrow = d < 0 ? 1 : 0;
+      r[i] = static_cast<uint32_t>(d);
+    }
+    trim(r);
+    return (r);
+  }
+
+  static LIMBS mulMag(const LIMBS &a, const LIMBS &b)
+  {
+    LIMBS r(a.size() + b.size(), 0);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+      uint64_t carry = 0;
+      for (size_t j = 0; j < b.size(); j++)
+      {
+        carry += static_cast<uint64_t>(a[i]) * b[j] + r[i + j];
+        r[i + j] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+      }
+      r[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+    trim(r);
+    return (r);
+  }
+
+  // q = u / v, r = u % v, Knuth's algorithm D
+  static void divMag(const LIMBS &u, const LIMBS &v, LIMBS &q, LIMBS &r)
+  {
+    if (cmpMag(u, v) < 0)
+    {
+      q.clear();
+      r = u;
+      return;
+    }
+    size_t n = v.size();
+    size_t m = u.size();
+    if (n == 1)
+    {
+      uint64_t k = 0;
+      q.assign(m, 0);
+      for (size_t j = m; j-- > 0;)
+      {
+        uint64_t t = (k << 32) | u[j];
+        q[j] = static_cast<uint32_t>(t / v[0]);
+        k = t % v[0];
+      }
+      trim(q);
+      r.clear();
+      if (k != 0)
+      {
+        r.push_back(static_cast<uint32_t>(k));
+      }
+      return;
+    }
+
+    // normalize so that the top bit of the divisor is set
+    uint32_t s = __builtin_clz(v[n - 1]);
+    LIMBS vn = shl(v, s);
+    LIMBS un = shl(u, s);
+    un.resize(m + 1, 0);
+    q.assign(m - n + 1, 0);
+    const uint64_t b = 1ULL << 32;
+    for (size_t j = m - n + 1; j-- > 0;)
+    {
+      uint64_t num = (static_cast<uint64_t>(un[j + n]) << 32) | un[j + n - 1];
+      uint64_t qhat = num / vn[n - 1];
+      uint64_t rhat = num % vn[n - 1];
+      while (qhat >= b || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]))
+      {
+        qhat--;
+        rhat += vn[n - 1];
+        if (rhat >= b)
+        {
+          break;
+        }
+      }
+
+      // multiply and subtract
+      int64_t borrow = 0;
+      int64_t t;
+      for (size_t i = 0; i < n; i++)
+      {
+        uint64_t p = qhat * vn[i];
+        t = static_cast<int64_t>(un[i + j]) - borrow - static_cast<int64_t>(p & 0xFFFFFFFFULL);
+        un[i + j] = static_cast<uint32_t>(t);
+        borrow = static_cast<int64_t>(p >> 32) - (t >> 32);
+      }
+      t = static_cast<int64_t>(un[j + n]) - borrow;
+      un[j + n] = static_cast<uint32_t>(t);
+
+      // subtracted too much, add back
+      if (t < 0)
+      {
+        qhat--;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+          carry += static_cast<uint64_t>(un[i + j]) + vn[i];
+          un[i + j] = static_cast<uint32_t>(carry);
+          carry >>= 32;
+        }
+        un[j + n] += static_cast<uint32_t>(carry);
+      }
+      q[j] = static_cast<uint32_t>(qhat);
+    }
+    trim(q);
+    trim(un);
+    r = shr(un, s, nullptr);
+  }
+
+  // floor(sqrt(n)) by Newton's method, starting above the root
+  static LIMBS isqrt(const LIMBS &n)
+  {
+    LIMBS x = shl(LIMBS(1, 1), (bitLength(n) + 1) / 2);
+    while (true)
+    {
+      LIMBS q;
+      LIMBS r;
+      divMag(n, x, q, r);
+      LIMBS y = shr(addMag(x, q), 1, nullptr);
+      if (cmpMag(y, x) >= 0)
+      {
+        return (x);
+      }
+      x = std::move(y);
+    }
+  }
+};
@@ -0,0 +1,114 @@
+// CalcBenchmark.hpp
+
+// keystroke sequences to time the calculator from key press to display
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <Arduino.h>
+#include <Config.h>
+#include <KeyboardHandler.hpp>
+
+// a key press of a benchmark sequence, the last key of a
+// sequence carries the label the time is reported under
+typedef struct
+{
+  uint8_t keyCode;
+  bool functionKeyPressed;
+  const char *label;
+} BENCHMARK_KEY;
+
+#if CALC_TYPE == CALC_TYPE_RPN
+
+constexpr BENCHMARK_KEY BENCHMARK_KEYS[] = {
+    // number input
+    {KEY_1, false, nullptr},
+    {KEY_2, false, nullptr},
+    {KEY_3, false, nullptr},
+    {KEY_4, false, nullptr},
+    {KEY_5, false, nullptr},
+    {KEY_DOT, false, nullptr},
+    {KEY_6, false, nullptr},
+    {KEY_7, false, nullptr},
+    {KEY_8, false, nullptr},
+    {KEY_9, false, nullptr},
+    {KEY_ENTER, false, "input"},
+    // repeating decimal
+    {KEY_1, false, nullptr},
+    {KEY_ENTER, false, nullptr},
+    {KEY_7, false, nullptr},
+    {KEY_DIV, false, "1/7"},
+    // fixed decimals
+    {KEY_4, true, "fix 4"},
+    {KEY_0, true, "float"},
+    // arithmetic
+    {KEY_3, false, nullptr},
+    {KEY_DOT, false, nullptr},
+    {KEY_7, false, nullptr},
+    {KEY_MUL, false, nullptr},
+    {KEY_2, false, nullptr},
+    {KEY_PLUS, false, "x*3.7+2"},
+    // functions
+    {KEY_2, false, nullptr},
+    {KEY_SQRT, false, "sqrt"},
+    {KEY_LN, false, "ln"},
+    {KEY_4, false, nullptr},
+    {KEY_5, false, nullptr},
+    {KEY_SIN, false, "sin"},
+    {KEY_2, false, nullptr},
+    {KEY_ENTER, false, nullptr},
+    {KEY_0, false, nullptr},
+    {KEY_DOT, false, nullptr},
+    {KEY_5, false, nullptr},
+    {KEY_POW, false, "pow"},
+    {KEY_CLS, false, "clear"}};
+
+#else
+
+constexpr BENCHMARK_KEY BENCHMARK_KEYS[] = {
+    // number input
+    {KEY_1, false, nullptr},
+    {KEY_2, false, nullptr},
+    {KEY_3, false, nullptr},
+    {KEY_4, false, nullptr},
+    {KEY_5, false, nullptr},
+    {KEY_DOT, false, nullptr},
+    {KEY_6, false, nullptr},
+    {KEY_7, false, nullptr},
+    {KEY_8, false, nullptr},
+    {KEY_9, false, nullptr},
+    {KEY_EQUALS, false, "input"},
+    // repeating decimal
+    {KEY_1, false, nullptr},
+    {KEY_DIV, false, nullptr},
+    {KEY_7, false, nullptr},
+    {KEY_EQUALS, false, "1/7"},
+    // fixed decimals
+    {KEY_4, true, "fix 4"},
+    {KEY_0, true, "float"},
+    // arithmetic
+    {KEY_MUL, false, nullptr},
+    {KEY_3, false, nullptr},
+    {KEY_DOT, false, nullptr},
+    {KEY_7, false, nullptr},
+    {KEY_PLUS, false, nullptr},
+    {KEY_2, false, nullptr},
+    {KEY_EQUALS, false, "x*3.7+2"},
+    // functions
+    {KEY_2, false, nullptr},
+    {KEY_SQRT, false, "sqrt"},
+    {KEY_LN, false, "ln"},
+    {KEY_4, false, nullptr},
+    {KEY_5, false, nullptr},
+    {KEY_SIN, false, "sin"},
+    {KEY_2, false, nullptr},
+    {KEY_POW, false, nullptr},
+    {KEY_0, false, nullptr},
+    {KEY_DOT, false, nullptr},
+    {KEY_5, false, nullptr},
+    {KEY_EQUALS, false, "pow"},
+    {KEY_AC, false, "clear"}};
+
+#endif
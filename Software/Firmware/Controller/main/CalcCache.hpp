@@ -0,0 +1,235 @@
+// CalcCache.hpp
+
+// remembers the results of slow operations, the same operation
+// on the same operands is not calculated again
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <Arduino.h>
+#include <ratpak.h>
+#include <CalcDefs.h>
+#include <CalcEnums.h>
+#include <Rational.hpp>
+
+// cache statistics
+typedef struct
+{
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t entries;
+  uint32_t bytes;
+} CALC_CACHE_STATS;
+
+// a remembered result with the key it was calculated for
+typedef struct
+{
+  uint32_t hash;     // hash of the whole key, compared first
+  operation op;
+  uint8_t variant;   // angle type and backend
+  uint32_t radix;
+  int32_t precision;
+  uint32_t used;     // tick of the last use, the oldest is evicted first
+  uint32_t bytes;    // memory held by the operands and the result
+  Rational x;
+  Rational y;        // empty for single value operations
+  Rational result;
+} CALC_CACHE_ENTRY;
+
+// least recently used results, limited in count and memory.
+// Results are shared with the registers (copy on write),
+// so the cache belongs to the calculation task.
+class CalcCache
+{
+public:
+  CalcCache() : _tick(0), _bytes(0), _hits(0), _misses(0)
+  {
+  }
+
+  // look up the result of op on x and y, y is nullptr for single value operations
+  bool lookup(PRAT x, PRAT y, operation op, uint8_t variant, uint32_t radix, int32_t precision, Rational *result)
+  {
+    uint32_t hash = hashKey(x, y, op, variant, radix, precision);
+    for (CALC_CACHE_ENTRY &entry : _entries)
+    {
+      if (!entry.result.empty() && entry.hash == hash && entry.op == op && entry.variant == variant &&
+          entry.radix == radix && entry.precision == precision && equals(entry.x.get(), x) && equals(entry.y.get(), y))
+      {
+        entry.used = ++_tick;
+        *result = entry.result.clone();
+        _hits++;
+        return (true);
+      }
+    }
+    _misses++;
+    return (false);
+  }
+
+  // remember a result, the least recently used results make room for it
+  void store(const Rational &x, PRAT y, operation op, uint8_t variant, uint32_t radix, int32_t precision, const Rational &result)
+  {
+    uint32_t bytes = Rational::bytes(x.get()) + Rational::bytes(y) + Rational::bytes(result.get());
+    if (bytes > CALC_CACHE_BYTES)
+    {
+      return;
+    }
+    while (_bytes + bytes > CALC_CACHE_BYTES || findFree() == nullptr)
+    {
+      evict(findOldest());
+    }
+    CALC_CACHE_ENTRY *entry = findFree();
+#if RATPAK_EXCEPTIONS
+    try
+    {
+      entry->y.assign(y);
+    }
+    catch (...)
+    {
+      return;
+    }
+#else
+    entry->y.assign(y);
+#endif
+    // a failed copy leaves the entry free
+    if (RATPAK_FAILED())
+    {
+      ClearRatError();
+      entry->y.reset();
+      return;
+    }
+    entry->hash = hashKey(x.get(), y, op, variant, radix, precision);
+    entry->op = op;
+    entry->variant = variant;
+    entry->radix = radix;
+    entry->precision = precision;
+    entry->used = ++_tick;
+    entry->bytes = bytes;
+    entry->x = x.clone();
+    entry->result = result.clone();
+    _bytes += bytes;
+  }
+
+  // drop all results
+  void clear()
+  {
+    for (CALC_CACHE_ENTRY &entry : _entries)
+    {
+      if (!entry.result.empty())
+      {
+        evict(&entry);
+      }
+    }
+  }
+
+  CALC_CACHE_STATS getStats() const
+  {
+    CALC_CACHE_STATS stats = {_hits, _misses, 0, _bytes};
+    for (const CALC_CACHE_ENTRY &entry : _entries)
+    {
+      if (!entry.result.empty())
+      {
+        stats.entries++;
+      }
+    }
+    return (stats);
+  }
+
+  void resetStats()
+  {
+    _hits = 0;
+    _misses = 0;
+  }
+
+private:
+  CALC_CACHE_ENTRY _entries[CALC_CACHE_ENTRIES];
+  uint32_t _tick;
+  uint32_t _bytes;
+  uint32_t _hits;
+  uint32_t _misses;
+
+  CALC_CACHE_ENTRY *findFree()
+  {
+    for (CALC_CACHE_ENTRY &entry : _entries)
+    {
+      if (entry.result.empty())
+      {
+        return (&entry);
+      }
+    }
+    return (nullptr);
+  }
+
+  CALC_CACHE_ENTRY *findOldest()
+  {
+    CALC_CACHE_ENTRY *oldest = nullptr;
+    for (CALC_CACHE_ENTRY &entry : _entries)
+    {
+      if (!entry.result.empty() && (oldest == nullptr || entry.used < oldest->used))
+      {
+        oldest = &entry;
+      }
+    }
+    return (oldest);
+  }
+
+  void evict(CALC_CACHE_ENTRY *entry)
+  {
+    _bytes -= entry->bytes;
+    entry->bytes = 0;
+    entry->x.reset();
+    entry->y.reset();
+    entry->result.reset();
+  }
+
+  // FNV-1a
+  static uint32_t hashBytes(uint32_t hash, const void *data, size_t length)
+  {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < length; i++)
+    {
+      hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return (hash);
+  }
+
+  static uint32_t hashNumber(uint32_t hash, PNUMBER p)
+  {
+    hash = hashBytes(hash, &p->sign, sizeof(p->sign));
+    hash = hashBytes(hash, &p->cdigit, sizeof(p->cdigit));
+    hash = hashBytes(hash, &p->exp, sizeof(p->exp));
+    return (hashBytes(hash, p->mant, p->cdigit * sizeof(MANTTYPE)));
+  }
+
+  static uint32_t hashKey(PRAT x, PRAT y, operation op, uint8_t variant, uint32_t radix, int32_t precision)
+  {
+    uint32_t hash = 2166136261u;
+    hash = hashBytes(hash, &op, sizeof(op));
+    hash = hashBytes(hash, &variant, sizeof(variant));
+    hash = hashBytes(hash, &radix, sizeof(radix));
+    hash = hashBytes(hash, &precision, sizeof(precision));
+    hash = hashNumber(hashNumber(hash, x->pp), x->pq);
+    if (y != nullptr)
+    {
+      hash = hashNumber(hashNumber(hash, y->pp), y->pq);
+    }
+    return (hash);
+  }
+
+  // same digits, equal values with different digits only miss the cache
+  static bool equals(PNUMBER a, PNUMBER b)
+  {
+    return (a->sign == b->sign && a->cdigit == b->cdigit && a->exp == b->exp &&
+            memcmp(a->mant, b->mant, a->cdigit * sizeof(MANTTYPE)) == 0);
+  }
+
+  static bool equals(PRAT a, PRAT b)
+  {
+    if (a == nullptr || b == nullptr)
+    {
+      return (a == b);
+    }
+    return (a == b || (equals(a->pp, b->pp) && equals(a->pq, b->pq)));
+  }
+};
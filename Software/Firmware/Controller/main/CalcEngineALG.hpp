@@ -1,6 +1,7 @@
 // CalcEngineALG.hpp
 
-// provides the algebraic calculator logic
+// provides the algebraic calculator logic, immediate left to right
+// evaluation or operator precedence with parentheses
 
 // Copyright (C) 2020-2025 highvoltglow
 // Licensed under the MIT License
@@ -8,15 +9,32 @@
 #pragma once
 
 #include <Arduino.h>
+#include <vector>
+#include <algorithm>
 #include <ratpak.h>
 #include <CalcDefs.h>
 #include <MemRegister.hpp>
 #include <CalcError.hpp>
 #include <CalcEnums.h>
 #include <CalcMath.hpp>
+#include <Rational.hpp>
+#include <CalcHistory.hpp>
+#include <CalcStatistics.hpp>
 
 typedef std::map<String, PRAT> REGISTERMAP;
 
+// input state in a snapshot
+constexpr uint8_t ALG_NUMBER_ENTERED = 0x01;
+constexpr uint8_t ALG_EQUALS_ENTERED = 0x02;
+constexpr uint8_t ALG_OPERATOR_ENTERED = 0x04;
+
+// a token of a compiled expression
+typedef struct
+{
+  operation op;   // two value operation, operation::none for a number
+  Rational value; // the number
+} EXPRESSION_TOKEN;
+
 // calculator engine class
 class CalcEngineALG
 {
@@ -26,11 +44,9 @@ protected:
 public:
   // constructor
   CalcEngineALG() : _angleType(angle_type::deg),
-                    _regX(nullptr),
-                    _regY(nullptr),
-                    _regT(nullptr),
                     _fixedDecimals(FLOAT_DECIMALS),
                     _operation(operation::none),
+                    _precedence(false),
                     _notifyRegisterUpdate(nullptr)
   {
   }
@@ -53,6 +69,7 @@ public:
     _numberEntered = false;
     _equalsEntered = false;
     _calculationFlag = false;
+    clearExpression();
   }
 
   // attach callback
@@ -67,8 +84,8 @@ public:
     _notifyRegisterUpdate = nullptr;
   }
 
-  // handle numeric input
-  void handleNumericInput(PRAT p)
+  // handle numeric input, takes ownership of the value
+  void handleNumericInput(Rational &&p)
   {
     if (_operationReturnCode == operation_return_code::success)
     {
@@ -79,53 +96,13 @@ public:
         setRegY(rat_zero);
         setRegT(rat_zero);
       }
-      setRegX(p);
+      _regX = std::move(p);
       _numberEntered = true;
+      _operatorEntered = false;
       _calculationFlag = false;
     }
   }
 
-  // return if a calculations could be slow
-  bool isLongOperation(operation op) const
-  {
-    bool result = false;
-    switch (op)
-    {
-    case operation::square_root:
-    case operation::yroot:
-    case operation::factorial:
-    case operation::pow:
-    case operation::pow2:
-    case operation::pow3:
-    case operation::exp:
-    case operation::combinations:
-    case operation::permutations:
-      result = true;
-      break;
-
-    default: // avoid warning
-      break;
-    }
-    return (result);
-  }
-
-  // return if the operation can recover from error
-  bool isErrorRecoveryOperation(operation op)
-  {
-    bool result = false;
-    switch (op)
-    {
-    case operation::clear:
-    case operation::allclear:
-      result = true;
-      break;
-
-    default: // avoid warning
-      break;
-    }
-    return (result);
-  }
-
   // clear error state
   void recoverFromError()
   {
@@ -151,16 +128,16 @@ public:
   // generic function that returns the X register
   PRAT getResult() const
   {
-    return (_regX);
+    return (_regX.get());
   }
 
   // generic function to change sign of X register
   void negateResult()
   {
-    _regX->pp->sign *= -1;
+    _regX.negate();
     if (_notifyRegisterUpdate)
     {
-      _notifyRegisterUpdate("X:", _regX);
+      _notifyRegisterUpdate("X:", _regX.get());
     }
   }
 
@@ -179,53 +156,17 @@ public:
       onEqualsOperation(op);
       break;
 
+    case operation::open_parenthesis:
+    case operation::close_parenthesis:
+      onParenthesisOperation(op);
+      break;
+
     case operation::clear:
     case operation::allclear:
     case operation::clear_error:
       onClearOperation(op);
       break;
 
-    case operation::pow2:
-    case operation::square_root:
-    case operation::pow3:
-    case operation::factorial:
-    case operation::ln:
-    case operation::log10:
-    case operation::invert:
-    case operation::sin:
-    case operation::asin:
-    case operation::sinh:
-    case operation::cos:
-    case operation::acos:
-    case operation::cosh:
-    case operation::tan:
-    case operation::atan:
-    case operation::tanh:
-    case operation::exp:
-    case operation::integer:
-      onSingleValueOperation(op);
-      break;
-
-    case operation::addition:
-    case operation::subtraction:
-    case operation::multiplication:
-    case operation::division:
-    case operation::pow:
-    case operation::yroot:
-    case operation::logy:
-    case operation::percent_diff:
-    case operation::modulo:
-    case operation::permutations:
-    case operation::combinations:
-      onDualValueOperation(op);
-      break;
-
-    case operation::pi:
-    case operation::e:
-    case operation::rnd: // behaves as a constant operation
-      onConstantOperation(op);
-      break;
-
     case operation::memory_clear:
     case operation::memory_read:
     case operation::memory_store:
@@ -234,11 +175,22 @@ public:
       onMemRegOperation(op);
       break;
 
+    case operation::stat_add:
+    case operation::stat_subtract:
+    case operation::stat_count:
+    case operation::stat_mean:
+    case operation::stat_stdev:
+    case operation::stat_pop_stdev:
+    case operation::stat_clear:
+      onStatisticsOperation(op);
+      break;
+
     case operation::deg:
       changeAngleType();
       break;
 
-    default: // avoid warning
+    default: // the math operations by their operands
+      onMathOperation(op);
       break;
     }
     // after an operation notify register changes
@@ -270,6 +222,13 @@ public:
     return (_angleType);
   }
 
+  // evaluate with operator precedence and parentheses or immediately from left to right (default)
+  void setPrecedence(bool precedence)
+  {
+    _precedence = precedence;
+    allClear();
+  }
+
   // set the angle mode for trigonometric operations, deg (default) or rad
   void setAngleType(angle_type angleType)
   {
@@ -294,6 +253,12 @@ public:
     _operationReturnCode = CalcError::toOperationReturnCode(ratError);
   }
 
+  // set operation return code
+  void setOperationReturnCode(operation_return_code rc)
+  {
+    _operationReturnCode = rc;
+  }
+
   // set fixed decimals
   void setFixedDecimals(uint8_t decimals)
   {
@@ -315,13 +280,10 @@ public:
   // set the biggest value for trigonometric operations
   void setMaxTrig()
   {
-    PRAT p = i32torat(100);
-    PRAT q = nullptr;
-    DUPRAT(q, rat_ten);
-    powrat(&q, p, _radix, _precision);
-    DUPRAT(_maxTrig, q);
-    destroyrat(q);
-    destroyrat(p);
+    Rational p(100);
+    Rational q = Rational::copyOf(rat_ten);
+    powrat(q.ptr(), p.get(), _radix, _precision);
+    _maxTrig = std::move(q);
   }
 
   // get fixed decimals
@@ -333,37 +295,37 @@ public:
   // set X register
   void setRegX(PRAT p)
   {
-    DUPRAT(_regX, p);
+    _regX.assign(p);
   }
 
   // get X register
   PRAT getRegX() const
   {
-    return (_regX);
+    return (_regX.get());
   }
 
   // set Y register
   void setRegY(PRAT p)
   {
-    DUPRAT(_regY, p);
+    _regY.assign(p);
   }
 
   // get Y register
   PRAT getRegY() const
   {
-    return (_regY);
+    return (_regY.get());
   }
 
   // set T register
   void setRegT(PRAT p)
   {
-    DUPRAT(_regT, p);
+    _regT.assign(p);
   }
 
   // get T register
   PRAT getRegT() const
   {
-    return (_regT);
+    return (_regT.get());
   }
 
   // set memory register
@@ -380,6 +342,20 @@ public:
     }
   }
 
+  // set memory register, takes ownership of the value
+  void setMemReg(Rational &&p, uint8_t index)
+  {
+    if (index < MEM_REGISTER_COUNT)
+    {
+      _memReg[index].set(std::move(p));
+    }
+    // notify memory register update
+    if (_notifyRegisterUpdate)
+    {
+      _notifyRegisterUpdate("M:", _memReg[index].get());
+    }
+  }
+
   // get memory register
   PRAT getMemReg(uint8_t index)
   {
@@ -393,6 +369,30 @@ public:
     }
   }
 
+  // memory register shared with the copy, a result calculated with doubles
+  // is refined for both when it is used. 0 for an empty register.
+  Rational cloneMemReg(uint8_t index)
+  {
+    Rational p = (index < MEM_REGISTER_COUNT) ? _memReg[index].clone() : Rational();
+    if (p.empty())
+    {
+      p.assign(rat_zero);
+    }
+    return (p);
+  }
+
+  // accumulators of the statistics
+  const CalcStatistics &getStatistics() const
+  {
+    return (_statistics);
+  }
+
+  // true if the statistics changed since the last call
+  bool checkStatisticsChanged()
+  {
+    return (_statistics.checkChanged());
+  }
+
   // return string representation of a PRAT
   String getRatString(PRAT p, NumberFormat format = NumberFormat::Float)
   {
@@ -408,12 +408,62 @@ public:
     return (s);
   }
 
+  // save the engine state for undo, the numbers are shared
+  void saveState(CALC_SNAPSHOT &state) const
+  {
+    state.registers[0] = _regX.clone();
+    state.registers[1] = _regY.clone();
+    state.registers[2] = _regT.clone();
+    for (uint8_t i = 0; i < MEM_REGISTER_COUNT; i++)
+    {
+      state.memory[i] = _memReg[i].clone();
+    }
+    state.operands.clear();
+    for (const Rational &operand : _operands)
+    {
+      state.operands.push_back(operand.clone());
+    }
+    _statistics.saveState(state);
+    state.operators = _operators;
+    state.pendingOperation = _operation;
+    state.flags = (_numberEntered ? ALG_NUMBER_ENTERED : 0) |
+                  (_equalsEntered ? ALG_EQUALS_ENTERED : 0) |
+                  (_operatorEntered ? ALG_OPERATOR_ENTERED : 0);
+    state.returnCode = _operationReturnCode;
+  }
+
+  // continue with a saved state
+  void restoreState(const CALC_SNAPSHOT &state)
+  {
+    _regX = state.registers[0].clone();
+    _regY = state.registers[1].clone();
+    _regT = state.registers[2].clone();
+    for (uint8_t i = 0; i < MEM_REGISTER_COUNT; i++)
+    {
+      _memReg[i].set(state.memory[i].clone());
+    }
+    _operands.clear();
+    for (const Rational &operand : state.operands)
+    {
+      _operands.push_back(operand.clone());
+    }
+    _statistics.restoreState(state);
+    _operators = state.operators;
+    _operation = state.pendingOperation;
+    _numberEntered = state.flags & ALG_NUMBER_ENTERED;
+    _equalsEntered = state.flags & ALG_EQUALS_ENTERED;
+    _operatorEntered = state.flags & ALG_OPERATOR_ENTERED;
+    _operationReturnCode = state.returnCode;
+    notifyRegisterUpdate();
+    notifyMemRegUpdate();
+  }
+
   // return a map with all the registers
   void getRegisters(REGISTERMAP &regmap)
   {
-    regmap["X:"] = _regX;
-    regmap["Y:"] = _regY;
-    regmap["T:"] = _regT;
+    regmap["X:"] = _regX.get();
+    regmap["Y:"] = _regY.get();
+    regmap["T:"] = _regT.get();
     for (uint8_t i = 0; i < MEM_REGISTER_COUNT; i++)
     {
       regmap["M:"] = getMemReg(i);
@@ -428,19 +478,30 @@ private:
   angle_type _angleType;
 
   // calc registers
-  PRAT _regX;
-  PRAT _regY;
-  PRAT _regT;
+  Rational _regX;
+  Rational _regY;
+  Rational _regT;
 
   // memory registers
   MemRegister _memReg[MEM_REGISTER_COUNT];
 
+  // statistics of the values entered with sigma+
+  CalcStatistics _statistics;
+
   // number of fixed decimals, default is floating
   uint8_t _fixedDecimals;
 
-  // current operation
+  // current operation, the last one with operator precedence
   operation _operation;
 
+  // operator precedence, the expression is compiled to reverse polish notation
+  // with a shunting-yard and the compiled tokens run on the operand stack
+  bool _precedence;
+  std::vector<operation> _operators;     // pending operations and open parentheses
+  std::vector<EXPRESSION_TOKEN> _output; // compiled tokens not yet done
+  std::vector<Rational> _operands;       // left operands of the pending operations
+  bool _operatorEntered;                 // the last key was a two value operation
+
   // return code of math operations
   operation_return_code _operationReturnCode;
 
@@ -450,7 +511,7 @@ private:
   bool _numberEntered;
 
   // max value for trigonometric operations
-  PRAT _maxTrig;
+  Rational _maxTrig;
 
   // callback
   notifyRegisterUpdateCb _notifyRegisterUpdate;
@@ -458,25 +519,42 @@ private:
   // equals operation
   void onEqualsOperation(operation op)
   {
-    if (_operation != operation::none)
+    if (_precedence && !_equalsEntered)
+    {
+      // close the open parentheses and run the rest of the expression
+      compileOperand();
+      while (!_operators.empty())
+      {
+        if (_operators.back() != operation::open_parenthesis)
+        {
+          compileOperation(_operators.back());
+        }
+        _operators.pop_back();
+      }
+      if (runExpression())
+      {
+        _regX = std::move(_operands.back());
+      }
+      clearExpression();
+      _equalsEntered = true;
+    }
+    else if (_operation != operation::none)
     {
       // we have an operation
       if (!_equalsEntered)
       {
         // first equals
-        setRegT(_regX);
-        _operationReturnCode = CalcMath::calculate(&_regX, _regY, _operation, _radix, _precision, _maxTrig, _angleType);
+        _regT = _regX.clone();
+        _operationReturnCode = CalcMath::calculate(_regX, _regY.get(), _operation, _radix, _precision, _maxTrig.get(), _angleType);
         _equalsEntered = true;
       }
       else
       {
         // equals after equals, repeat previous operation
-        setRegY(_regX);
-        PRAT p = nullptr;
-        DUPRAT(p, _regT);
-        _operationReturnCode = CalcMath::calculate(&p, _regX, _operation, _radix, _precision, _maxTrig, _angleType);
-        setRegX(p);
-        destroyrat(p);
+        _regY = _regX.clone();
+        Rational p = _regT.clone();
+        _operationReturnCode = CalcMath::calculate(p, _regX.get(), _operation, _radix, _precision, _maxTrig.get(), _angleType);
+        _regX = std::move(p);
       }
     }
     _numberEntered = false;
@@ -485,17 +563,26 @@ private:
   // separate function for percent, percent has a special behavior
   void onPercentOperation(operation op)
   {
-    PRAT p100 = nullptr;
-    PRAT p = nullptr;
-    p100 = i32torat(100);
+    Rational p(100);
 
-    if ((_operation == operation::none) || _equalsEntered)
+    if (_precedence)
+    {
+      // percent of the left operand with addition and subtraction
+      _operationReturnCode = CalcMath::calculate(p, _regX.get(), operation::division, _radix, _precision);
+      if ((_operationReturnCode == operation_return_code::success) && !_operators.empty() &&
+          ((_operators.back() == operation::addition) || (_operators.back() == operation::subtraction)))
+      {
+        _operationReturnCode = CalcMath::calculate(p, _operands.back().get(), operation::multiplication, _radix, _precision);
+      }
+      _regX = std::move(p);
+      _operatorEntered = false;
+    }
+    else if ((_operation == operation::none) || _equalsEntered)
     {
-      DUPRAT(p, p100)
       // no previous operation, just divide by 100
-      _operationReturnCode = CalcMath::calculate(&p, _regX, operation::division, _radix, _precision);
-      setRegX(p);
-      setRegY(_regX);
+      _operationReturnCode = CalcMath::calculate(p, _regX.get(), operation::division, _radix, _precision);
+      _regX = std::move(p);
+      _regY = _regX.clone();
       _numberEntered = false;
     }
     else
@@ -506,22 +593,20 @@ private:
       case operation::addition:
       case operation::subtraction:
 
-        DUPRAT(p, p100);
-        _operationReturnCode = CalcMath::calculate(&p, _regX, operation::division, _radix, _precision);
+        _operationReturnCode = CalcMath::calculate(p, _regX.get(), operation::division, _radix, _precision);
         if (_operationReturnCode == operation_return_code::success)
         {
-          _operationReturnCode = CalcMath::calculate(&p, _regY, operation::multiplication, _radix, _precision);
-          setRegX(p);
+          _operationReturnCode = CalcMath::calculate(p, _regY.get(), operation::multiplication, _radix, _precision);
+          _regX = std::move(p);
         }
         break;
 
       case operation::multiplication:
       case operation::division:
-        DUPRAT(p, p100);
-        _operationReturnCode = CalcMath::calculate(&p, _regX, operation::division, _radix, _precision);
+        _operationReturnCode = CalcMath::calculate(p, _regX.get(), operation::division, _radix, _precision);
         if (_operationReturnCode == operation_return_code::success)
         {
-          setRegX(p);
+          _regX = std::move(p);
         }
         break;
 
@@ -529,8 +614,6 @@ private:
         break;
       }
     }
-    destroyrat(p100);
-    destroyrat(p);
   }
 
   // clear operations
@@ -555,17 +638,52 @@ private:
     }
   }
 
+  // perform a math operation by its number of operands
+  void onMathOperation(operation op)
+  {
+    switch (CalcMath::getArity(op))
+    {
+    case op_arity::zero:
+      onConstantOperation(op);
+      break;
+
+    case op_arity::one:
+      onSingleValueOperation(op);
+      break;
+
+    case op_arity::two:
+      if (_precedence)
+      {
+        onExpressionOperation(op);
+      }
+      else
+      {
+        onDualValueOperation(op);
+      }
+      break;
+
+    default: // avoid warning
+      break;
+    }
+  }
+
   // perform an operation with a single value
   void onSingleValueOperation(operation op)
   {
-    if (_operation == operation::none)
+    if (_precedence)
     {
-      _operationReturnCode = CalcMath::calculate(&_regX, _regY, op, _radix, _precision, _maxTrig, _angleType);
-      setRegY(_regX);
+      // x is the operand of the expression
+      _operationReturnCode = CalcMath::calculate(_regX, _regY.get(), op, _radix, _precision, _maxTrig.get(), _angleType);
+      _operatorEntered = false;
+    }
+    else if (_operation == operation::none)
+    {
+      _operationReturnCode = CalcMath::calculate(_regX, _regY.get(), op, _radix, _precision, _maxTrig.get(), _angleType);
+      _regY = _regX.clone();
     }
     else
     {
-      _operationReturnCode = CalcMath::calculate(&_regX, _regY, op, _radix, _precision, _maxTrig, _angleType);
+      _operationReturnCode = CalcMath::calculate(_regX, _regY.get(), op, _radix, _precision, _maxTrig.get(), _angleType);
     }
   }
 
@@ -575,7 +693,7 @@ private:
     if (_operation == operation::none)
     {
       // no operation entered yet
-      setRegY(_regX);
+      _regY = _regX.clone();
       _operation = op;
     }
     else if (!_numberEntered)
@@ -583,7 +701,7 @@ private:
       if (_equalsEntered)
       {
         // new operation after equals
-        setRegY(_regX);
+        _regY = _regX.clone();
       }
       // no new number entered, just change operation
       _operation = op;
@@ -591,14 +709,183 @@ private:
     else
     {
       // do calculation
-      _operationReturnCode = CalcMath::calculate(&_regX, _regY, _operation, _radix, _precision, _maxTrig, _angleType);
-      setRegY(_regX);
+      _operationReturnCode = CalcMath::calculate(_regX, _regY.get(), _operation, _radix, _precision, _maxTrig.get(), _angleType);
+      _regY = _regX.clone();
       _operation = op;
     }
     _numberEntered = false;
     _equalsEntered = false;
   }
 
+  // add a two value operation to the expression, the pending operations
+  // that bind at least as strong are compiled and done first
+  void onExpressionOperation(operation op)
+  {
+    // a new operation after equals continues with the result
+    _equalsEntered = false;
+    if (_operatorEntered)
+    {
+      // no new number entered, just change operation
+      _operators.back() = op;
+      return;
+    }
+    compileOperand();
+    while (!_operators.empty() && isDoneBefore(_operators.back(), op))
+    {
+      compileOperation(_operators.back());
+      _operators.pop_back();
+    }
+    if (_operators.size() >= CALC_EXPRESSION_DEPTH)
+    {
+      _operationReturnCode = operation_return_code::overflow;
+      clearExpression();
+      return;
+    }
+    _operators.push_back(op);
+    if (runExpression())
+    {
+      // x shows the left operand of the new operation
+      _regX = _operands.back().clone();
+      _operatorEntered = true;
+    }
+  }
+
+  // parentheses, only used with operator precedence
+  void onParenthesisOperation(operation op)
+  {
+    if (!_precedence)
+    {
+      return;
+    }
+    if (op == operation::open_parenthesis)
+    {
+      if (_operators.size() >= CALC_EXPRESSION_DEPTH)
+      {
+        _operationReturnCode = operation_return_code::overflow;
+        clearExpression();
+        return;
+      }
+      _equalsEntered = false;
+      _operators.push_back(op);
+      _operatorEntered = false;
+    }
+    else if (std::find(_operators.begin(), _operators.end(), operation::open_parenthesis) != _operators.end())
+    {
+      // the value of the parentheses becomes x
+      compileOperand();
+      while (_operators.back() != operation::open_parenthesis)
+      {
+        compileOperation(_operators.back());
+        _operators.pop_back();
+      }
+      _operators.pop_back();
+      if (runExpression())
+      {
+        _regX = std::move(_operands.back());
+        _operands.pop_back();
+        setLeftOperand();
+        _operatorEntered = false;
+      }
+    }
+  }
+
+  // x becomes the next operand of the expression
+  void compileOperand()
+  {
+    _output.push_back({operation::none, _regX.clone()});
+  }
+
+  void compileOperation(operation op)
+  {
+    _output.push_back({op, Rational()});
+  }
+
+  // run the compiled tokens in one pass, false on error
+  bool runExpression()
+  {
+    for (EXPRESSION_TOKEN &token : _output)
+    {
+      if (token.op == operation::none)
+      {
+        _operands.push_back(std::move(token.value));
+      }
+      else
+      {
+        // x is on top of y, the result replaces y
+        Rational x = std::move(_operands.back());
+        _operands.pop_back();
+        // equals after equals repeats the last operation
+        _operation = token.op;
+        _regT = x.clone();
+        _operationReturnCode = CalcMath::calculate(x, _operands.back().get(), token.op, _radix, _precision, _maxTrig.get(), _angleType);
+        if (_operationReturnCode != operation_return_code::success)
+        {
+          clearExpression();
+          return (false);
+        }
+        _operands.back() = std::move(x);
+      }
+    }
+    _output.clear();
+    setLeftOperand();
+    return (true);
+  }
+
+  // y shows the left operand of the pending operation
+  void setLeftOperand()
+  {
+    if (_operands.empty())
+    {
+      setRegY(rat_zero);
+    }
+    else
+    {
+      _regY = _operands.back().clone();
+    }
+  }
+
+  void clearExpression()
+  {
+    _operators.clear();
+    _output.clear();
+    _operands.clear();
+    _operatorEntered = false;
+  }
+
+  // binding of two value operations, higher binds stronger
+  static uint8_t getPrecedence(operation op)
+  {
+    switch (op)
+    {
+    case operation::addition:
+    case operation::subtraction:
+      return (1);
+
+    case operation::multiplication:
+    case operation::division:
+    case operation::modulo:
+    case operation::percent_diff:
+      return (2);
+
+    default: // powers, roots, logarithms, permutations and combinations
+      return (3);
+    }
+  }
+
+  // the pending operation is done before op, powers and roots are done from the right
+  static bool isDoneBefore(operation pending, operation op)
+  {
+    if (pending == operation::open_parenthesis)
+    {
+      return (false);
+    }
+    if ((op == operation::pow) || (op == operation::yroot))
+    {
+      return (getPrecedence(pending) > getPrecedence(op));
+    }
+    return (getPrecedence(pending) >= getPrecedence(op));
+  }
+
   // perform operations with constants
   void onConstantOperation(operation op)
   {
@@ -607,7 +894,8 @@ private:
     case operation::pi:
     case operation::e:
     case operation::rnd:
-      CalcMath::getSpecialValue(&_regX, op, _radix, _precision);
+      CalcMath::getSpecialValue(_regX, op, _radix, _precision);
+      _operatorEntered = false;
       break;
 
     default: // avoid warning
@@ -618,7 +906,7 @@ private:
   // handle memory register operations
   void onMemRegOperation(operation op)
   {
-    PRAT p = nullptr;
+    Rational p;
     switch (op)
     {
     case operation::memory_clear:
@@ -626,23 +914,24 @@ private:
       break;
 
     case operation::memory_store:
-      setMemReg(_regX, 0);
+      setMemReg(_regX.clone(), 0);
       break;
 
     case operation::memory_read:
-      setRegX(getMemReg(0));
+      _regX = cloneMemReg(0);
+      _operatorEntered = false;
       break;
 
     case operation::memory_addition:
-      p = getMemReg(0);
-      _operationReturnCode = CalcMath::calculate(&p, _regX, operation::addition, _radix, _precision);
+      p = cloneMemReg(0);
+      _operationReturnCode = CalcMath::calculate(p, _regX.get(), operation::addition, _radix, _precision);
+      setMemReg(std::move(p), 0);
       break;
 
     case operation::memory_subtraction:
-      DUPRAT(p, _regX);
-      _operationReturnCode = CalcMath::calculate(&p, getMemReg(0), operation::subtraction, _radix, _precision);
-      setMemReg(p, 0);
-      destroyrat(p);
+      p = _regX.clone();
+      _operationReturnCode = CalcMath::calculate(p, getMemReg(0), operation::subtraction, _radix, _precision);
+      setMemReg(std::move(p), 0);
       break;
 
     default: // avoid warning
@@ -654,6 +943,51 @@ private:
     }
   }
 
+  // statistics of the values in X, there is no second register for y
+  void onStatisticsOperation(operation op)
+  {
+    Rational a;
+    Rational b;
+    switch (op)
+    {
+    case operation::stat_add:
+    case operation::stat_subtract:
+      _operationReturnCode = _statistics.update(_regX.get(), rat_zero, op == operation::stat_add, _radix, _precision);
+      if (_operationReturnCode == operation_return_code::success)
+      {
+        a = _statistics.getCount();
+      }
+      break;
+
+    case operation::stat_count:
+      _operationReturnCode = operation_return_code::success;
+      a = _statistics.getCount();
+      break;
+
+    case operation::stat_mean:
+      _operationReturnCode = _statistics.getMean(a, b);
+      break;
+
+    case operation::stat_stdev:
+    case operation::stat_pop_stdev:
+      _operationReturnCode = _statistics.getStdDev(a, b, op == operation::stat_stdev, _radix, _precision);
+      break;
+
+    case operation::stat_clear:
+      _operationReturnCode = operation_return_code::success;
+      _statistics.clear();
+      break;
+
+    default: // avoid warning
+      break;
+    }
+    if ((_operationReturnCode == operation_return_code::success) && (a.get() != nullptr))
+    {
+      _regX = std::move(a);
+      _operatorEntered = false;
+    }
+  }
+
   // change angle mode, deg<->rad
   void changeAngleType()
   {
@@ -689,10 +1023,10 @@ private:
       }
       else
       {
-        _notifyRegisterUpdate("X:", _regX);
+        _notifyRegisterUpdate("X:", _regX.get());
       }
-      _notifyRegisterUpdate("Y:", _regY);
-      _notifyRegisterUpdate("T:", _regT);
+      _notifyRegisterUpdate("Y:", _regY.get());
+      _notifyRegisterUpdate("T:", _regT.get());
     }
   }
 
@@ -713,11 +1047,11 @@ private:
   void printStack() const
   {
     D_print("T:      ");
-    printRat(_regT);
+    printRat(_regT.get());
     D_print("Y:      ");
-    printRat(_regY);
+    printRat(_regY.get());
     D_print("X:      ");
-    printRat(_regX);
+    printRat(_regX.get());
     D_print("Heap:   ");
     D_println(esp_get_free_heap_size());
     D_print("MinHeap:");
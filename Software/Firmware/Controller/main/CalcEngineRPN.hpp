@@ -14,9 +14,21 @@
 #include <CalcError.hpp>
 #include <CalcEnums.h>
 #include <CalcMath.hpp>
+#include <Rational.hpp>
+#include <CalcHistory.hpp>
+#include <CalcStack.hpp>
+#include <CalcStatistics.hpp>
 
 typedef std::map<String, PRAT> REGISTERMAP;
 
+// input state in a snapshot
+constexpr uint8_t RPN_STORE_PENDING = 0x01;
+constexpr uint8_t RPN_RECALL_PENDING = 0x02;
+constexpr uint8_t RPN_DISABLE_STACK_LIFT = 0x04;
+
+// X, Y, Z and T, the unlimited stack continues below T
+constexpr size_t RPN_STACK_REGISTERS = 4;
+
 // calculator engine class
 class CalcEngineRPN
 {
@@ -25,18 +37,14 @@ protected:
 
 public:
   // constructor
-  CalcEngineRPN() : _angleType(angle_type::deg),
-                    _regX(nullptr),
-                    _regY(nullptr),
-                    _regZ(nullptr),
-                    _regT(nullptr),
-                    _regLastX(nullptr)
+  CalcEngineRPN() : _angleType(angle_type::deg)
   {
     _fixedDecimals = FLOAT_DECIMALS;
     _storePending = false;
     _recallPending = false;
     _disableStackLift = false;
     _pendingMemMathOperation = operation::none;
+    _unlimitedStack = false;
     _notifyRegisterUpdate = nullptr;
   }
 
@@ -52,8 +60,8 @@ public:
     _notifyRegisterUpdate = nullptr;
   }
 
-  // handle numeric input
-  void handleNumericInput(PRAT p)
+  // handle numeric input, takes ownership of the value
+  void handleNumericInput(Rational &&p)
   {
     if (!getDisableStackLift())
     {
@@ -61,9 +69,9 @@ public:
     }
     else
     {
-      setRegY(getRegX());
+      _regY = std::move(_regX);
     }
-    setRegX(p);
+    _regX = std::move(p);
   }
 
   // clear all
@@ -73,47 +81,6 @@ public:
     clearMemReg();
   }
 
-  // return if a calculations could be slow
-  bool isLongOperation(operation op) const
-  {
-    bool result = false;
-    switch (op)
-    {
-    case operation::square_root:
-    case operation::yroot:
-    case operation::factorial:
-    case operation::pow:
-    case operation::pow2:
-    case operation::pow3:
-    case operation::exp:
-    case operation::combinations:
-    case operation::permutations:
-      result = true;
-      break;
-
-    default: // avoid warning
-      break;
-    }
-    return (result);
-  }
-
-  // return if the operation can recover from error
-  bool isErrorRecoveryOperation(operation op)
-  {
-    bool result = false;
-    switch (op)
-    {
-    case operation::clear_x:
-    case operation::clear_stack:
-      result = true;
-      break;
-
-    default: // avoid warning
-      break;
-    }
-    return (result);
-  }
-
   // clear error state
   void recoverFromError()
   {
@@ -139,16 +106,16 @@ public:
   // generic function that returns the X register
   PRAT getResult() const
   {
-    return (_regX);
+    return (_regX.get());
   }
 
   // generic function to change sign of X register
   void negateResult()
   {
-    _regX->pp->sign *= -1;
+    _regX.negate();
     if (_notifyRegisterUpdate)
     {
-      _notifyRegisterUpdate("X:", _regX);
+      _notifyRegisterUpdate("X:", _regX.get());
     }
   }
 
@@ -158,24 +125,6 @@ public:
     switch (op)
     {
     case operation::percent: // actually a dual value op but behaves as a single value op
-    case operation::pow2:
-    case operation::square_root:
-    case operation::pow3:
-    case operation::factorial:
-    case operation::ln:
-    case operation::log10:
-    case operation::invert:
-    case operation::sin:
-    case operation::asin:
-    case operation::sinh:
-    case operation::cos:
-    case operation::acos:
-    case operation::cosh:
-    case operation::tan:
-    case operation::atan:
-    case operation::tanh:
-    case operation::exp:
-    case operation::integer:
       resetMemRegOperation();
       resetMemMathOperation();
       onSingleValueOperation(op);
@@ -228,27 +177,11 @@ public:
         _pendingMemMathOperation = operation::store_division;
         break;
       }
-      [[fallthrough]];
-    case operation::pow:
-    case operation::yroot:
-    case operation::logy:
-    case operation::percent_diff:
-    case operation::modulo:
-    case operation::permutations:
-    case operation::combinations:
       resetMemRegOperation();
       resetMemMathOperation();
       onDualValueOperation(op);
       break;
 
-    case operation::pi:
-    case operation::e:
-    case operation::rnd: // behaves as a constant operation
-      resetMemRegOperation();
-      resetMemMathOperation();
-      onConstantOperation(op);
-      break;
-
     case operation::clear_memory:
     case operation::recall:
     case operation::store:
@@ -289,7 +222,27 @@ public:
       changeAngleType();
       break;
 
-    default: // avoid warning
+    case operation::stat_add:
+    case operation::stat_subtract:
+    case operation::stat_count:
+    case operation::stat_mean:
+    case operation::stat_stdev:
+    case operation::stat_pop_stdev:
+    case operation::stat_regression:
+    case operation::stat_correlation:
+    case operation::stat_clear:
+      resetMemRegOperation();
+      resetMemMathOperation();
+      onStatisticsOperation(op);
+      break;
+
+    default: // the math operations by their operands
+      if (CalcMath::getArity(op) != op_arity::none)
+      {
+        resetMemRegOperation();
+        resetMemMathOperation();
+        onMathOperation(op);
+      }
       break;
     }
     // after an operation notify stack register changes
@@ -305,8 +258,8 @@ public:
       operation op = getPendingMemMathOperation();
       if (op == operation::none)
       {
-        // store is pending, save X register into memory register
-        setMemReg(getRegX(), digit);
+        // store is pending, the memory register shares X
+        setMemReg(_regX.clone(), digit);
       }
       else
       {
@@ -325,8 +278,8 @@ public:
       operation op = getPendingMemMathOperation();
       if (op == operation::none)
       {
-        // recall is pending, copy memory register to X register
-        setRegX(getMemReg(digit));
+        // recall is pending, X shares the memory register
+        _regX = cloneMemReg(digit);
         *index = digit;
       }
       else
@@ -392,6 +345,12 @@ public:
     _operationReturnCode = CalcError::toOperationReturnCode(ratError);
   }
 
+  // set operation return code
+  void setOperationReturnCode(operation_return_code rc)
+  {
+    _operationReturnCode = rc;
+  }
+
   // set fixed decimals
   void setFixedDecimals(uint8_t decimals)
   {
@@ -413,13 +372,73 @@ public:
   // set the biggest value for trigonometric operations
   void setMaxTrig()
   {
-    PRAT p = i32torat(100);
-    PRAT q = nullptr;
-    DUPRAT(q, rat_ten);
-    powrat(&q, p, _radix, _precision);
-    DUPRAT(_maxTrig, q);
-    destroyrat(q);
-    destroyrat(p);
+    Rational p(100);
+    Rational q = Rational::copyOf(rat_ten);
+    powrat(q.ptr(), p.get(), _radix, _precision);
+    _maxTrig = std::move(q);
+  }
+
+  // four level stack (default) or levels below T without limit
+  void setUnlimitedStack(bool unlimited)
+  {
+    _unlimitedStack = unlimited;
+    if (!_unlimitedStack)
+    {
+      _stack.clear();
+    }
+  }
+
+  // number of stack levels, at least X, Y, Z and T
+  size_t getStackDepth() const
+  {
+    return (RPN_STACK_REGISTERS + _stack.getDepth());
+  }
+
+  // stack level, X is level 0
+  PRAT getStackLevel(size_t level) const
+  {
+    switch (level)
+    {
+    case 0:
+      return (_regX.get());
+
+    case 1:
+      return (_regY.get());
+
+    case 2:
+      return (_regZ.get());
+
+    case 3:
+      return (_regT.get());
+
+    default:
+      return (_stack.get(level - RPN_STACK_REGISTERS));
+    }
+  }
+
+  // call fn with up to count levels below T, X is level 0
+  void getDeepStack(size_t count, const std::function<void(size_t level, PRAT p)> &fn) const
+  {
+    _stack.forEach(count, [&fn](size_t level, const Rational &value)
+                   { fn(level + RPN_STACK_REGISTERS, value.get()); });
+  }
+
+  // true if the levels below T changed since the last call
+  bool checkDeepStackChanged()
+  {
+    return (_stack.checkChanged());
+  }
+
+  // accumulators of the statistics
+  const CalcStatistics &getStatistics() const
+  {
+    return (_statistics);
+  }
+
+  // true if the statistics changed since the last call
+  bool checkStatisticsChanged()
+  {
+    return (_statistics.checkChanged());
   }
 
   // get fixed decimals
@@ -436,61 +455,82 @@ public:
   // set X register
   void setRegX(PRAT p)
   {
-    DUPRAT(_regX, p);
+    _regX.assign(p);
   }
 
   // get X register
   PRAT getRegX() const
   {
-    return (_regX);
+    return (_regX.get());
   }
 
   // set Y register
   void setRegY(PRAT p)
   {
-    DUPRAT(_regY, p);
+    _regY.assign(p);
+  }
+
+  // x in X, Y, Z and T as the input of a program function, the next number lifts the stack
+  void fillStack(PRAT x)
+  {
+    resetMemRegOperation();
+    resetMemMathOperation();
+    _regX.assign(x);
+    _regY = _regX.clone();
+    _regZ = _regX.clone();
+    _regT = _regX.clone();
+    _disableStackLift = false;
+  }
+
+  // set X and Y to the results of a program function
+  void setResult(Rational &&x, Rational &&y)
+  {
+    _regX = std::move(x);
+    _regY = std::move(y);
+    _disableStackLift = false;
+    notifyStackUpdate();
   }
 
   // get Y register
   PRAT getRegY() const
   {
-    return (_regY);
+    return (_regY.get());
   }
 
   // set Z register
   void setRegZ(PRAT p)
   {
-    DUPRAT(_regZ, p);
+    _regZ.assign(p);
   }
 
   // get Z register
   PRAT getRegZ() const
   {
-    return (_regZ);
+    return (_regZ.get());
   }
 
   // set T register
   void setRegT(PRAT p)
   {
-    DUPRAT(_regT, p);
+    _regT.assign(p);
   }
 
   // get T register
   PRAT getRegT() const
   {
-    return (_regT);
+    return (_regT.get());
   }
 
   // set lastX register
   void setRegLastX(PRAT p)
   {
-    DUPRAT(_regLastX, p);
+    _regLastX.assign(p);
   }
 
   // get lastX register
   PRAT getRegLastX() const
   {
-    return (_regLastX);
+    return (_regLastX.get());
   }
 
   // set memory register
@@ -507,6 +547,20 @@ public:
     }
   }
 
+  // set memory register, takes ownership of the value
+  void setMemReg(Rational &&p, uint8_t index)
+  {
+    if (index < MEM_REGISTER_COUNT)
+    {
+      _memReg[index].set(std::move(p));
+    }
+    // notify memory register update
+    if (_notifyRegisterUpdate)
+    {
+      _notifyRegisterUpdate(String(index) + ":", _memReg[index].get());
+    }
+  }
+
   // get memory register
   PRAT getMemReg(uint8_t index)
   {
@@ -520,6 +574,18 @@ public:
     }
   }
 
+  // memory register shared with the copy, a result calculated with doubles
+  // is refined for both when it is used. 0 for an empty register.
+  Rational cloneMemReg(uint8_t index)
+  {
+    Rational p = (index < MEM_REGISTER_COUNT) ? _memReg[index].clone() : Rational();
+    if (p.empty())
+    {
+      p.assign(rat_zero);
+    }
+    return (p);
+  }
+
   // return string representation of a PRAT
   String getRatString(PRAT p, NumberFormat format = NumberFormat::Float)
   {
@@ -535,14 +601,58 @@ public:
     return (s);
   }
 
+  // save the engine state for undo, the numbers are shared
+  void saveState(CALC_SNAPSHOT &state) const
+  {
+    state.registers[0] = _regX.clone();
+    state.registers[1] = _regY.clone();
+    state.registers[2] = _regZ.clone();
+    state.registers[3] = _regT.clone();
+    state.registers[4] = _regLastX.clone();
+    for (uint8_t i = 0; i < MEM_REGISTER_COUNT; i++)
+    {
+      state.memory[i] = _memReg[i].clone();
+    }
+    state.stack = _stack.clone();
+    _statistics.saveState(state);
+    state.pendingOperation = _pendingMemMathOperation;
+    state.flags = (_storePending ? RPN_STORE_PENDING : 0) |
+                  (_recallPending ? RPN_RECALL_PENDING : 0) |
+                  (_disableStackLift ? RPN_DISABLE_STACK_LIFT : 0);
+    state.returnCode = _operationReturnCode;
+  }
+
+  // continue with a saved state
+  void restoreState(const CALC_SNAPSHOT &state)
+  {
+    _regX = state.registers[0].clone();
+    _regY = state.registers[1].clone();
+    _regZ = state.registers[2].clone();
+    _regT = state.registers[3].clone();
+    _regLastX = state.registers[4].clone();
+    for (uint8_t i = 0; i < MEM_REGISTER_COUNT; i++)
+    {
+      _memReg[i].set(state.memory[i].clone());
+    }
+    _stack.restore(state.stack);
+    _statistics.restoreState(state);
+    _pendingMemMathOperation = state.pendingOperation;
+    _storePending = state.flags & RPN_STORE_PENDING;
+    _recallPending = state.flags & RPN_RECALL_PENDING;
+    _disableStackLift = state.flags & RPN_DISABLE_STACK_LIFT;
+    _operationReturnCode = state.returnCode;
+    notifyStackUpdate();
+    notifyMemRegUpdate();
+  }
+
   // return a map with all the registers
   void getRegisters(REGISTERMAP &regmap)
   {
-    regmap["X:"] = _regX;
-    regmap["Y:"] = _regY;
-    regmap["Z:"] = _regZ;
-    regmap["T:"] = _regT;
-    regmap["L:"] = _regLastX;
+    regmap["X:"] = _regX.get();
+    regmap["Y:"] = _regY.get();
+    regmap["Z:"] = _regZ.get();
+    regmap["T:"] = _regT.get();
+    regmap["L:"] = _regLastX.get();
     for (uint8_t i = 0; i < MEM_REGISTER_COUNT; i++)
     {
       regmap[String(i) + ":"] = getMemReg(i);
@@ -557,15 +667,22 @@ private:
   angle_type _angleType;
 
   // stack registers
-  PRAT _regX;
-  PRAT _regY;
-  PRAT _regZ;
-  PRAT _regT;
-  PRAT _regLastX;
+  Rational _regX;
+  Rational _regY;
+  Rational _regZ;
+  Rational _regT;
+  Rational _regLastX;
+
+  // levels below T of the unlimited stack
+  CalcStack _stack;
+  bool _unlimitedStack;
 
   // memory registers
   MemRegister _memReg[MEM_REGISTER_COUNT];
 
+  // statistics of the points entered with sigma+
+  CalcStatistics _statistics;
+
   // number of fixed decimals, default is floating
   uint8_t _fixedDecimals;
 
@@ -580,16 +697,38 @@ private:
   operation _pendingMemMathOperation;
 
   // max value for trigonometric operations
-  PRAT _maxTrig;
+  Rational _maxTrig;
 
   notifyRegisterUpdateCb _notifyRegisterUpdate;
 
+  // perform a math operation by its number of operands
+  void onMathOperation(operation op)
+  {
+    switch (CalcMath::getArity(op))
+    {
+    case op_arity::zero:
+      onConstantOperation(op);
+      break;
+
+    case op_arity::one:
+      onSingleValueOperation(op);
+      break;
+
+    case op_arity::two:
+      onDualValueOperation(op);
+      break;
+
+    default: // avoid warning
+      break;
+    }
+  }
+
   // perform an operation with a single value
   void onSingleValueOperation(operation op)
   {
     stackSetLastX();
     // calculateValue stores the result in the X register
-    _operationReturnCode = CalcMath::calculate(&_regX, _regY, op, _radix, _precision, _maxTrig, _angleType);
+    _operationReturnCode = CalcMath::calculate(_regX, _regY.get(), op, _radix, _precision, _maxTrig.get(), _angleType);
     _disableStackLift = false;
   }
 
@@ -598,7 +737,7 @@ private:
   {
     stackSetLastX();
     // calculateValue stores the result in the X register
-    _operationReturnCode = CalcMath::calculate(&_regX, _regY, op, _radix, _precision, _maxTrig, _angleType);
+    _operationReturnCode = CalcMath::calculate(_regX, _regY.get(), op, _radix, _precision, _maxTrig.get(), _angleType);
     stackDrop();
     _disableStackLift = false;
   }
@@ -615,7 +754,7 @@ private:
     case operation::pi:
     case operation::e:
     case operation::rnd:
-      CalcMath::getSpecialValue(&_regX, op, _radix, _precision);
+      CalcMath::getSpecialValue(_regX, op, _radix, _precision);
       break;
 
     default: // avoid warning
@@ -624,6 +763,79 @@ private:
     _disableStackLift = false;
   }
 
+  // statistics of the points (x, y), x is taken from X and y from Y
+  void onStatisticsOperation(operation op)
+  {
+    Rational a;
+    Rational b;
+    switch (op)
+    {
+    case operation::stat_add:
+    case operation::stat_subtract:
+      _operationReturnCode = _statistics.update(_regX.get(), _regY.get(), op == operation::stat_add, _radix, _precision);
+      if (_operationReturnCode == operation_return_code::success)
+      {
+        // the count replaces x, the next number overwrites it
+        stackSetLastX();
+        _regX = _statistics.getCount();
+        _disableStackLift = true;
+      }
+      break;
+
+    case operation::stat_count:
+      _operationReturnCode = operation_return_code::success;
+      pushResult(_statistics.getCount());
+      break;
+
+    case operation::stat_mean:
+      _operationReturnCode = _statistics.getMean(a, b);
+      break;
+
+    case operation::stat_stdev:
+    case operation::stat_pop_stdev:
+      _operationReturnCode = _statistics.getStdDev(a, b, op == operation::stat_stdev, _radix, _precision);
+      break;
+
+    case operation::stat_regression:
+      // intercept in X, slope in Y
+      _operationReturnCode = _statistics.getRegression(a, b, _radix, _precision);
+      break;
+
+    case operation::stat_correlation:
+      _operationReturnCode = _statistics.getCorrelation(a, _radix, _precision);
+      if (_operationReturnCode == operation_return_code::success)
+      {
+        pushResult(std::move(a));
+      }
+      break;
+
+    case operation::stat_clear:
+      _operationReturnCode = operation_return_code::success;
+      _statistics.clear();
+      break;
+
+    default: // avoid warning
+      break;
+    }
+    if ((_operationReturnCode == operation_return_code::success) && (b.get() != nullptr))
+    {
+      // the x value goes to X, the y value to Y
+      pushResult(std::move(b));
+      pushResult(std::move(a));
+    }
+  }
+
+  // push a result like a constant
+  void pushResult(Rational &&value)
+  {
+    if (!_disableStackLift)
+    {
+      stackLift();
+    }
+    _regX = std::move(value);
+    _disableStackLift = false;
+  }
+
   // handle memory register operations
   void onMemRegOperation(operation op)
   {
@@ -704,41 +916,60 @@ private:
 
   // stack operations:
 
-  // stack lift
+  // stack lift, T is dropped or pushed down and X keeps its value
   void stackLift()
   {
-    DUPRAT(_regT, _regZ);
-    DUPRAT(_regZ, _regY);
-    DUPRAT(_regY, _regX);
+    // zeros below the last level are the same as no level
+    if (_unlimitedStack && !(_stack.empty() && zerrat(_regT.get())))
+    {
+      _stack.pushTop(std::move(_regT));
+    }
+    _regT = std::move(_regZ);
+    _regZ = std::move(_regY);
+    _regY = _regX.clone();
   }
 
-  // adjust stack after an operation with 2 values
+  // adjust stack after an operation with 2 values, T keeps its value
+  // or gets the level below
   void stackDrop()
   {
-    DUPRAT(_regY, _regZ);
-    DUPRAT(_regZ, _regT);
+    _regY = std::move(_regZ);
+    if (_unlimitedStack)
+    {
+      _regZ = std::move(_regT);
+      _regT = _stack.popTop();
+      if (_regT.empty())
+      {
+        _regT.assign(rat_zero);
+      }
+    }
+    else
+    {
+      _regZ = _regT.clone();
+    }
   }
 
   // clear X register
   void stackClearX()
   {
-    DUPRAT(_regX, rat_zero);
+    _regX.assign(rat_zero);
   }
 
   // clear all stack registers
   void stackClear()
   {
-    DUPRAT(_regX, rat_zero);
-    DUPRAT(_regY, rat_zero);
-    DUPRAT(_regZ, rat_zero);
-    DUPRAT(_regT, rat_zero);
-    DUPRAT(_regLastX, rat_zero);
+    _regX.assign(rat_zero);
+    _regY.assign(rat_zero);
+    _regZ.assign(rat_zero);
+    _regT.assign(rat_zero);
+    _regLastX.assign(rat_zero);
+    _stack.clear();
   }
 
   // store X into lastX register
   void stackSetLastX()
   {
-    DUPRAT(_regLastX, _regX);
+    _regLastX = _regX.clone();
   }
 
   // store lastX into X register
@@ -748,106 +979,97 @@ private:
     {
       stackLift();
     }
-    DUPRAT(_regX, _regLastX);
+    _regX = _regLastX.clone();
   }
 
   // swap X and Y registers
   void stackSwapXY()
   {
-    PRAT p = nullptr;
-    DUPRAT(p, _regX);
-    DUPRAT(_regX, _regY);
-    DUPRAT(_regY, p);
-    destroyrat(p);
+    std::swap(_regX, _regY);
   }
 
-  // stack roll down
+  // stack roll down, X goes to the bottom level
   void stackRollDown()
   {
-    PRAT p = nullptr;
-    DUPRAT(p, _regX);
-    DUPRAT(_regX, _regY);
-    DUPRAT(_regY, _regZ);
-    DUPRAT(_regZ, _regT);
-    DUPRAT(_regT, p);
-    destroyrat(p);
+    Rational p = std::move(_regX);
+    _regX = std::move(_regY);
+    _regY = std::move(_regZ);
+    _regZ = std::move(_regT);
+    _regT = _stack.rollDown(std::move(p));
   }
 
-  // stack roll up
+  // stack roll up, the bottom level goes to X
   void stackRollUp()
   {
-    PRAT p = nullptr;
-    DUPRAT(p, _regT);
-    DUPRAT(_regT, _regZ);
-    DUPRAT(_regZ, _regY);
-    DUPRAT(_regY, _regX);
-    DUPRAT(_regX, p);
-    destroyrat(p);
+    Rational p = _stack.rollUp(std::move(_regT));
+    _regT = std::move(_regZ);
+    _regZ = std::move(_regY);
+    _regY = std::move(_regX);
+    _regX = std::move(p);
   }
 
   // do the memory register math
   operation_return_code calculateMemMath(operation op, uint8_t digit)
   {
-    PRAT p = nullptr;
+    Rational p;
     operation_return_code result = operation_return_code::success;
     switch (op)
     {
     case operation::store_addition:
-      DUPRAT(p, getMemReg(digit));
-      result = CalcMath::calculate(&p, _regX, operation::addition, _radix, _precision);
+      p = cloneMemReg(digit);
+      result = CalcMath::calculate(p, _regX.get(), operation::addition, _radix, _precision);
       if (result == operation_return_code::success)
       {
-        setMemReg(p, digit);
+        setMemReg(std::move(p), digit);
       }
       break;
 
     case operation::store_subtraction:
-      DUPRAT(p, getMemReg(digit));
-      result = CalcMath::calculate(&p, _regX, operation::subtraction, _radix, _precision);
+      p = cloneMemReg(digit);
+      result = CalcMath::calculate(p, _regX.get(), operation::subtraction, _radix, _precision);
       if (result == operation_return_code::success)
       {
-        setMemReg(p, digit);
+        setMemReg(std::move(p), digit);
       }
       break;
 
     case operation::store_multiplication:
-      DUPRAT(p, getMemReg(digit));
-      result = CalcMath::calculate(&p, _regX, operation::multiplication, _radix, _precision);
+      p = cloneMemReg(digit);
+      result = CalcMath::calculate(p, _regX.get(), operation::multiplication, _radix, _precision);
       if (result == operation_return_code::success)
       {
-        setMemReg(p, digit);
+        setMemReg(std::move(p), digit);
       }
       break;
 
     case operation::store_division:
-      DUPRAT(p, getMemReg(digit));
-      result = CalcMath::calculate(&p, _regX, operation::division, _radix, _precision);
+      p = cloneMemReg(digit);
+      result = CalcMath::calculate(p, _regX.get(), operation::division, _radix, _precision);
       if (result == operation_return_code::success)
       {
-        setMemReg(p, digit);
+        setMemReg(std::move(p), digit);
       }
       break;
 
     case operation::recall_addition:
-      result = CalcMath::calculate(&_regX, getMemReg(digit), operation::addition, _radix, _precision);
+      result = CalcMath::calculate(_regX, getMemReg(digit), operation::addition, _radix, _precision);
       break;
 
     case operation::recall_subtracion:
-      result = CalcMath::calculate(&_regX, getMemReg(digit), operation::subtraction, _radix, _precision);
+      result = CalcMath::calculate(_regX, getMemReg(digit), operation::subtraction, _radix, _precision);
       break;
 
     case operation::recall_multiplication:
-      result = CalcMath::calculate(&_regX, getMemReg(digit), operation::multiplication, _radix, _precision);
+      result = CalcMath::calculate(_regX, getMemReg(digit), operation::multiplication, _radix, _precision);
       break;
 
     case operation::recall_division:
-      result = CalcMath::calculate(&_regX, getMemReg(digit), operation::division, _radix, _precision);
+      result = CalcMath::calculate(_regX, getMemReg(digit), operation::division, _radix, _precision);
       break;
 
     default: // avoid warning
       break;
     }
-    destroyrat(p);
     return (result);
   }
 
@@ -917,12 +1139,12 @@ private:
       }
       else
       {
-        _notifyRegisterUpdate("X:", _regX);
+        _notifyRegisterUpdate("X:", _regX.get());
       }
-      _notifyRegisterUpdate("Y:", _regY);
-      _notifyRegisterUpdate("Z:", _regZ);
-      _notifyRegisterUpdate("T:", _regT);
-      _notifyRegisterUpdate("L:", _regLastX);
+      _notifyRegisterUpdate("Y:", _regY.get());
+      _notifyRegisterUpdate("Z:", _regZ.get());
+      _notifyRegisterUpdate("T:", _regT.get());
+      _notifyRegisterUpdate("L:", _regLastX.get());
     }
   }
 
@@ -943,15 +1165,15 @@ private:
   void printStack() const
   {
     D_print("T:      ");
-    printRat(_regT);
+    printRat(_regT.get());
     D_print("Z:      ");
-    printRat(_regZ);
+    printRat(_regZ.get());
     D_print("Y:      ");
-    printRat(_regY);
+    printRat(_regY.get());
     D_print("X:      ");
-    printRat(_regX);
+    printRat(_regX.get());
     D_print("lastX:  ");
-    printRat(_regLastX);
+    printRat(_regLastX.get());
     D_print("Heap:   ");
     D_println(esp_get_free_heap_size());
     D_print("MinHeap:");
@@ -21,7 +21,9 @@ enum class operation_return_code : uint8_t
   indefinite,
   invalidrange,
   unknownoperation,
-  unknown
+  unknown,
+  cancelled,
+  timelimit
 };
 
 class CalcError
@@ -60,6 +62,14 @@ public:
       result = operation_return_code::overflow;
       break;
 
+    case CALC_E_CANCELLED:
+      result = operation_return_code::cancelled;
+      break;
+
+    case CALC_E_TIMELIMIT:
+      result = operation_return_code::timelimit;
+      break;
+
     default:
       result = operation_return_code::unknown;
       break;
@@ -105,6 +115,14 @@ public:
       s = "Unknown operation";
       break;
 
+    case operation_return_code::cancelled:
+      s = "Cancelled";
+      break;
+
+    case operation_return_code::timelimit:
+      s = "Exceeds time limit";
+      break;
+
     default: // avoid warning
       break;
     }
@@ -0,0 +1,246 @@
+// CalcHistory.hpp
+
+// undo and redo of the calculator keys, the engine state before
+// every change is kept in a ring
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include <ratpak.h>
+#include <CalcDefs.h>
+#include <CalcEnums.h>
+#include <CalcError.hpp>
+#include <CalcStack.hpp>
+#include <Rational.hpp>
+
+// X, Y, Z, T and last X in RPN mode, X, Y and T in algebraic mode
+constexpr size_t CALC_SNAPSHOT_REGISTERS = 5;
+
+// count, means and sums of the deviations of the statistics
+constexpr size_t CALC_STAT_ACCUMULATORS = 6;
+
+// engine state, the numbers are shared with the registers (copy on write)
+typedef struct
+{
+  Rational registers[CALC_SNAPSHOT_REGISTERS];
+  Rational memory[MEM_REGISTER_COUNT];
+  Rational statistics[CALC_STAT_ACCUMULATORS];
+  std::vector<Rational> operands;   // left operands of a pending expression
+  std::vector<operation> operators; // operations and parentheses of a pending expression
+  CalcStack stack;                  // levels below T of the unlimited RPN stack
+  operation pendingOperation;       // pending two value or memory operation
+  uint8_t flags;                    // input state of the engine
+  operation_return_code returnCode;
+  uint32_t bytes; // heap of the numbers the older snapshot does not share
+} CALC_SNAPSHOT;
+
+// snapshots of the engine, limited in count and memory.
+// Undo and redo only move the cursor, the numbers of a
+// snapshot are shared with the registers and not copied.
+class CalcHistory
+{
+public:
+  CalcHistory() : _first(0), _count(0), _current(0), _bytes(0), _budget(0)
+  {
+  }
+
+  // memory for the numbers of the snapshots, 0 disables the history
+  void setBudget(uint32_t bytes)
+  {
+    _budget = bytes;
+    if (_budget == 0)
+    {
+      clear();
+    }
+    trim();
+  }
+
+  // keep the state before a change, the states that could be redone are dropped
+  void save(CALC_SNAPSHOT &&state)
+  {
+    if (_budget == 0)
+    {
+      return;
+    }
+    while (_count > _current)
+    {
+      dropNewest();
+    }
+    append(std::move(state));
+    _current = _count;
+    trim();
+  }
+
+  // the state before the last change, nullptr if there is none.
+  // The current state is kept for redo.
+  const CALC_SNAPSHOT *undo(CALC_SNAPSHOT &&state)
+  {
+    if (_current == _count)
+    {
+      if (_current == 0)
+      {
+        return (nullptr);
+      }
+      append(std::move(state));
+      trim();
+    }
+    if (_current == 0)
+    {
+      return (nullptr);
+    }
+    _current--;
+    return (&at(_current));
+  }
+
+  // the state before the last undo, nullptr if there is none
+  const CALC_SNAPSHOT *redo()
+  {
+    if (_current + 1 >= _count)
+    {
+      return (nullptr);
+    }
+    _current++;
+    return (&at(_current));
+  }
+
+  // drop all snapshots
+  void clear()
+  {
+    while (_count > 0)
+    {
+      dropNewest();
+    }
+    _current = 0;
+  }
+
+  // number of changes that can be undone
+  size_t getUndoCount() const
+  {
+    return (_current);
+  }
+
+  // heap of the snapshots
+  uint32_t getBytes() const
+  {
+    return (_bytes);
+  }
+
+private:
+  CALC_SNAPSHOT _entries[CALC_UNDO_SIZE];
+  size_t _first;   // ring index of the oldest snapshot
+  size_t _count;   // number of snapshots
+  size_t _current; // snapshot of the engine state, _count if it is not kept
+  uint32_t _bytes;
+  uint32_t _budget;
+
+  CALC_SNAPSHOT &at(size_t index)
+  {
+    return (_entries[(_first + index) % CALC_UNDO_SIZE]);
+  }
+
+  void append(CALC_SNAPSHOT &&state)
+  {
+    if (_count == CALC_UNDO_SIZE)
+    {
+      dropOldest();
+    }
+    CALC_SNAPSHOT &snapshot = at(_count);
+    snapshot = std::move(state);
+    snapshot.bytes = getBytes(snapshot, (_count > 0) ? &at(_count - 1) : nullptr);
+    _bytes += snapshot.bytes;
+    _count++;
+  }
+
+  // the oldest snapshots make room, the snapshot of the current state is kept
+  void trim()
+  {
+    while ((_bytes > _budget) && (_count > 1) && (_current > 0))
+    {
+      dropOldest();
+    }
+  }
+
+  void dropOldest()
+  {
+    release(at(0));
+    _first = (_first + 1) % CALC_UNDO_SIZE;
+    _count--;
+    if (_current > 0)
+    {
+      _current--;
+    }
+    if (_count > 0)
+    {
+      // the new oldest snapshot has no older one to share with
+      CALC_SNAPSHOT &oldest = at(0);
+      _bytes -= oldest.bytes;
+      oldest.bytes = getBytes(oldest, nullptr);
+      _bytes += oldest.bytes;
+    }
+  }
+
+  void dropNewest()
+  {
+    release(at(_count - 1));
+    _count--;
+  }
+
+  void release(CALC_SNAPSHOT &snapshot)
+  {
+    _bytes -= snapshot.bytes;
+    snapshot.bytes = 0;
+    for (Rational &r : snapshot.registers)
+    {
+      r.reset();
+    }
+    for (Rational &r : snapshot.memory)
+    {
+      r.reset();
+    }
+    for (Rational &r : snapshot.statistics)
+    {
+      r.reset();
+    }
+    snapshot.operands = std::vector<Rational>();
+    snapshot.operators = std::vector<operation>();
+    snapshot.stack.clear();
+  }
+
+  // heap of the numbers that differ from the older snapshot
+  static uint32_t getBytes(const CALC_SNAPSHOT &snapshot, const CALC_SNAPSHOT *older)
+  {
+    uint32_t bytes = snapshot.operands.capacity() * sizeof(Rational) + snapshot.operators.capacity() * sizeof(operation);
+    for (size_t i = 0; i < CALC_SNAPSHOT_REGISTERS; i++)
+    {
+      bytes += getBytes(snapshot.registers[i], (older != nullptr) ? older->registers[i].get() : nullptr);
+    }
+    for (size_t i = 0; i < MEM_REGISTER_COUNT; i++)
+    {
+      bytes += getBytes(snapshot.memory[i], (older != nullptr) ? older->memory[i].get() : nullptr);
+    }
+    for (size_t i = 0; i < CALC_STAT_ACCUMULATORS; i++)
+    {
+      bytes += getBytes(snapshot.statistics[i], (older != nullptr) ? older->statistics[i].get() : nullptr);
+    }
+    for (size_t i = 0; i < snapshot.operands.size(); i++)
+    {
+      bytes += getBytes(snapshot.operands[i], ((older != nullptr) && (i < older->operands.size())) ? older->operands[i].get() : nullptr);
+    }
+    // the stack levels are shared, the levels pushed since the older snapshot are new.
+    // Levels older than the oldest snapshot are not counted, they are mostly still on the stack.
+    if ((older != nullptr) && (snapshot.stack.getCreatedBytes() > older->stack.getCreatedBytes()))
+    {
+      bytes += snapshot.stack.getCreatedBytes() - older->stack.getCreatedBytes();
+    }
+    return (bytes);
+  }
+
+  static uint32_t getBytes(const Rational &r, PRAT older)
+  {
+    return ((r.get() == older) ? 0 : Rational::bytes(r.get()));
+  }
+};
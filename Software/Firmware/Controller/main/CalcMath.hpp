@@ -2,6 +2,7 @@
 
 // provides higher level math operations
 // uses arbitrary-precision arithmetic (experimental)
+// transcendental operations can use binary floats instead of rationals
 
 // Copyright (C) 2020-2025 highvoltglow
 // Licensed under the MIT License
@@ -9,566 +10,1531 @@
 #pragma once
 
 #include <Arduino.h>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <new>
 #include <ratpak.h>
+#include <Config.h>
 #include <CalcEnums.h>
 #include <CalcError.hpp>
+#include <Rational.hpp>
+#include <BigFloat.hpp>
+#include <ScaledInt.hpp>
+#include <CalcCache.hpp>
+
+// ratpak allocations of an operation, summed over its calculations
+typedef struct
+{
+  uint32_t calls;
+  uint32_t allocs;    // blocks allocated
+  uint64_t bytes;     // bytes allocated
+  uint32_t peakBytes; // most bytes a single calculation held at once
+} MEM_PROFILE;
+
+// the operations done by CalcMath::calculate come before addition
+constexpr size_t MEM_PROFILE_COUNT = static_cast<size_t>(operation::addition) + 1;
+
+// kernel of an operation, stores the result in x and returns a ratpak error code
+typedef uint32_t (*calc_kernel)(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType);
+
+// domain check of an operation, true if the operands are valid
+typedef bool (*calc_domain)(PRAT x, PRAT py, uint32_t radix, int32_t precision, PRAT maxTrig);
+
+// operation flags
+constexpr uint8_t OP_ANGLE = 0x01;          // the result depends on the angle type
+constexpr uint8_t OP_CACHED = 0x02;         // results are cached
+constexpr uint8_t OP_ERROR_RECOVERY = 0x04; // accepted in error state
+constexpr uint8_t OP_SCALED = 0x08;         // done with scaled integers on exact decimals
+
+// description of an operation
+typedef struct
+{
+  const char *name;
+  op_arity arity;
+  uint8_t flags;
+  op_cost cost;            // how the time grows with the operands
+  float weight;            // time relative to ln with exact rationals
+  calc_domain domain;      // nullptr if all operands are valid
+  calc_kernel kernel;      // exact rationals, nullptr if the engine does the operation
+  calc_kernel floatKernel; // binary floats, nullptr if the operation always stays exact
+} OPERATION_INFO;
+
+// a result calculated with doubles, the rationals calculate it when it is needed
+typedef struct
+{
+  Rational result;  // shared with the registers, replaced in place by the exact value
+  Rational operand; // x before the operation
+  Rational y;       // empty for one operand
+  operation op;
+  uint32_t radix;
+  int32_t precision;
+  angle_type angleType;
+  uint8_t certifiedDigits; // digits of result proven by the error bound
+} CALC_DEFERRED;
 
 class CalcMath
 {
 public:
+  using previewCb = std::function<void(PRAT p)>;
+  using longOperationCb = std::function<void(bool begin)>;
+
   CalcMath() = delete;
 
-  // do the math and store the result in px
+  // the callback gets a fast approximation before the exact calculation starts
+  static void attachPreviewCb(previewCb callBack)
+  {
+    _preview = callBack;
+  }
+
+  static void detachPreviewCb()
+  {
+    _preview = nullptr;
+  }
+
+  // the callback is called before and after operations estimated to be long
+  static void attachLongOperationCb(longOperationCb callBack)
+  {
+    _longOperation = callBack;
+  }
+
+  static void detachLongOperationCb()
+  {
+    _longOperation = nullptr;
+  }
+
+  // operations estimated to run longer are not started, in ms, 0 for no limit
+  static void setTimeLimit(uint32_t timeLimit)
+  {
+    _timeLimit = timeLimit;
+  }
+
+  // select the backend for transcendental operations
+  static void setBackend(calc_backend::calc_backend backend)
+  {
+    _backend = backend;
+  }
+
+  static calc_backend::calc_backend getBackend()
+  {
+    return (_backend);
+  }
+
+  // do the basic operations on exact decimals with scaled integers
+  static void setScaledIntegers(bool enabled)
+  {
+    _scaledIntegers = enabled;
+  }
+
+  // show the transcendental results calculated with doubles if their error bound
+  // proves this many digits, the rationals calculate them when needed. 0 disables it.
+  static void setCertifiedDigits(uint8_t digits)
+  {
+    refine();
+    _certifiedDigits = digits;
+  }
+
+  // true if a result was calculated with doubles and refine has not run
+  static bool isRefinePending()
+  {
+    return (!_deferred.result.empty());
+  }
+
+  // true if p is the result calculated with doubles, only its certified digits are proven
+  static bool isApproximation(PRAT p)
+  {
+    return ((p != nullptr) && (_deferred.result.get() == p));
+  }
+
+  // digits proven by the error bound of a result calculated with doubles
+  static uint8_t getCertifiedDigits()
+  {
+    return (_deferred.certifiedDigits);
+  }
+
+  // calculate the pending double result with the rationals. The number is replaced
+  // in place, so the registers and snapshots sharing it get the exact value.
+  // Needed before more digits than the display are read or the number is copied.
+  // After a failure or a cancel the result stays pending, the next read retries.
+  static operation_return_code refine()
+  {
+    if (_deferred.result.empty())
+    {
+      return (operation_return_code::success);
+    }
+    CALC_DEFERRED deferred = std::move(_deferred);
+    // nobody else keeps the number
+    if (!deferred.result.shared())
+    {
+      return (operation_return_code::success);
+    }
+    const OPERATION_INFO &info = getOperationInfo(deferred.op);
+    PRAT py = deferred.y.get();
+    bool longOperation = _longOperation && (estimateTime(deferred.operand.get(), py, deferred.op, deferred.precision) >= CALC_LONG_OPERATION_TIME);
+    if (longOperation)
+    {
+      _longOperation(true);
+    }
+    Rational x = deferred.operand.clone();
+    uint32_t error;
+    ClearRatError();
+#if RATPAK_EXCEPTIONS
+    try
+    {
+      error = calculateValue(x, py, deferred.op, deferred.radix, deferred.precision, rat_zero, deferred.angleType);
+    }
+    catch (uint32_t e)
+    {
+      error = e;
+    }
+    catch (const std::bad_alloc &)
+    {
+      error = CALC_E_OUTOFMEMORY;
+    }
+#else
+    error = calculateValue(x, py, deferred.op, deferred.radix, deferred.precision, rat_zero, deferred.angleType);
+#endif
+    if (longOperation)
+    {
+      _longOperation(false);
+    }
+    if (GetRatError() != S_OK)
+    {
+      error = GetRatError();
+      ClearRatError();
+    }
+    if (error != S_OK)
+    {
+      // only the certified digits of the double result are proven
+      _deferred = std::move(deferred);
+      return (CalcError::toOperationReturnCode(error));
+    }
+    deferred.result.replaceShared(std::move(x));
+    if ((info.flags & OP_CACHED) != 0)
+    {
+      _cache.store(deferred.operand, py, deferred.op, getCacheVariant(info, deferred.angleType), deferred.radix, deferred.precision, deferred.result);
+    }
+    return (operation_return_code::success);
+  }
+
+  // do the math and store the result in x, x keeps its value if the operation fails
   // maxTrig and angletype are needed for trigonometric operations
-  static operation_return_code calculate(PRAT *px, PRAT py, operation op, uint32_t radix, int32_t precision, PRAT maxTrig = rat_zero, angle_type angleType = angle_type::deg)
+  static operation_return_code calculate(Rational &x, PRAT py, operation op, uint32_t radix, int32_t precision, PRAT maxTrig = rat_zero, angle_type angleType = angle_type::deg)
+  {
+    // the operands have to be exact
+    operation_return_code rc = refine();
+    if (rc != operation_return_code::success)
+    {
+      return (rc);
+    }
+    const OPERATION_INFO &info = getOperationInfo(op);
+    // exact decimals skip the rationals, ratpak is only needed for the result
+    if (_scaledIntegers && ((info.flags & OP_SCALED) != 0) && calculateScaled(x, py, op))
+    {
+      return (operation_return_code::success);
+    }
+    // slow operations on the same operands are taken from the cache
+    bool cached = (info.flags & OP_CACHED) != 0;
+    PRAT cachedY = (info.arity == op_arity::two) ? py : nullptr;
+    uint8_t variant = getCacheVariant(info, angleType);
+    if (cached && _cache.lookup(x.get(), cachedY, op, variant, radix, precision, &x))
+    {
+      return (operation_return_code::success);
+    }
+    // ratpak keeps the first error in its context, a cancel is only recorded there
+    ClearRatError();
+    // the time is estimated for valid operands only
+    if (info.domain != nullptr && !info.domain(x.get(), py, radix, precision, maxTrig))
+    {
+      return (CalcError::toOperationReturnCode(CALC_E_DOMAIN));
+    }
+    uint32_t time = estimateTime(x.get(), py, op, precision);
+    if (_timeLimit != 0 && time > _timeLimit)
+    {
+      return (CalcError::toOperationReturnCode(CALC_E_TIMELIMIT));
+    }
+    // a double result is enough for the display if its error bound proves the digits
+    if ((_certifiedDigits != 0) && (info.floatKernel != nullptr) && calculateCertified(x, cachedY, op, radix, precision, angleType))
+    {
+      return (operation_return_code::success);
+    }
+    bool longOperation = (time >= CALC_LONG_OPERATION_TIME);
+    if (longOperation && _longOperation)
+    {
+      _longOperation(true);
+    }
+    // shares the value until x is written
+    Rational operand = x.clone();
+    uint32_t error;
+    if (longOperation && _preview)
+    {
+      preview(x.get(), py, op, angleType);
+    }
+    // measure the peak of this calculation
+    RATALLOCSTATS allocStats = GetRatAllocStats();
+    ResetRatAllocPeak();
+#if RATPAK_EXCEPTIONS
+    try
+    {
+      error = calculateValue(x, py, op, radix, precision, maxTrig, angleType);
+    }
+    catch (uint32_t e)
+    {
+      error = e;
+    }
+    catch (const std::bad_alloc &)
+    {
+      error = CALC_E_OUTOFMEMORY;
+    }
+#else
+    error = calculateValue(x, py, op, radix, precision, maxTrig, angleType);
+#endif
+    profileMemory(op, allocStats);
+    if (longOperation && _longOperation)
+    {
+      _longOperation(false);
+    }
+    // the error recorded first wins, later errors may be caused by it
+    if (GetRatError() != S_OK)
+    {
+      error = GetRatError();
+      ClearRatError();
+    }
+    if (error != S_OK)
+    {
+      x = std::move(operand);
+      return (CalcError::toOperationReturnCode(error));
+    }
+    if (cached)
+    {
+      _cache.store(operand, cachedY, op, variant, radix, precision, x);
+    }
+    return (operation_return_code::success);
+  }
+
+  // select the backend and do the math, returns a ratpak error code
+  static uint32_t calculateValue(Rational &x, PRAT py, operation op, uint32_t radix, int32_t precision, PRAT maxTrig, angle_type angleType)
+  {
+    const OPERATION_INFO &info = getOperationInfo(op);
+    // the basic operations always stay exact
+    calc_kernel kernel = (_backend == calc_backend::binary_float && info.floatKernel != nullptr) ? info.floatKernel : info.kernel;
+    if (kernel == nullptr)
+    {
+      return (S_OK);
+    }
+    return (kernel(x, py, radix, precision, angleType));
+  }
+
+  // description of an operation
+  static const OPERATION_INFO &getOperationInfo(operation op)
+  {
+    return (_operations[static_cast<size_t>(op)]);
+  }
+
+  // number of operands of a math operation
+  static op_arity getArity(operation op)
+  {
+    return (getOperationInfo(op).arity);
+  }
+
+  // estimated time of an operation on valid operands in ms, 0 if ratpak rejects the operands
+  // right away. The work is counted in units growing with the precision (series) and
+  // with the operand and result sizes in ratpak digits (limbs), the time per unit is
+  // measured by calibrateCost.
+  static uint32_t estimateTime(PRAT x, PRAT py, operation op, int32_t precision)
+  {
+    double series;
+    double limbs;
+    getCostUnits(x, py, op, precision, &series, &limbs);
+    double time = (series * _seriesCost + limbs * _limbCost) / 1000;
+    return (time < UINT32_MAX ? static_cast<uint32_t>(time) : UINT32_MAX);
+  }
+
+  // measure the time per unit with ln(2) and 400!, takes some ms
+  static void calibrateCost(uint32_t radix, int32_t precision)
+  {
+    double series;
+    double limbs;
+    Rational x(2);
+    getCostUnits(x.get(), nullptr, operation::ln, precision, &series, &limbs);
+    uint32_t start = micros();
+    uint32_t error = calibrationRun(x, operation::ln, radix, precision);
+    uint32_t time = micros() - start;
+    if (error == S_OK && time > 0)
+    {
+      _seriesCost = static_cast<float>(time / series);
+    }
+    x = Rational(400);
+    getCostUnits(x.get(), nullptr, operation::factorial, precision, &series, &limbs);
+    start = micros();
+    error = calibrationRun(x, operation::factorial, radix, precision);
+    time = micros() - start;
+    if (error == S_OK && time > 0)
+    {
+      _limbCost = static_cast<float>(time / limbs);
+    }
+  }
+
+  // true if the operation is accepted in error state
+  static bool isErrorRecoveryOperation(operation op)
+  {
+    return ((getOperationInfo(op).flags & OP_ERROR_RECOVERY) != 0);
+  }
+
+  // angle in radians, degrees are reduced exactly to one turn first,
+  // quadrant is set for multiples of 90 degrees
+  static BigFloat toRadians(const Rational &x, uint32_t radix, int32_t precision, uint32_t bits, angle_type angleType, int32_t *quadrant)
+  {
+    if (angleType != angle_type::deg)
+    {
+      return (BigFloat::fromRat(x.get(), bits));
+    }
+    Rational d = x.clone();
+    Rational turn(360);
+    d %= turn;
+    Rational q = d.clone();
+    q /= Rational(90);
+    Rational f = q.clone();
+    fracrat(f.ptr(), radix, precision);
+    if (zerrat(f.get()))
+    {
+      *quadrant = (rattoi32(q.get(), radix, precision) % 4 + 4) % 4;
+    }
+    BigFloat a = BigFloat::mul(BigFloat::fromRat(d.get(), bits), BigFloat::pi(bits), bits);
+    return (BigFloat::div(a, 180, bits));
+  }
+
+  // angle from radians
+  static BigFloat fromRadians(const BigFloat &a, uint32_t bits, angle_type angleType)
+  {
+    if (angleType != angle_type::deg)
+    {
+      return (BigFloat::round(a, bits));
+    }
+    BigFloat r = BigFloat::mul(a, BigFloat(180), bits + 8);
+    return (BigFloat::div(r, BigFloat::pi(bits + 8), bits));
+  }
+
+  // get some special values
+  static void getSpecialValue(Rational &x, operation op, uint32_t radix, int32_t precision)
   {
-    operation_return_code result = operation_return_code::success;
-    PRAT p = nullptr;
-    PRAT q = nullptr;
     switch (op)
     {
-    case operation::ln: // natural logarithm
-      try
-      {
-        lograt(px, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::pi:
+      x.assign(pi());
       break;
 
-    case operation::log10: // logarithm base 10
-      try
-      {
-        log10rat(px, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::e:
+      x.assign(rat_exp());
       break;
 
-    case operation::logy: // logarithm base y
-      try
-      {
-        DUPRAT(p, py);
-        DUPRAT(q, *px);
-        lograt(&p, precision);
-        lograt(&q, precision);
-        divrat(&p, q, precision);
-        DUPRAT(*px, p);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::rnd:
+      getRandomPrat(x, radix, precision);
       break;
 
-    case operation::integer: // remove fract part
-      try
+    default:
+      break;
+    }
+  }
+
+  // generate a random number
+  static void getRandomPrat(Rational &x, uint32_t radix, int32_t precision)
+  {
+    String s("0.");
+    for (int i = 0; i < precision; i++)
+    {
+      long r = random(0, 10);
+      s += String(r);
+    }
+    std::string_view sm(s.c_str());
+    std::string_view se("0");
+    x = Rational::adopt(StringToRat(false, sm, false, se, radix, precision));
+  }
+
+  // allocations of an operation since the last reset
+  static const MEM_PROFILE &getMemProfile(operation op)
+  {
+    static const MEM_PROFILE none = {};
+    size_t index = static_cast<size_t>(op);
+    return (index < MEM_PROFILE_COUNT ? _memProfile[index] : none);
+  }
+
+  // clear the allocations of all operations
+  static void resetMemProfile()
+  {
+    memset(_memProfile, 0, sizeof(_memProfile));
+    _cache.resetStats();
+  }
+
+  static CALC_CACHE_STATS getCacheStats()
+  {
+    return (_cache.getStats());
+  }
+
+  // forget the remembered results
+  static void clearCache()
+  {
+    _cache.clear();
+  }
+
+  // one line for the heap and one for every operation done since the last reset
+  static String getMemProfileReport()
+  {
+    char buffer[128];
+    RATALLOCSTATS stats = GetRatAllocStats();
+    snprintf(buffer, sizeof(buffer), "heap free %u min %u, ratpak live %u\n",
+             static_cast<unsigned int>(esp_get_free_heap_size()), static_cast<unsigned int>(esp_get_minimum_free_heap_size()),
+             static_cast<unsigned int>(stats.liveBytes));
+    String report(buffer);
+    CALC_CACHE_STATS cache = _cache.getStats();
+    snprintf(buffer, sizeof(buffer), "cache hits %u misses %u entries %u bytes %u\n",
+             static_cast<unsigned int>(cache.hits), static_cast<unsigned int>(cache.misses),
+             static_cast<unsigned int>(cache.entries), static_cast<unsigned int>(cache.bytes));
+    report += buffer;
+    snprintf(buffer, sizeof(buffer), "cost series %.3f limb %.4f us\n", _seriesCost, _limbCost);
+    report += buffer;
+    for (size_t i = 0; i < MEM_PROFILE_COUNT; i++)
+    {
+      const MEM_PROFILE &profile = _memProfile[i];
+      if (profile.calls > 0)
       {
-        intrat(px, radix, precision);
+        snprintf(buffer, sizeof(buffer), "%-14s calls %u allocs %u bytes %llu peak %u\n",
+                 getOperationName(static_cast<operation>(i)), static_cast<unsigned int>(profile.calls),
+                 static_cast<unsigned int>(profile.allocs), static_cast<unsigned long long>(profile.bytes),
+                 static_cast<unsigned int>(profile.peakBytes));
+        report += buffer;
       }
-      catch (uint32_t error)
+    }
+    return (report);
+  }
+
+  // name of a math operation for reports
+  static const char *getOperationName(operation op)
+  {
+    const char *name = getOperationInfo(op).name;
+    return (name != nullptr ? name : "other");
+  }
+
+private:
+  inline static calc_backend::calc_backend _backend = CALC_BACKEND;
+  inline static bool _scaledIntegers = false;
+  inline static uint8_t _certifiedDigits = 0;
+  inline static CALC_DEFERRED _deferred;
+  inline static MEM_PROFILE _memProfile[MEM_PROFILE_COUNT] = {};
+  inline static previewCb _preview = nullptr;
+  inline static longOperationCb _longOperation = nullptr;
+  inline static CalcCache _cache;
+  inline static uint32_t _timeLimit = 0;
+  inline static float _seriesCost = CALC_COST_SERIES;
+  inline static float _limbCost = CALC_COST_LIMB;
+
+  // the binary floats are 3 to 9 times faster than the rationals for the series
+  static constexpr double FLOAT_COST_RATIO = 0.25;
+  // series units per squared ratpak digit of a large angle
+  static constexpr double TRIG_REDUCTION_COST = 3.0;
+  // relative error of a rounding to double (2^-53), a conversion from a rational
+  // is off by one ulp, a libm function is assumed to be off by at most two ulp
+  static constexpr double DOUBLE_ROUNDING = 0x1p-53;
+  static constexpr double DOUBLE_INPUT_ERROR = 2 * DOUBLE_ROUNDING;
+  static constexpr double DOUBLE_LIBM_ERROR = 4 * DOUBLE_ROUNDING;
+  // the bounds of a double result are printed with more digits than certified,
+  // so the compared digits are not rounded
+  static constexpr int DOUBLE_PRINT_DIGITS = 40;
+  // decimal digits of a ratpak digit
+  inline static const double LOG10_BASEX = std::log10(static_cast<double>(BASEX));
+
+  // the description of every operation, indexed by operation
+  static const std::array<OPERATION_INFO, OPERATION_COUNT> _operations;
+
+  static constexpr std::array<OPERATION_INFO, OPERATION_COUNT> makeOperations()
+  {
+    std::array<OPERATION_INFO, OPERATION_COUNT> t = {};
+    // name, arity, flags, cost, weight, domain check, rational kernel, float kernel
+    // the weights are measured at 32 and 100 digits
+    t[static_cast<size_t>(operation::pow)] = {"pow", op_arity::two, OP_CACHED, op_cost::power, 5.8f, nullptr, calcPow, calcPowFloat};
+    t[static_cast<size_t>(operation::pow2)] = {"pow2", op_arity::one, OP_CACHED, op_cost::series, 1.0f, nullptr, calcPow2, nullptr};
+    t[static_cast<size_t>(operation::yroot)] = {"yroot", op_arity::two, OP_CACHED, op_cost::series, 3.7f, nullptr, calcYroot, calcYrootFloat};
+    t[static_cast<size_t>(operation::pow3)] = {"pow3", op_arity::one, OP_CACHED, op_cost::series, 1.0f, nullptr, calcPow3, nullptr};
+    t[static_cast<size_t>(operation::invert)] = {"invert", op_arity::one, 0, op_cost::arithmetic, 1.0f, nullptr, calcInvert, nullptr};
+    t[static_cast<size_t>(operation::factorial)] = {"factorial", op_arity::one, OP_CACHED, op_cost::factorial, 115.0f, nullptr, calcFactorial, nullptr};
+    t[static_cast<size_t>(operation::exp)] = {"exp", op_arity::one, OP_CACHED, op_cost::series, 3.5f, nullptr, calcExp, calcExpFloat};
+    t[static_cast<size_t>(operation::ln)] = {"ln", op_arity::one, OP_CACHED, op_cost::series, 1.0f, nullptr, calcLn, calcLnFloat};
+    t[static_cast<size_t>(operation::e)] = {"e", op_arity::zero, 0, op_cost::none, 0.0f, nullptr, nullptr, nullptr};
+    t[static_cast<size_t>(operation::modulo)] = {"modulo", op_arity::two, 0, op_cost::arithmetic, 1.0f, nullptr, calcModulo, nullptr};
+    t[static_cast<size_t>(operation::logy)] = {"logy", op_arity::two, OP_CACHED, op_cost::series, 1.4f, nullptr, calcLogy, calcLogyFloat};
+    t[static_cast<size_t>(operation::permutations)] = {"permutations", op_arity::two, OP_CACHED, op_cost::permutations, 1.0f, isCombinatoricDomain, calcPermutations, nullptr};
+    t[static_cast<size_t>(operation::sin)] = {"sin", op_arity::one, OP_ANGLE | OP_CACHED, op_cost::trigonometric, 0.3f, isTrigDomain, calcSin, calcSinFloat};
+    t[static_cast<size_t>(operation::asin)] = {"asin", op_arity::one, OP_ANGLE | OP_CACHED, op_cost::series, 8.0f, isTrigDomain, calcAsin, calcAsinFloat};
+    t[static_cast<size_t>(operation::sinh)] = {"sinh", op_arity::one, OP_CACHED, op_cost::series, 3.6f, isTrigDomain, calcSinh, calcSinhFloat};
+    t[static_cast<size_t>(operation::cos)] = {"cos", op_arity::one, OP_ANGLE | OP_CACHED, op_cost::trigonometric, 0.3f, isTrigDomain, calcCos, calcCosFloat};
+    t[static_cast<size_t>(operation::acos)] = {"acos", op_arity::one, OP_ANGLE | OP_CACHED, op_cost::series, 8.0f, isTrigDomain, calcAcos, calcAcosFloat};
+    t[static_cast<size_t>(operation::cosh)] = {"cosh", op_arity::one, OP_CACHED, op_cost::series, 3.6f, isTrigDomain, calcCosh, calcCoshFloat};
+    t[static_cast<size_t>(operation::tan)] = {"tan", op_arity::one, OP_ANGLE | OP_CACHED, op_cost::trigonometric, 0.6f, isTrigDomain, calcTan, calcTanFloat};
+    t[static_cast<size_t>(operation::atan)] = {"atan", op_arity::one, OP_ANGLE | OP_CACHED, op_cost::series, 7.5f, isTrigDomain, calcAtan, calcAtanFloat};
+    t[static_cast<size_t>(operation::tanh)] = {"tanh", op_arity::one, OP_CACHED, op_cost::series, 4.0f, isTrigDomain, calcTanh, calcTanhFloat};
+    t[static_cast<size_t>(operation::log10)] = {"log10", op_arity::one, OP_CACHED, op_cost::series, 1.1f, nullptr, calcLog10, calcLog10Float};
+    t[static_cast<size_t>(operation::pi)] = {"pi", op_arity::zero, 0, op_cost::none, 0.0f, nullptr, nullptr, nullptr};
+    t[static_cast<size_t>(operation::rnd)] = {"rnd", op_arity::zero, 0, op_cost::none, 0.0f, nullptr, nullptr, nullptr};
+    t[static_cast<size_t>(operation::integer)] = {"integer", op_arity::one, 0, op_cost::arithmetic, 1.0f, nullptr, calcInteger, nullptr};
+    t[static_cast<size_t>(operation::combinations)] = {"combinations", op_arity::two, OP_CACHED, op_cost::combinations, 1.4f, isCombinatoricDomain, calcCombinations, nullptr};
+    t[static_cast<size_t>(operation::percent_diff)] = {"percent_diff", op_arity::two, 0, op_cost::arithmetic, 1.0f, nullptr, calcPercentDiff, nullptr};
+    t[static_cast<size_t>(operation::square_root)] = {"square_root", op_arity::one, OP_CACHED, op_cost::series, 3.0f, isPositiveDomain, calcSquareRoot, calcSquareRootFloat};
+    t[static_cast<size_t>(operation::percent)] = {"percent", op_arity::two, OP_SCALED, op_cost::arithmetic, 1.0f, nullptr, calcPercent, nullptr};
+    t[static_cast<size_t>(operation::division)] = {"division", op_arity::two, OP_SCALED, op_cost::arithmetic, 1.0f, nullptr, calcDivision, nullptr};
+    t[static_cast<size_t>(operation::multiplication)] = {"multiplication", op_arity::two, OP_SCALED, op_cost::arithmetic, 1.0f, nullptr, calcMultiplication, nullptr};
+    t[static_cast<size_t>(operation::subtraction)] = {"subtraction", op_arity::two, OP_SCALED, op_cost::arithmetic, 1.0f, nullptr, calcSubtraction, nullptr};
+    t[static_cast<size_t>(operation::addition)] = {"addition", op_arity::two, OP_SCALED, op_cost::arithmetic, 1.0f, nullptr, calcAddition, nullptr};
+    // operations of the engines
+#if CALC_TYPE == CALC_TYPE_RPN
+    t[static_cast<size_t>(operation::clear_x)].flags = OP_ERROR_RECOVERY;
+    t[static_cast<size_t>(operation::clear_stack)].flags = OP_ERROR_RECOVERY;
+#else
+    t[static_cast<size_t>(operation::clear)].flags = OP_ERROR_RECOVERY;
+    t[static_cast<size_t>(operation::allclear)].flags = OP_ERROR_RECOVERY;
+#endif
+    return (t);
+  }
+
+  // domain checks, true if the operands are valid
+
+  static bool isPositiveDomain(PRAT x, PRAT py, uint32_t radix, int32_t precision, PRAT maxTrig)
+  {
+    return (SIGN(x) == 1);
+  }
+
+  static bool isTrigDomain(PRAT x, PRAT py, uint32_t radix, int32_t precision, PRAT maxTrig)
+  {
+    return (rat_lt(x, maxTrig, precision));
+  }
+
+  // positive integers and y >= x
+  static bool isCombinatoricDomain(PRAT x, PRAT py, uint32_t radix, int32_t precision, PRAT maxTrig)
+  {
+    Rational p = Rational::copyOf(x);
+    fracrat(p.ptr(), radix, precision);
+    Rational q = Rational::copyOf(py);
+    fracrat(q.ptr(), radix, precision);
+    if (!zerrat(p.get()) || !zerrat(q.get()))
+    {
+      return (false);
+    }
+    return ((SIGN(x) != (-1)) && (SIGN(py) != (-1)) && !rat_lt(py, x, precision));
+  }
+
+  // the angle type is only part of the cache key if the result depends on it
+  static uint8_t getCacheVariant(const OPERATION_INFO &info, angle_type angleType)
+  {
+    uint8_t angle = (info.flags & OP_ANGLE) != 0 ? static_cast<uint8_t>(angleType) : 0;
+    return (angle | (static_cast<uint8_t>(_backend) << 4));
+  }
+
+  // the operation with scaled integers, false if an operand or the result is no
+  // exact decimal or too large, the rationals do the operation then
+  static bool calculateScaled(Rational &x, PRAT py, operation op)
+  {
+    ScaledInt a;
+    ScaledInt b;
+    ScaledInt r;
+    if (!ScaledInt::fromRat(py, &a) || !ScaledInt::fromRat(x.get(), &b))
+    {
+      return (false);
+    }
+    bool done = false;
+    switch (op)
+    {
+    case operation::addition:
+      done = ScaledInt::add(a, b, &r);
+      break;
+
+    case operation::subtraction:
+      done = ScaledInt::sub(a, b, &r);
+      break;
+
+    case operation::multiplication:
+      done = ScaledInt::mul(a, b, &r);
+      break;
+
+    case operation::division:
+      // ratpak reports the division by zero
+      done = !b.isZero() && ScaledInt::div(a, b, &r);
+      break;
+
+    case operation::percent:
+      done = ScaledInt::mul(a, b, &r) && r.divPow10(2);
+      break;
+
+    default: // avoid warning
+      break;
+    }
+    if (done)
+    {
+      x = Rational::adopt(r.toRat());
+    }
+    return (done);
+  }
+
+  // rational kernels, the result is stored in x
+
+  static uint32_t calcLn(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    lograt(x.ptr(), precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcLog10(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    log10rat(x.ptr(), precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcLogy(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p = Rational::copyOf(py);
+    Rational q = x.clone();
+    lograt(p.ptr(), precision);
+    lograt(q.ptr(), precision);
+    divrat(p.ptr(), q.get(), precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  // remove fract part
+  static uint32_t calcInteger(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    intrat(x.ptr(), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcSquareRoot(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    rootrat(x.ptr(), rat_two, radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcYroot(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p = Rational::copyOf(py);
+    rootrat(p.ptr(), x.get(), radix, precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  static uint32_t calcExp(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p = Rational::copyOf(rat_exp());
+    powrat(p.ptr(), x.get(), radix, precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  static uint32_t calcPow(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p = Rational::copyOf(py);
+    powrat(p.ptr(), x.get(), radix, precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  static uint32_t calcPow2(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    powrat(x.ptr(), rat_two, radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcPow3(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p(3);
+    powrat(x.ptr(), p.get(), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcFactorial(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    factrat(x.ptr(), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcModulo(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p;
+    modrat_into(p.ptr(), py, x.get());
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  // the binary operations build the result in a new rational,
+  // the operands are only read and never copied
+
+  static uint32_t calcAddition(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p;
+    addrat_into(p.ptr(), x.get(), py, precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  static uint32_t calcSubtraction(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p;
+    subrat_into(p.ptr(), py, x.get(), precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  static uint32_t calcMultiplication(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p;
+    mulrat_into(p.ptr(), x.get(), py, precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  static uint32_t calcDivision(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p;
+    divrat_into(p.ptr(), py, x.get(), precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  // reciprocal
+  static uint32_t calcInvert(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p;
+    divrat_into(p.ptr(), rat_one, x.get(), precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  static uint32_t calcPercent(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational p;
+    Rational h(100);
+    mulrat_into(p.ptr(), x.get(), py, precision);
+    divrat(p.ptr(), h.get(), precision);
+    x = std::move(p);
+    return (S_OK);
+  }
+
+  static uint32_t calcPercentDiff(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    Rational q;
+    subrat_into(q.ptr(), x.get(), py, precision);
+    divrat(q.ptr(), py, precision);
+    Rational p(100);
+    mulrat(q.ptr(), p.get(), precision);
+    x = std::move(q);
+    return (S_OK);
+  }
+
+  static AngleType toAngleType(angle_type angleType)
+  {
+    return (angleType == angle_type::deg ? AngleType::Degrees : AngleType::Radians);
+  }
+
+  static uint32_t calcSin(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    sinanglerat(x.ptr(), toAngleType(angleType), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcAsin(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    asinanglerat(x.ptr(), toAngleType(angleType), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcSinh(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    sinhrat(x.ptr(), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcCos(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    cosanglerat(x.ptr(), toAngleType(angleType), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcAcos(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    acosanglerat(x.ptr(), toAngleType(angleType), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcCosh(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    coshrat(x.ptr(), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcTan(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    tananglerat(x.ptr(), toAngleType(angleType), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcAtan(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    atananglerat(x.ptr(), toAngleType(angleType), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcTanh(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    tanhrat(x.ptr(), radix, precision);
+    return (S_OK);
+  }
+
+  static uint32_t calcPermutations(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    int32_t r = rattoi32(x.get(), radix, precision);
+    // we have to put a limit to the loop, calculation is slow on a MC
+    if (r > CALC_MAX_PERMUTATIONS || r < 0)
+    {
+      return (CALC_E_DOMAIN);
+    }
+    Rational p;
+    Rational q;
+    x.assign(rat_one);
+    for (int32_t i = 0; i < r && !RATPAK_FAILED(); i++)
+    {
+      q.assign(py);
+      p = Rational(i);
+      subrat(q.ptr(), p.get(), precision);
+      mulrat(x.ptr(), q.get(), precision);
+    }
+    return (S_OK);
+  }
+
+  static uint32_t calcCombinations(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    // optimize loop
+    int32_t r1 = rattoi32(x.get(), radix, precision);
+    Rational p = Rational::copyOf(py);
+    subrat(p.ptr(), x.get(), precision);
+    int32_t r2 = rattoi32(p.get(), radix, precision);
+    int32_t r = std::min(r1, r2);
+
+    // we have to put a limit to the loop, calculation is slow on a MC
+    if (r > CALC_MAX_COMBINATIONS || r < 0)
+    {
+      return (CALC_E_DOMAIN);
+    }
+
+    // calculate
+    Rational q;
+    x.assign(rat_one);
+    for (int32_t i = 0; i < r && !RATPAK_FAILED(); i++)
+    {
+      q.assign(py);
+      p = Rational(i);
+      subrat(q.ptr(), p.get(), precision);
+      mulrat(x.ptr(), q.get(), precision);
+      p = Rational(i + 1);
+      divrat(x.ptr(), p.get(), precision);
+    }
+    return (S_OK);
+  }
+
+  // binary float kernels, the exact value of the float is stored in x
+
+  static uint32_t calcLnFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::ln(BigFloat::fromRat(x.get(), bits), bits)));
+  }
+
+  static uint32_t calcLog10Float(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::div(BigFloat::ln(BigFloat::fromRat(x.get(), bits), bits + 8), BigFloat::ln(BigFloat(10), bits + 8), bits)));
+  }
+
+  static uint32_t calcLogyFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::div(BigFloat::ln(BigFloat::fromRat(py, bits), bits + 8), BigFloat::ln(BigFloat::fromRat(x.get(), bits), bits + 8), bits)));
+  }
+
+  static uint32_t calcSquareRootFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::sqrt(BigFloat::fromRat(x.get(), bits), bits)));
+  }
+
+  // true if a power with exponent x is done with binary floats,
+  // integer powers and negative bases stay exact
+  static bool isFloatPower(PRAT x, PRAT py, operation op, uint32_t radix, int32_t precision)
+  {
+    if (SIGN(py) != 1 || zerrat(py) || zerrat(x))
+    {
+      return (false);
+    }
+    Rational f = Rational::copyOf(x);
+    fracrat(f.ptr(), radix, precision);
+    return (op == operation::yroot || !zerrat(f.get()));
+  }
+
+  static uint32_t calcYrootFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    if (!isFloatPower(x.get(), py, operation::yroot, radix, precision))
+    {
+      return (calcYroot(x, py, radix, precision, angleType));
+    }
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    BigFloat a = BigFloat::div(BigFloat(1), BigFloat::fromRat(x.get(), bits + 8), bits + 8);
+    return (setFloat(x, BigFloat::pow(BigFloat::fromRat(py, bits), a, bits)));
+  }
+
+  static uint32_t calcExpFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::exp(BigFloat::fromRat(x.get(), bits), bits)));
+  }
+
+  static uint32_t calcPowFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    if (!isFloatPower(x.get(), py, operation::pow, radix, precision))
+    {
+      return (calcPow(x, py, radix, precision, angleType));
+    }
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::pow(BigFloat::fromRat(py, bits), BigFloat::fromRat(x.get(), bits), bits)));
+  }
+
+  // sine, cosine or tangent, exact values for multiples of 90 degrees
+  static uint32_t trigFloat(Rational &x, operation op, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    int32_t quadrant = -1;
+    BigFloat a = toRadians(x, radix, precision, bits + 8, angleType, &quadrant);
+    BigFloat r = op == operation::sin ? BigFloat::sin(a, bits) : op == operation::cos ? BigFloat::cos(a, bits) : BigFloat::tan(a, bits);
+    if (quadrant >= 0)
+    {
+      static const int8_t sinValues[] = {0, 1, 0, -1};
+      if (op == operation::tan && (quadrant & 1) != 0)
       {
-        result = CalcError::toOperationReturnCode(error);
+        return (CALC_E_DOMAIN);
       }
-      break;
+      r = BigFloat(op == operation::cos ? sinValues[(quadrant + 1) & 3] : sinValues[quadrant]);
+    }
+    return (setFloat(x, r));
+  }
+
+  static uint32_t calcSinFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    return (trigFloat(x, operation::sin, radix, precision, angleType));
+  }
+
+  static uint32_t calcCosFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    return (trigFloat(x, operation::cos, radix, precision, angleType));
+  }
 
-    case operation::square_root: // square root
+  static uint32_t calcTanFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    return (trigFloat(x, operation::tan, radix, precision, angleType));
+  }
+
+  static uint32_t calcAsinFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, fromRadians(BigFloat::asin(BigFloat::fromRat(x.get(), bits + 8), bits + 8), bits, angleType)));
+  }
+
+  static uint32_t calcAcosFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, fromRadians(BigFloat::acos(BigFloat::fromRat(x.get(), bits + 8), bits + 8), bits, angleType)));
+  }
+
+  static uint32_t calcAtanFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, fromRadians(BigFloat::atan(BigFloat::fromRat(x.get(), bits + 8), bits + 8), bits, angleType)));
+  }
+
+  static uint32_t calcSinhFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::sinh(BigFloat::fromRat(x.get(), bits), bits)));
+  }
+
+  static uint32_t calcCoshFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::cosh(BigFloat::fromRat(x.get(), bits), bits)));
+  }
+
+  static uint32_t calcTanhFloat(Rational &x, PRAT py, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    uint32_t bits = BigFloat::precisionToBits(precision);
+    return (setFloat(x, BigFloat::tanh(BigFloat::fromRat(x.get(), bits), bits)));
+  }
+
+  // store the exact value of a float in x
+  static uint32_t setFloat(Rational &x, const BigFloat &r)
+  {
+    x = Rational::adopt(r.toRat());
+    return (S_OK);
+  }
+
+  // pass the result calculated with doubles to the preview callback
+  static void preview(PRAT x, PRAT py, operation op, angle_type angleType)
+  {
+#if RATPAK_EXCEPTIONS
+    try
     {
-      try
+#endif
+      double r;
+      if (calculateDouble(x, py, op, angleType, &r))
       {
-        if (SIGN(*px) == 1)
+        Rational p = Rational::adopt(BigFloat::fromDouble(r).toRat());
+        if (!RATPAK_FAILED())
         {
-          rootrat(px, rat_two, radix, precision);
+          _preview(p.get());
         }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
       }
+#if RATPAK_EXCEPTIONS
     }
-    break;
+    catch (...)
+    {
+    }
+#endif
+    // a failed preview must not fail the calculation
+    ClearRatError();
+  }
 
-    case operation::yroot: // y-th root
-      try
-      {
-        DUPRAT(p, py);
-        rootrat(&p, *px, radix, precision);
-        DUPRAT(*px, p);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+  // approximate the slow operations with doubles, false if there is no approximation
+  static bool calculateDouble(PRAT px, PRAT py, operation op, angle_type angleType, double *result)
+  {
+    double x = BigFloat::fromRat(px, 53).toDouble();
+    double y = (py != nullptr) ? BigFloat::fromRat(py, 53).toDouble() : 0;
+    if (RATPAK_FAILED())
+    {
+      return (false);
+    }
+    double toDeg = (angleType == angle_type::deg) ? 180 / M_PI : 1;
+    double r;
+    switch (op)
+    {
+    case operation::ln:
+      r = std::log(x);
       break;
-
-    case operation::exp: // exponential
-      try
-      {
-        DUPRAT(p, rat_exp);
-        powrat(&p, *px, radix, precision);
-        DUPRAT(*px, p);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::log10:
+      r = std::log10(x);
       break;
-
-    case operation::pow: // power
-      try
-      {
-        DUPRAT(p, py);
-        powrat(&p, *px, radix, precision);
-        DUPRAT(*px, p);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::logy:
+      r = std::log(y) / std::log(x);
       break;
-
-    case operation::pow2: // square
-      try
-      {
-        powrat(px, rat_two, radix, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::square_root:
+      r = std::sqrt(x);
       break;
-
-    case operation::pow3: // cubic
-      try
-      {
-        p = i32torat(3);
-        powrat(px, p, radix, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::exp:
+      r = std::exp(x);
       break;
-
-    case operation::factorial: // factorial
-      try
-      {
-        factrat(px, radix, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::pow:
+      r = std::pow(y, x);
       break;
-
-    case operation::modulo: // modulo
-      try
-      {
-        DUPRAT(p, py);
-        modrat(&p, *px);
-        DUPRAT(*px, p);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::pow2:
+      r = x * x;
       break;
-
-    case operation::addition: // addition
-      try
-      {
-        addrat(px, py, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::pow3:
+      r = x * x * x;
       break;
-
-    case operation::subtraction: // subtraction
-      try
-      {
-        DUPRAT(p, py);
-        subrat(&p, *px, precision);
-        DUPRAT(*px, p);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::yroot: // odd roots of negative numbers are negative
+      r = (y < 0 && std::fmod(std::fabs(x), 2) == 1) ? -std::pow(-y, 1 / x) : std::pow(y, 1 / x);
       break;
-
-    case operation::multiplication: // multiplication
-      try
-      {
-        mulrat(px, py, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::sin:
+    case operation::cos:
+    case operation::tan:
+      r = trigDouble(x, op, angleType);
       break;
-
-    case operation::division: // division
-      try
-      {
-        DUPRAT(p, py);
-        divrat(&p, *px, precision);
-        DUPRAT(*px, p);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::asin:
+      r = std::asin(x) * toDeg;
       break;
-
-    case operation::invert: // reciprocal
-      try
-      {
-        DUPRAT(p, rat_one);
-        divrat(&p, *px, precision);
-        DUPRAT(*px, p);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::acos:
+      r = std::acos(x) * toDeg;
       break;
-
-    case operation::percent: // percent
-      try
-      {
-        p = i32torat(100);
-        mulrat(px, py, precision);
-        divrat(px, p, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::atan:
+      r = std::atan(x) * toDeg;
       break;
-
-    case operation::percent_diff: // percent difference
-      try
-      {
-        DUPRAT(p, py);
-        DUPRAT(q, *px);
-        subrat(&q, p, precision);
-        DUPRAT(p, py);
-        divrat(&q, p, precision);
-        DUPRAT(*px, q);
-        destroyrat(p);
-        p = i32torat(100);
-        mulrat(px, p, precision);
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::sinh:
+      r = std::sinh(x);
       break;
-
-    case operation::sin: // sine
-      try
-      {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          sinanglerat(px, angleType == angle_type::deg ? AngleType::Degrees : AngleType::Radians, radix, precision);
-        }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case operation::cosh:
+      r = std::cosh(x);
+      break;
+    case operation::tanh:
+      r = std::tanh(x);
+      break;
+    case operation::factorial:
+      r = std::tgamma(x + 1);
       break;
+    case operation::permutations:
+      r = std::round(std::exp(std::lgamma(y + 1) - std::lgamma(y - x + 1)));
+      break;
+    case operation::combinations:
+      r = std::round(std::exp(std::lgamma(y + 1) - std::lgamma(x + 1) - std::lgamma(y - x + 1)));
+      break;
+    default: // the basic operations are fast anyway
+      return (false);
+    }
+    if (!std::isfinite(r))
+    {
+      return (false);
+    }
+    *result = r;
+    return (true);
+  }
+
+  // sine, cosine or tangent with doubles, multiples of 90 degrees are exact
+  static double trigDouble(double x, operation op, angle_type angleType)
+  {
+    double s, c;
+    double d = std::fmod(x, 360);
+    if (angleType == angle_type::deg && std::fmod(d, 90) == 0)
+    {
+      int q = (static_cast<int>(d / 90) + 4) % 4;
+      s = (q == 1) ? 1 : ((q == 3) ? -1 : 0);
+      c = (q == 0) ? 1 : ((q == 2) ? -1 : 0);
+    }
+    else
+    {
+      double a = (angleType == angle_type::deg) ? d * M_PI / 180 : x;
+      s = std::sin(a);
+      c = std::cos(a);
+    }
+    switch (op)
+    {
+    case operation::sin:
+      return (s);
+    case operation::cos:
+      return (c);
+    default:
+      return ((c != 0) ? s / c : NAN);
+    }
+  }
 
-    case operation::asin: // arcsine
-      try
+  // the operation with doubles if the error bound proves the certified digits, the
+  // exact calculation is kept for refine. False if the rationals have to calculate.
+  static bool calculateCertified(Rational &x, PRAT py, operation op, uint32_t radix, int32_t precision, angle_type angleType)
+  {
+    bool result = false;
+#if RATPAK_EXCEPTIONS
+    try
+    {
+#endif
+      double r;
+      double bound;
+      if (calculateDouble(x.get(), py, op, angleType, &r) && getDoubleError(x.get(), py, op, angleType, r, &bound) && isCertified(r, bound))
       {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          asinanglerat(px, angleType == angle_type::deg ? AngleType::Degrees : AngleType::Radians, radix, precision);
-        }
-        else
+        Rational p = Rational::adopt(BigFloat::fromDouble(r).toRat());
+        if (!RATPAK_FAILED())
         {
-          throw(CALC_E_DOMAIN);
+          _deferred.operand = x.clone();
+          _deferred.y = (py != nullptr) ? Rational::copyOf(py) : Rational();
+          _deferred.op = op;
+          _deferred.radix = radix;
+          _deferred.precision = precision;
+          _deferred.angleType = angleType;
+          _deferred.certifiedDigits = _certifiedDigits;
+          x = std::move(p);
+          _deferred.result = x.clone();
+          result = true;
         }
       }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
-      break;
+#if RATPAK_EXCEPTIONS
+    }
+    catch (...)
+    {
+      _deferred = CALC_DEFERRED();
+      result = false;
+    }
+#endif
+    ClearRatError();
+    return (result);
+  }
 
-    case operation::sinh: // hyperbolic sine
-      try
+  // relative error bound of calculateDouble, false if there is none. The rounding
+  // errors of the operands grow with the condition number of the function, twice
+  // the first order bound covers the higher orders and the rounded operands.
+  static bool getDoubleError(PRAT px, PRAT py, operation op, angle_type angleType, double r, double *bound)
+  {
+    double x = toDouble(px);
+    double y = (py != nullptr) ? toDouble(py) : 0;
+    double ex = DOUBLE_INPUT_ERROR;
+    double ey = DOUBLE_INPUT_ERROR;
+    double lib = DOUBLE_LIBM_ERROR;
+    // the degrees of the inverse functions are rounded twice
+    double toDeg = (angleType == angle_type::deg) ? 2 * DOUBLE_ROUNDING : 0;
+    double e;
+    switch (op)
+    {
+    case operation::ln:
+      e = ex / std::fabs(r) + lib;
+      break;
+    case operation::log10:
+      e = ex / std::fabs(r * M_LN10) + lib;
+      break;
+    case operation::logy:
+      e = ey / std::fabs(std::log(y)) + ex / std::fabs(std::log(x)) + 2 * lib + DOUBLE_ROUNDING;
+      break;
+    case operation::square_root: // correctly rounded
+      e = ex / 2 + DOUBLE_ROUNDING;
+      break;
+    case operation::exp:
+      e = std::fabs(x) * ex + lib;
+      break;
+    case operation::pow:
+      e = std::fabs(x) * ey + std::fabs(x * std::log(std::fabs(y))) * ex + lib;
+      break;
+    case operation::yroot:
+      e = ey / std::fabs(x) + std::fabs(std::log(std::fabs(y)) / x) * (ex + DOUBLE_ROUNDING) + lib;
+      break;
+    case operation::sin:
+    case operation::cos:
+    case operation::tan:
+    {
+      // absolute error of the angle in radians, degrees are reduced exactly
+      // to one turn and converted with three roundings
+      double a = x;
+      double da = std::fabs(x) * ex;
+      if (angleType == angle_type::deg)
       {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          sinhrat(px, radix, precision);
-        }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
+        a = std::fmod(x, 360) * M_PI / 180;
+        da = da * M_PI / 180 + std::fabs(a) * 3 * DOUBLE_ROUNDING;
       }
-      catch (uint32_t error)
+      double s = std::sin(a);
+      double c = std::cos(a);
+      if (op == operation::sin)
       {
-        result = CalcError::toOperationReturnCode(error);
+        e = std::fabs(c / s) * da + lib;
       }
-      break;
-
-    case operation::cos: // cosine
-      try
+      else if (op == operation::cos)
       {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          cosanglerat(px, angleType == angle_type::deg ? AngleType::Degrees : AngleType::Radians, radix, precision);
-        }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
+        e = std::fabs(s / c) * da + lib;
       }
-      catch (uint32_t error)
+      else
       {
-        result = CalcError::toOperationReturnCode(error);
+        e = da / std::fabs(s * c) + 2 * lib + DOUBLE_ROUNDING;
       }
       break;
+    }
+    case operation::asin:
+      e = std::fabs(x / (std::sqrt(1 - x * x) * std::asin(x))) * ex + lib + toDeg;
+      break;
+    case operation::acos:
+      e = std::fabs(x / (std::sqrt(1 - x * x) * std::acos(x))) * ex + lib + toDeg;
+      break;
+    case operation::atan:
+      e = std::fabs(x / ((1 + x * x) * std::atan(x))) * ex + lib + toDeg;
+      break;
+    case operation::sinh:
+      e = std::fabs(x * std::cosh(x) / r) * ex + lib;
+      break;
+    case operation::cosh:
+      e = std::fabs(x * std::tanh(x)) * ex + lib;
+      break;
+    case operation::tanh:
+      e = std::fabs(x / (std::sinh(x) * std::cosh(x))) * ex + lib;
+      break;
+    default: // no bound
+      return (false);
+    }
+    *bound = 2 * e;
+    // subnormal results have lost digits
+    return (std::isfinite(*bound) && (std::fabs(r) >= std::numeric_limits<double>::min()));
+  }
 
-    case operation::acos: // arcosine
-      try
-      {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          acosanglerat(px, angleType == angle_type::deg ? AngleType::Degrees : AngleType::Radians, radix, precision);
-        }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+  // true if all numbers within the relative bound around r have the same certified
+  // digits. Rounding to fewer digits only depends on them, so the display is the
+  // same as for the exact result.
+  static bool isCertified(double r, double bound)
+  {
+    char lo[64];
+    char hi[64];
+    double d = std::fabs(r) * bound;
+    snprintf(lo, sizeof(lo), "%.*e", DOUBLE_PRINT_DIGITS - 1, r - d);
+    snprintf(hi, sizeof(hi), "%.*e", DOUBLE_PRINT_DIGITS - 1, r + d);
+    // sign, first digit and separator come before the other digits
+    size_t n = ((lo[0] == '-') ? 2 : 1) + 1 + (_certifiedDigits - 1);
+    const char *loExp = strchr(lo, 'e');
+    const char *hiExp = strchr(hi, 'e');
+    return ((_certifiedDigits < DOUBLE_PRINT_DIGITS) && (loExp != nullptr) && (hiExp != nullptr) &&
+            (strncmp(lo, hi, n) == 0) && (strcmp(loExp, hiExp) == 0));
+  }
+
+  // work of an operation on valid operands, in series units and in limb units.
+  // A series unit grows with the cube of the precision, a limb unit is about
+  // one multiplication of two ratpak digits.
+  static void getCostUnits(PRAT x, PRAT py, operation op, int32_t precision, double *series, double *limbs)
+  {
+    const OPERATION_INFO &info = getOperationInfo(op);
+    // ratpak digits kept during a series
+    double n = static_cast<double>(precision) / g_ratio + 2;
+    double dx = x->pp->cdigit + x->pq->cdigit;
+    double dy = (py != nullptr) ? py->pp->cdigit + py->pq->cdigit : 0;
+    double weight = info.weight;
+    if (_backend == calc_backend::binary_float && info.floatKernel != nullptr)
+    {
+      weight *= FLOAT_COST_RATIO;
+    }
+    *series = 0;
+    *limbs = 0;
+    switch (info.cost)
+    {
+    case op_cost::arithmetic:
+      *limbs = (dx + 1) * (dy + 1);
       break;
 
-    case operation::cosh: // hyperbolic cosine
-      try
-      {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          coshrat(px, radix, precision);
-        }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case op_cost::series:
+      *series = weight * n * n * n;
+      *limbs = dx * dx;
       break;
 
-    case operation::tan: // tangent
-      try
-      {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          tananglerat(px, angleType == angle_type::deg ? AngleType::Degrees : AngleType::Radians, radix, precision);
-        }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
-      }
-      catch (uint32_t error)
-      {
-        result = CalcError::toOperationReturnCode(error);
-      }
+    case op_cost::trigonometric:
+    {
+      // the reduction to one turn grows with the integer digits of the angle
+      double m = std::max(static_cast<double>(LOGRAT2(x)), 0.0);
+      *series = weight * n * n * n + ((m > 0) ? TRIG_REDUCTION_COST * (n + m) * (n + m) : 0);
+      *limbs = dx * dx;
       break;
+    }
 
-    case operation::atan: // arctangent
-      try
+    case op_cost::power:
+    {
+      // py to the power of x, integer powers are exact
+      double e = std::fabs(toDouble(x));
+      if (e != std::floor(e) || e > INT32_MAX)
       {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          atananglerat(px, angleType == angle_type::deg ? AngleType::Degrees : AngleType::Radians, radix, precision);
-        }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
+        *series = weight * n * n * n;
+        break;
       }
-      catch (uint32_t error)
+      // ratpak rejects results beyond e^rat_max_exp after taking the logarithm
+      double lnResult = e * std::fabs(numLog10(py->pp) - numLog10(py->pq)) * M_LN10;
+      if (lnResult > toDouble(rat_max_exp))
       {
-        result = CalcError::toOperationReturnCode(error);
+        break;
       }
+      // the last squarings dominate
+      double r = e * (numLog10(py->pp) + numLog10(py->pq)) / LOG10_BASEX;
+      *series = n * n * n;
+      *limbs = r * r;
       break;
+    }
 
-    case operation::tanh: // hyperbolic tangent
-      try
-      {
-        if (rat_lt(*px, maxTrig, precision))
-        {
-          tanhrat(px, radix, precision);
-        }
-        else
-        {
-          throw(CALC_E_DOMAIN);
-        }
-      }
-      catch (uint32_t error)
+    case op_cost::factorial:
+    {
+      double v = toDouble(x);
+      // ratpak rejects large values and negative integers right away
+      if (!(v <= toDouble(rat_max_fact)) || (v < 0 && v == std::floor(v)))
       {
-        result = CalcError::toOperationReturnCode(error);
+        break;
       }
-      break;
-
-    case operation::permutations: // permutations
-      try
+      if (v == std::floor(v))
       {
-        // check for positive integers and y > x
-        DUPRAT(p, *px);
-        fracrat(&p, radix, precision);
-        DUPRAT(q, py);
-        fracrat(&q, radix, precision);
-        if (!zerrat(p) || !zerrat(q))
-        {
-          throw(CALC_E_DOMAIN);
-        }
-        if ((SIGN(*px) == (-1)) || (SIGN(py) == (-1)) || (rat_lt(py, *px, precision)))
-        {
-          throw(CALC_E_DOMAIN);
-        }
-
-        // calculate permutations,
-        int32_t r = rattoi32(*px, radix, precision);
-        // we have to put a limit to the loop, calculation is slow on a MC
-        if (r > 1000 || r < 0)
-        {
-          throw(CALC_E_DOMAIN);
-        }
-        DUPRAT(*px, rat_one);
-        for (int32_t i = 0; i < r; i++)
-        {
-          DUPRAT(q, py);
-          destroyrat(p);
-          p = i32torat(i);
-          subrat(&q, p, precision);
-          mulrat(px, q, precision);
-        }
+        // v multiplications of a product growing to v!
+        *limbs = v * std::lgamma(v + 1) / M_LN10 / LOG10_BASEX / 2;
       }
-      catch (uint32_t error)
+      else
       {
-        result = CalcError::toOperationReturnCode(error);
+        *series = weight * n * n * n;
       }
       break;
+    }
 
-    case operation::combinations: // combinations
-      try
+    case op_cost::permutations:
+    case op_cost::combinations:
+    {
+      // py! / (py - x)! and py! / (x! (py - x)!), a multiplication of the
+      // growing result per loop
+      double k = toDouble(x);
+      double v = toDouble(py);
+      double digits = std::lgamma(v + 1) - std::lgamma(v - k + 1);
+      if (info.cost == op_cost::combinations)
       {
-        // check for positive integers and y > x
-        DUPRAT(p, *px);
-        fracrat(&p, radix, precision);
-        DUPRAT(q, py);
-        fracrat(&q, radix, precision);
-        if (!zerrat(p) || !zerrat(q))
-        {
-          throw(CALC_E_DOMAIN);
-        }
-        if ((SIGN(*px) == (-1)) || (SIGN(py) == (-1)) || (rat_lt(py, *px, precision)))
-        {
-          throw(CALC_E_DOMAIN);
-        }
-
-        // optimize loop
-        int32_t r1 = rattoi32(*px, radix, precision);
-        DUPRAT(p, py);
-        subrat(&p, *px, precision);
-        int32_t r2 = rattoi32(p, radix, precision);
-        int32_t r = std::min(r1, r2);
-
-        // we have to put a limit to the loop, calculation is slow on a MC
-        if (r > 5000 || r < 0)
-        {
-          throw(CALC_E_DOMAIN);
-        }
-
-        // calculate
-        DUPRAT(*px, rat_one);
-        for (int32_t i = 0; i < r; i++)
-        {
-          DUPRAT(q, py);
-          destroyrat(p);
-          p = i32torat(i);
-          subrat(&q, p, precision);
-          mulrat(px, q, precision);
-          destroyrat(p);
-          p = i32torat(i + 1);
-          divrat(px, p, precision);
-        }
+        k = std::min(k, v - k);
+        digits -= std::lgamma(k + 1);
       }
-      catch (uint32_t error)
+      if (k > ((info.cost == op_cost::combinations) ? CALC_MAX_COMBINATIONS : CALC_MAX_PERMUTATIONS))
       {
-        result = CalcError::toOperationReturnCode(error);
+        break;
       }
+      *limbs = weight * k * digits / M_LN10 / LOG10_BASEX;
       break;
+    }
 
     default: // avoid warning
       break;
     }
-    destroyrat(p);
-    destroyrat(q);
-    return (result);
   }
 
-  // get some special values
-  static void getSpecialValue(PRAT *px, operation op, uint32_t radix, int32_t precision)
+  // decimal digits of a ratpak number
+  static double numLog10(PNUMBER p)
   {
-    switch (op)
+    if (p->cdigit == 0 || p->mant[p->cdigit - 1] == 0)
     {
-    case operation::pi:
-      DUPRAT(*px, pi);
-      break;
-
-    case operation::e:
-      DUPRAT(*px, rat_exp);
-      break;
+      return (0);
+    }
+    return (std::log10(static_cast<double>(p->mant[p->cdigit - 1])) + (p->cdigit - 1 + p->exp) * LOG10_BASEX);
+  }
 
-    case operation::rnd:
-      getRandomPrat(px, radix, precision);
-      break;
+  // nearest double, for estimates only
+  static double toDouble(PRAT p)
+  {
+    return (BigFloat::fromRat(p, 53).toDouble());
+  }
 
-    default:
-      break;
+  // run the rational kernel of op, returns a ratpak error code
+  static uint32_t calibrationRun(Rational &x, operation op, uint32_t radix, int32_t precision)
+  {
+    uint32_t error;
+    ClearRatError();
+#if RATPAK_EXCEPTIONS
+    try
+    {
+      error = getOperationInfo(op).kernel(x, nullptr, radix, precision, angle_type::rad);
     }
+    catch (uint32_t e)
+    {
+      error = e;
+    }
+    catch (const std::bad_alloc &)
+    {
+      error = CALC_E_OUTOFMEMORY;
+    }
+#else
+    error = getOperationInfo(op).kernel(x, nullptr, radix, precision, angle_type::rad);
+#endif
+    if (GetRatError() != S_OK)
+    {
+      error = GetRatError();
+      ClearRatError();
+    }
+    return (error);
   }
 
-  // generate a random number
-  static void getRandomPrat(PRAT *px, uint32_t radix, int32_t precision)
+  // add the allocations since before to the profile of op
+  static void profileMemory(operation op, const RATALLOCSTATS &before)
   {
-    String s("0.");
-    for (int i = 0; i < precision; i++)
+    size_t index = static_cast<size_t>(op);
+    if (index < MEM_PROFILE_COUNT)
     {
-      long r = random(0, 10);
-      s += String(r);
+      RATALLOCSTATS after = GetRatAllocStats();
+      MEM_PROFILE &profile = _memProfile[index];
+      profile.calls++;
+      profile.allocs += after.allocs - before.allocs;
+      profile.bytes += after.bytes - before.bytes;
+      uint32_t peak = after.peakBytes - before.liveBytes;
+      if (peak > profile.peakBytes)
+      {
+        profile.peakBytes = peak;
+      }
     }
-    std::string_view sm(s.c_str());
-    std::string_view se("0");
-    destroyrat(*px);
-    *px = StringToRat(false, sm, false, se, radix, precision);
   }
-};
\ No newline at end of file
+};
+
+constexpr std::array<OPERATION_INFO, OPERATION_COUNT> CalcMath::_operations = CalcMath::makeOperations();
\ No newline at end of file
@@ -0,0 +1,391 @@
+// CalcProgram.hpp
+
+// keystroke programs for the RPN calculator, the keys are recorded
+// as bytecode and replayed on the calc engine without keyboard and display
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <vector>
+#include <ratpak.h>
+#include <CalcDefs.h>
+#include <CalcEnums.h>
+#include <CalcIO.hpp>
+#include <CalcEngineRPN.hpp>
+#include <Rational.hpp>
+
+// definitions
+constexpr auto PROGRAM_NAMESPACE = "CalcProgram";
+
+// bytecode instructions, each one is followed by a single argument byte
+enum class program_code : uint8_t
+{
+  number,    // push a literal, the argument is its index in the literal pool
+  operation, // engine or program operation
+  digit      // memory register of a pending store or recall
+};
+
+// a recorded program and its virtual machine.
+// The literals are converted to rationals once when the program is recorded
+// or loaded, a run only shares them with the registers.
+class CalcProgram
+{
+public:
+  using checkCancelCb = std::function<bool()>;
+
+  CalcProgram() : _precision(0), _recording(false)
+  {
+  }
+
+  // load the program from the non-volatile storage
+  void begin(int32_t precision)
+  {
+    _precision = precision;
+    Preferences preferences;
+    if (preferences.begin(PROGRAM_NAMESPACE, true))
+    {
+      size_t length = preferences.getBytesLength("code");
+      if ((length > 0) && (length <= CALC_PROGRAM_SIZE))
+      {
+        _code.resize(length);
+        preferences.getBytes("code", _code.data(), length);
+        _literals = preferences.getString("literals", "");
+        if (!compile())
+        {
+          clear();
+        }
+      }
+      preferences.end();
+    }
+  }
+
+  // start recording a new program
+  void beginRecording()
+  {
+    clear();
+    _recording = true;
+  }
+
+  // stop recording and store the program
+  void endRecording()
+  {
+    _recording = false;
+    Preferences preferences;
+    if (preferences.begin(PROGRAM_NAMESPACE, false))
+    {
+      preferences.putBytes("code", _code.data(), _code.size());
+      preferences.putString("literals", _literals);
+      preferences.end();
+    }
+  }
+
+  bool isRecording() const
+  {
+    return (_recording);
+  }
+
+  // number of bytecode bytes
+  size_t getSize() const
+  {
+    return (_code.size());
+  }
+
+  // record a number as it was typed, false if the program is full
+  bool recordNumber(const CALC_NUMBER &number)
+  {
+    if (!_recording || (_numbers.size() >= CALC_PROGRAM_LITERALS))
+    {
+      return (false);
+    }
+    String s;
+    if (number.baseNegative)
+    {
+      s += "-";
+    }
+    s += number.base;
+    if (!number.exponent.isEmpty())
+    {
+      s += number.exponentNegative ? "e-" : "e";
+      s += number.exponent;
+    }
+    // a number that does not convert is not recorded
+    Rational r = toRational(s);
+    if ((r.get() == nullptr) || !record(program_code::number, _numbers.size()))
+    {
+      return (false);
+    }
+    _numbers.push_back(std::move(r));
+    _literals += s + " ";
+    return (true);
+  }
+
+  // record an operation, false if the program is full
+  bool recordOperation(operation op)
+  {
+    return (record(program_code::operation, static_cast<uint8_t>(op)));
+  }
+
+  // record the memory register of a store or recall, false if the program is full
+  bool recordDigit(uint8_t digit)
+  {
+    return (record(program_code::digit, digit));
+  }
+
+  // run the program on the engine until its end or an error, false if it was cancelled
+  bool run(CalcEngineRPN &engine, checkCancelCb checkCancel)
+  {
+    size_t pc = 0;
+    while ((pc < _code.size()) && (engine.getOperationReturnCode() == operation_return_code::success))
+    {
+      if (checkCancel && checkCancel())
+      {
+        return (false);
+      }
+      program_code code = static_cast<program_code>(_code[pc]);
+      uint8_t argument = _code[pc + 1];
+      pc += 2;
+      switch (code)
+      {
+      case program_code::number:
+        engine.handleNumericInput(_numbers[argument].clone());
+        break;
+
+      case program_code::digit:
+      {
+        uint8_t index = MEM_REGISTER_NONE;
+        engine.handleDigitInput(argument, &index);
+      }
+      break;
+
+      case program_code::operation:
+        pc = runOperation(engine, static_cast<operation>(argument), pc);
+        break;
+      }
+    }
+    return (true);
+  }
+
+  // true for the operations that only have a meaning in a program
+  static bool isProgramOperation(operation op)
+  {
+    switch (op)
+    {
+    case operation::test_x_le_y:
+    case operation::test_x_eq_0:
+    case operation::decrement_skip_zero:
+    case operation::goto_start:
+      return (true);
+
+    default: // avoid warning
+      return (false);
+    }
+  }
+
+private:
+  std::vector<uint8_t> _code;
+  std::vector<Rational> _numbers;
+  String _literals; // the literals as typed, separated by spaces
+  int32_t _precision;
+  bool _recording;
+
+  void clear()
+  {
+    _code.clear();
+    _numbers.clear();
+    _literals = "";
+  }
+
+  bool record(program_code code, uint8_t argument)
+  {
+    if (!_recording || (_code.size() + 2 > CALC_PROGRAM_SIZE))
+    {
+      return (false);
+    }
+    _code.push_back(static_cast<uint8_t>(code));
+    _code.push_back(argument);
+    return (true);
+  }
+
+  // do an operation, returns the position of the next instruction
+  size_t runOperation(CalcEngineRPN &engine, operation op, size_t pc)
+  {
+    switch (op)
+    {
+    case operation::test_x_le_y:
+      // the next instruction runs only if x <= y
+      if (!refine(engine))
+      {
+        break;
+      }
+      if (!rat_le(engine.getRegX(), engine.getRegY(), _precision))
+      {
+        pc = skipInstruction(pc);
+      }
+      break;
+
+    case operation::test_x_eq_0:
+      // the next instruction runs only if x = 0
+      if (!refine(engine))
+      {
+        break;
+      }
+      if (!zerrat(engine.getRegX()))
+      {
+        pc = skipInstruction(pc);
+      }
+      break;
+
+    case operation::decrement_skip_zero:
+    {
+      // decrement memory register 0, the next instruction is skipped when it reaches 0
+      Rational p(1);
+      if (CalcMath::calculate(p, engine.getMemReg(0), operation::subtraction, RAT_RADIX, _precision) == operation_return_code::success)
+      {
+        bool zero = zerrat(p.get());
+        engine.setMemReg(std::move(p), 0);
+        if (zero)
+        {
+          pc = skipInstruction(pc);
+        }
+      }
+    }
+    break;
+
+    case operation::goto_start:
+      pc = 0;
+      break;
+
+    case operation::change_sign:
+      // recorded for a result only, a shared number is copied before the change
+      if (refine(engine))
+      {
+        engine.negateResult();
+      }
+      break;
+
+    default:
+      engine.onOperation(op);
+      break;
+    }
+    return (pc);
+  }
+
+  // the result is made exact before it is compared or copied,
+  // false if that failed, the error stops the program
+  static bool refine(CalcEngineRPN &engine)
+  {
+    operation_return_code rc = CalcMath::refine();
+    if (rc != operation_return_code::success)
+    {
+      engine.setOperationReturnCode(rc);
+      return (false);
+    }
+    return (true);
+  }
+
+  // position after the instruction at pc, a store or recall includes its register
+  size_t skipInstruction(size_t pc) const
+  {
+    pc += 2;
+    while ((pc < _code.size()) && (static_cast<program_code>(_code[pc]) == program_code::digit))
+    {
+      pc += 2;
+    }
+    return (pc);
+  }
+
+  // check the bytecode and convert the literals
+  bool compile()
+  {
+    _numbers.clear();
+    int start = 0;
+    int end;
+    while ((end = _literals.indexOf(' ', start)) != -1)
+    {
+      if (_numbers.size() >= CALC_PROGRAM_LITERALS)
+      {
+        return (false);
+      }
+      // an empty or invalid literal rejects the program
+      String literal = _literals.substring(start, end);
+      Rational r = isLiteral(literal) ? toRational(literal) : Rational();
+      if (r.get() == nullptr)
+      {
+        return (false);
+      }
+      _numbers.push_back(std::move(r));
+      start = end + 1;
+    }
+    if (_code.size() % 2 != 0)
+    {
+      return (false);
+    }
+    for (size_t pc = 0; pc < _code.size(); pc += 2)
+    {
+      uint8_t argument = _code[pc + 1];
+      switch (static_cast<program_code>(_code[pc]))
+      {
+      case program_code::number:
+        if (argument >= _numbers.size())
+        {
+          return (false);
+        }
+        break;
+
+      case program_code::operation:
+        if (argument >= OPERATION_COUNT)
+        {
+          return (false);
+        }
+        break;
+
+      case program_code::digit:
+        if (argument >= MEM_REGISTER_COUNT)
+        {
+          return (false);
+        }
+        break;
+
+      default:
+        return (false);
+      }
+    }
+    return (true);
+  }
+
+  // a literal has digits and may have a sign, a separator and an exponent
+  static bool isLiteral(const String &s)
+  {
+    bool digits = false;
+    for (size_t i = 0; i < s.length(); i++)
+    {
+      char c = s[i];
+      if (isDigit(c))
+      {
+        digits = true;
+      }
+      else if ((c != '-') && (c != 'e') && (c != DECIMAL_SEPARATOR))
+      {
+        return (false);
+      }
+    }
+    return (digits);
+  }
+
+  // rational from a literal like -1.5e-3
+  Rational toRational(const String &s) const
+  {
+    int e = s.indexOf('e');
+    String base = (e == -1) ? s : s.substring(0, e);
+    String exponent = (e == -1) ? "0" : s.substring(e + 1);
+    bool baseNegative = base.startsWith("-");
+    bool exponentNegative = exponent.startsWith("-");
+    std::string_view bsw(base.c_str() + (baseNegative ? 1 : 0));
+    std::string_view esw(exponent.c_str() + (exponentNegative ? 1 : 0));
+    return (Rational::adopt(StringToRat(baseNegative, bsw, exponentNegative, esw, RAT_RADIX, _precision)));
+  }
+};
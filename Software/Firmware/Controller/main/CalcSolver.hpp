@@ -0,0 +1,265 @@
+// CalcSolver.hpp
+
+// root of a function given by the keystroke program, the secant
+// iteration starts with a low precision and ends with the full precision
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <Arduino.h>
+#include <ratpak.h>
+#include <CalcDefs.h>
+#include <CalcEnums.h>
+#include <CalcError.hpp>
+#include <CalcMath.hpp>
+#include <CalcEngineRPN.hpp>
+#include <CalcHistory.hpp>
+#include <CalcProgram.hpp>
+#include <Rational.hpp>
+
+// f(x) is a run of the program with x in X, Y, Z and T, the result is X.
+// The iteration uses the secant through the last two points. Once f changes
+// its sign the root is kept in a bracket, a step leaving the bracket or a
+// bracket not halved within three steps is replaced by a bisection.
+// The iteration runs with CALC_SOLVE_LOW_PRECISION until the root is known
+// to that precision, the last steps use the full precision.
+class CalcSolver
+{
+public:
+  using checkCancelCb = std::function<bool()>;
+
+  CalcSolver() : _iterations(0), _time(0)
+  {
+  }
+
+  // root near the guesses in X and Y, the root goes to X and f(root) to Y.
+  // The other registers are kept, on an error the guesses are kept.
+  operation_return_code solve(CalcEngineRPN &engine, CalcProgram &program, int32_t precision, checkCancelCb checkCancel)
+  {
+    uint32_t start = millis();
+    _iterations = 0;
+    CALC_SNAPSHOT state;
+    engine.saveState(state);
+    // the guesses are copied, a result calculated with doubles is made exact first
+    operation_return_code rc = CalcMath::refine();
+    int32_t p = std::min(precision, CALC_SOLVE_LOW_PRECISION);
+    Rational x0 = Rational::copyOf(engine.getRegY());
+    Rational x1 = Rational::copyOf(engine.getRegX());
+    if (rat_equ(x0.get(), x1.get(), p))
+    {
+      // a second guess close to the first one
+      Rational one(1);
+      Rational thousand(1000);
+      Rational t;
+      calc(t, absolute(x0), operation::addition, one, p, &rc);
+      calc(t, t, operation::division, thousand, p, &rc);
+      calc(x1, x0, operation::addition, t, p, &rc);
+    }
+    // the smaller guess that is not 0 is the scale of a root at 0
+    Rational scale = absolute(x0);
+    Rational t = absolute(x1);
+    if (zerrat(scale.get()) || (!zerrat(t.get()) && rat_lt(t.get(), scale.get(), p)))
+    {
+      scale = std::move(t);
+    }
+    Rational f0, f1;
+    evaluate(engine, program, x0, f0, p, checkCancel, &rc);
+    evaluate(engine, program, x1, f1, p, checkCancel, &rc);
+    // the other end of the bracket, f(a) and f(x1) have different signs
+    bool bracket = false;
+    Rational a, width;
+    uint8_t slowSteps = 0;
+    while ((rc == operation_return_code::success) && !zerrat(f1.get()))
+    {
+      if (_iterations >= CALC_SOLVE_ITERATIONS)
+      {
+        rc = operation_return_code::domain;
+        break;
+      }
+      Rational x2;
+      bool bisect = bracket && (slowSteps >= 3);
+      if (!bisect)
+      {
+        if (rat_equ(f0.get(), f1.get(), p))
+        {
+          // flat secant, no root found without a sign change
+          if (!bracket)
+          {
+            rc = operation_return_code::domain;
+            break;
+          }
+          bisect = true;
+        }
+        else
+        {
+          // x2 = x1 - f1 * (x1 - x0) / (f1 - f0)
+          Rational dx, df, t;
+          calc(dx, x1, operation::subtraction, x0, p, &rc);
+          calc(df, f1, operation::subtraction, f0, p, &rc);
+          calc(t, f1, operation::multiplication, dx, p, &rc);
+          calc(t, t, operation::division, df, p, &rc);
+          calc(x2, x1, operation::subtraction, t, p, &rc);
+          bisect = bracket && !isBetween(x2, a, x1, p, &rc);
+        }
+      }
+      if (bisect)
+      {
+        Rational two(2);
+        calc(x2, a, operation::addition, x1, p, &rc);
+        calc(x2, x2, operation::division, two, p, &rc);
+        slowSteps = 0;
+      }
+      Rational f2;
+      evaluate(engine, program, x2, f2, p, checkCancel, &rc);
+      if (rc != operation_return_code::success)
+      {
+        break;
+      }
+      // the root is between x1 and x2 or still between a and x2
+      if (SIGN(f2.get()) != SIGN(f1.get()))
+      {
+        a = x1.clone();
+        bracket = true;
+      }
+      Rational step;
+      calc(step, x2, operation::subtraction, x1, p, &rc);
+      x0 = std::move(x1);
+      f0 = std::move(f1);
+      x1 = std::move(x2);
+      f1 = std::move(f2);
+      if (bracket)
+      {
+        // count the steps since the bracket was halved
+        Rational w;
+        calc(w, x1, operation::subtraction, a, p, &rc);
+        w = absolute(w);
+        Rational t = w.clone();
+        Rational two(2);
+        calc(t, t, operation::multiplication, two, p, &rc);
+        if ((width.get() == nullptr) || rat_le(t.get(), width.get(), p))
+        {
+          width = std::move(w);
+          slowSteps = 0;
+        }
+        else
+        {
+          slowSteps++;
+        }
+      }
+      if ((rc == operation_return_code::success) && isConverged(step, x1, scale, p, &rc))
+      {
+        if (p == precision)
+        {
+          break;
+        }
+        // the last steps with the full precision, the signs of the low precision may be wrong
+        p = precision;
+        evaluate(engine, program, x0, f0, p, checkCancel, &rc);
+        evaluate(engine, program, x1, f1, p, checkCancel, &rc);
+        bracket = false;
+        width.reset();
+        slowSteps = 0;
+      }
+    }
+    engine.restoreState(state);
+    engine.setPrecision(precision);
+    if (rc == operation_return_code::success)
+    {
+      engine.setResult(std::move(x1), std::move(f1));
+    }
+    else
+    {
+      engine.setOperationReturnCode(rc);
+    }
+    _time = millis() - start;
+    return (rc);
+  }
+
+  // number of function evaluations and time of the last solve
+  String getReport() const
+  {
+    return ("solve: " + String(_iterations) + " iterations, " + String(_time) + " ms\n");
+  }
+
+private:
+  uint32_t _iterations;
+  uint32_t _time;
+
+  // fx = f(x), a run of the program with the given precision
+  void evaluate(CalcEngineRPN &engine, CalcProgram &program, const Rational &x, Rational &fx, int32_t precision, checkCancelCb checkCancel, operation_return_code *rc)
+  {
+    if (*rc != operation_return_code::success)
+    {
+      return;
+    }
+    _iterations++;
+    engine.setPrecision(precision);
+    engine.setOperationReturnCode(operation_return_code::success);
+    engine.fillStack(x.get());
+    if (!program.run(engine, checkCancel))
+    {
+      *rc = operation_return_code::cancelled;
+      return;
+    }
+    *rc = engine.getOperationReturnCode();
+    if (*rc == operation_return_code::success)
+    {
+      // the sign of a result shown with doubles is certified, its value is made exact
+      *rc = CalcMath::refine();
+      if (*rc == operation_return_code::success)
+      {
+        fx = Rational::copyOf(engine.getRegX());
+      }
+    }
+  }
+
+  // the step is below the last quarter of the digits of x or of the scale,
+  // the rounding of f does not let the secant converge further
+  static bool isConverged(const Rational &step, const Rational &x, const Rational &scale, int32_t precision, operation_return_code *rc)
+  {
+    if (zerrat(step.get()))
+    {
+      return (true);
+    }
+    Rational digits = Rational::copyOf(rat_ten);
+    ratpowi32(digits.ptr(), precision - precision / 4, precision);
+    Rational t;
+    calc(t, absolute(step), operation::multiplication, digits, precision, rc);
+    return ((*rc == operation_return_code::success) && (rat_le(t.get(), absolute(x).get(), precision) || rat_le(t.get(), scale.get(), precision)));
+  }
+
+  // x strictly between a and b
+  static bool isBetween(const Rational &x, const Rational &a, const Rational &b, int32_t precision, operation_return_code *rc)
+  {
+    Rational da, db;
+    calc(da, x, operation::subtraction, a, precision, rc);
+    calc(db, x, operation::subtraction, b, precision, rc);
+    return ((*rc == operation_return_code::success) && !zerrat(da.get()) && !zerrat(db.get()) && (SIGN(da.get()) != SIGN(db.get())));
+  }
+
+  static Rational absolute(const Rational &r)
+  {
+    Rational a = Rational::copyOf(r.get());
+    (*a.ptr())->pp->sign = 1;
+    (*a.ptr())->pq->sign = 1;
+    return (a);
+  }
+
+  // result = a op b, nothing is done after an error
+  static void calc(Rational &result, const Rational &a, operation op, const Rational &b, int32_t precision, operation_return_code *rc)
+  {
+    if (*rc != operation_return_code::success)
+    {
+      return;
+    }
+    // calculate does y op x
+    Rational r = b.clone();
+    *rc = CalcMath::calculate(r, a.get(), op, RAT_RADIX, precision);
+    if (*rc == operation_return_code::success)
+    {
+      result = std::move(r);
+    }
+  }
+};
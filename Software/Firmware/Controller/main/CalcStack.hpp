@@ -0,0 +1,417 @@
+// CalcStack.hpp
+
+// levels below T of the unlimited RPN stack, the levels are kept in
+// lists of nodes allocated in chunks and shared with the undo copies
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <Arduino.h>
+#include <new>
+#include <vector>
+#include <ratpak.h>
+#include <CalcDefs.h>
+#include <Rational.hpp>
+
+// a stack level, a linked node is not changed and can be shared
+typedef struct CALC_STACK_NODE
+{
+  Rational value;
+  struct CALC_STACK_NODE *next; // towards the other end of its list, the next free node in the free list
+  uint32_t refs;                // lists and nodes pointing to the node
+} CALC_STACK_NODE;
+
+// The levels are two lists, the upper list starts below T and the lower list
+// starts at the bottom level. Push and pop at both ends and roll take a node
+// at one end, an empty end gets half of the other list. A copy of the stack
+// shares all nodes, a change only links new nodes in front of the shared ones.
+// The nodes of all stacks come from chunks that go back to the heap when the
+// stacks are cleared. The depth is limited by the free heap, a full stack
+// drops its bottom level like the four level stack drops T.
+// Sharing is not thread safe, a stack and its copies belong to one task.
+class CalcStack
+{
+public:
+  CalcStack() : _upper(nullptr), _lower(nullptr), _upperDepth(0), _lowerDepth(0), _createdBytes(0), _changed(false)
+  {
+  }
+
+  ~CalcStack()
+  {
+    unref(_upper);
+    unref(_lower);
+  }
+
+  CalcStack(CalcStack &&other) noexcept : CalcStack()
+  {
+    swap(other);
+  }
+
+  CalcStack &operator=(CalcStack &&other) noexcept
+  {
+    if (this != &other)
+    {
+      CalcStack old(std::move(*this));
+      swap(other);
+    }
+    return (*this);
+  }
+
+  CalcStack(const CalcStack &) = delete;
+  CalcStack &operator=(const CalcStack &) = delete;
+
+  // copy that shares all levels, no allocation
+  CalcStack clone() const
+  {
+    CalcStack copy;
+    copy.assign(*this);
+    copy._createdBytes = _createdBytes;
+    return (copy);
+  }
+
+  // continue with the levels of a copy, the levels are shared
+  void restore(const CalcStack &other)
+  {
+    assign(other);
+    _changed = true;
+  }
+
+  // push a level below T, the value is dropped if there is no heap for it
+  void pushTop(Rational &&value)
+  {
+    if (esp_get_free_heap_size() < CALC_STACK_HEAP_RESERVE)
+    {
+      // the heap is low, the bottom level makes room
+      popBottom();
+    }
+    push(_upper, _upperDepth, std::move(value));
+  }
+
+  // push a level below the bottom, the value is dropped if there is no heap for it
+  void pushBottom(Rational &&value)
+  {
+    push(_lower, _lowerDepth, std::move(value));
+  }
+
+  // pop the level below T, empty if there is none
+  // or if there is no heap to get at it
+  Rational popTop()
+  {
+    if ((_upperDepth == 0) && !refill(_upper, _upperDepth, _lower, _lowerDepth))
+    {
+      return (Rational());
+    }
+    return (pop(_upper, _upperDepth));
+  }
+
+  // pop the bottom level, empty if there is none
+  // or if there is no heap to get at it
+  Rational popBottom()
+  {
+    if ((_lowerDepth == 0) && !refill(_lower, _lowerDepth, _upper, _upperDepth))
+    {
+      return (Rational());
+    }
+    return (pop(_lower, _lowerDepth));
+  }
+
+  // pop the level below T and push a level below the bottom
+  Rational rollDown(Rational &&value)
+  {
+    Rational result = popTop();
+    if (result.empty())
+    {
+      return (std::move(value));
+    }
+    pushBottom(std::move(value));
+    return (result);
+  }
+
+  // pop the bottom level and push a level below T
+  Rational rollUp(Rational &&value)
+  {
+    Rational result = popBottom();
+    if (result.empty())
+    {
+      return (std::move(value));
+    }
+    push(_upper, _upperDepth, std::move(value));
+    return (result);
+  }
+
+  // drop all levels, the chunks go back to the heap if no copy uses them
+  void clear()
+  {
+    if (getDepth() > 0)
+    {
+      _changed = true;
+    }
+    unref(_upper);
+    unref(_lower);
+    _upper = nullptr;
+    _lower = nullptr;
+    _upperDepth = 0;
+    _lowerDepth = 0;
+    releaseChunks();
+  }
+
+  bool empty() const
+  {
+    return (getDepth() == 0);
+  }
+
+  // number of levels
+  size_t getDepth() const
+  {
+    return (_upperDepth + _lowerDepth);
+  }
+
+  // the level below T is level 0
+  PRAT get(size_t level) const
+  {
+    if (level < _upperDepth)
+    {
+      return (at(_upper, level)->value.get());
+    }
+    level -= _upperDepth;
+    if (level < _lowerDepth)
+    {
+      return (at(_lower, _lowerDepth - 1 - level)->value.get());
+    }
+    return (nullptr);
+  }
+
+  // call fn with the upper levels, starting below T
+  void forEach(size_t count, const std::function<void(size_t level, const Rational &value)> &fn) const
+  {
+    size_t level = 0;
+    for (CALC_STACK_NODE *node = _upper; (node != nullptr) && (level < count); node = node->next)
+    {
+      fn(level++, node->value);
+    }
+    // the lower list runs from the bottom, its last levels are walked backwards
+    size_t rest = std::min(count - level, _lowerDepth);
+    CALC_STACK_NODE *first = at(_lower, _lowerDepth - rest);
+    while (rest > 0)
+    {
+      rest--;
+      fn(level++, at(first, rest)->value);
+    }
+  }
+
+  // true if the levels changed since the last call
+  bool checkChanged()
+  {
+    bool changed = _changed;
+    _changed = false;
+    return (changed);
+  }
+
+  // heap of all nodes ever pushed, the difference of two copies
+  // is the heap of the levels the newer one does not share
+  uint32_t getCreatedBytes() const
+  {
+    return (_createdBytes);
+  }
+
+private:
+  CALC_STACK_NODE *_upper; // level below T
+  CALC_STACK_NODE *_lower; // bottom level
+  size_t _upperDepth;
+  size_t _lowerDepth;
+  uint32_t _createdBytes;
+  bool _changed;
+
+  // the nodes of all stacks
+  inline static std::vector<CALC_STACK_NODE *> _chunks;
+  inline static CALC_STACK_NODE *_free = nullptr;
+  inline static size_t _freeCount = 0;
+
+  void swap(CalcStack &other)
+  {
+    std::swap(_upper, other._upper);
+    std::swap(_lower, other._lower);
+    std::swap(_upperDepth, other._upperDepth);
+    std::swap(_lowerDepth, other._lowerDepth);
+    std::swap(_createdBytes, other._createdBytes);
+    std::swap(_changed, other._changed);
+  }
+
+  // share the levels of other
+  void assign(const CalcStack &other)
+  {
+    ref(other._upper);
+    ref(other._lower);
+    unref(_upper);
+    unref(_lower);
+    _upper = other._upper;
+    _lower = other._lower;
+    _upperDepth = other._upperDepth;
+    _lowerDepth = other._lowerDepth;
+  }
+
+  // link a new node in front of a list
+  void push(CALC_STACK_NODE *&list, size_t &depth, Rational &&value)
+  {
+    CALC_STACK_NODE *node = allocate();
+    if (node == nullptr)
+    {
+      return;
+    }
+    _createdBytes += sizeof(CALC_STACK_NODE) + Rational::bytes(value.get());
+    node->value = std::move(value);
+    node->next = list;
+    list = node;
+    depth++;
+    _changed = true;
+  }
+
+  // take the front node of a list, its value is shared if a copy uses it
+  Rational pop(CALC_STACK_NODE *&list, size_t &depth)
+  {
+    CALC_STACK_NODE *node = list;
+    list = node->next;
+    ref(list);
+    Rational value = (node->refs == 1) ? std::move(node->value) : node->value.clone();
+    unref(node);
+    depth--;
+    _changed = true;
+    return (value);
+  }
+
+  // an empty list gets the half of the other list next to it, the nodes
+  // of both are new as the old ones may be shared. False if there is no heap.
+  bool refill(CALC_STACK_NODE *&list, size_t &depth, CALC_STACK_NODE *&other, size_t &otherDepth)
+  {
+    if (otherDepth == 0)
+    {
+      return (false);
+    }
+    if (!reserve(otherDepth))
+    {
+      return (false);
+    }
+    size_t keep = otherDepth / 2;
+    CALC_STACK_NODE *node = other;
+    // the kept front of the other list in the same order
+    CALC_STACK_NODE *kept = nullptr;
+    CALC_STACK_NODE **tail = &kept;
+    for (size_t i = 0; i < keep; i++)
+    {
+      CALC_STACK_NODE *copy = allocate();
+      copy->value = node->value.clone();
+      _createdBytes += sizeof(CALC_STACK_NODE);
+      *tail = copy;
+      tail = &copy->next;
+      node = node->next;
+    }
+    *tail = nullptr;
+    // the rest in reverse order, its last node is next to the empty end
+    CALC_STACK_NODE *moved = nullptr;
+    for (; node != nullptr; node = node->next)
+    {
+      CALC_STACK_NODE *copy = allocate();
+      copy->value = node->value.clone();
+      _createdBytes += sizeof(CALC_STACK_NODE);
+      copy->next = moved;
+      moved = copy;
+    }
+    unref(other);
+    other = kept;
+    list = moved;
+    depth = otherDepth - keep;
+    otherDepth = keep;
+    return (true);
+  }
+
+  // node index of a list
+  static CALC_STACK_NODE *at(CALC_STACK_NODE *node, size_t index)
+  {
+    while ((node != nullptr) && (index > 0))
+    {
+      node = node->next;
+      index--;
+    }
+    return (node);
+  }
+
+  static void ref(CALC_STACK_NODE *node)
+  {
+    if (node != nullptr)
+    {
+      node->refs++;
+    }
+  }
+
+  // the nodes no longer used go to the free list
+  static void unref(CALC_STACK_NODE *node)
+  {
+    while ((node != nullptr) && (--node->refs == 0))
+    {
+      CALC_STACK_NODE *next = node->next;
+      node->value.reset();
+      release(node);
+      node = next;
+    }
+  }
+
+  // put a node into the free list
+  static void release(CALC_STACK_NODE *node)
+  {
+    node->next = _free;
+    _free = node;
+    _freeCount++;
+  }
+
+  // a free node with one reference, nullptr if there is no heap
+  static CALC_STACK_NODE *allocate()
+  {
+    if (!reserve(1))
+    {
+      return (nullptr);
+    }
+    CALC_STACK_NODE *node = _free;
+    _free = node->next;
+    _freeCount--;
+    node->next = nullptr;
+    node->refs = 1;
+    return (node);
+  }
+
+  // make sure there are count free nodes
+  static bool reserve(size_t count)
+  {
+    while (_freeCount < count)
+    {
+      CALC_STACK_NODE *chunk = new (std::nothrow) CALC_STACK_NODE[CALC_STACK_CHUNK];
+      if (chunk == nullptr)
+      {
+        return (false);
+      }
+      _chunks.push_back(chunk);
+      for (size_t i = 0; i < CALC_STACK_CHUNK; i++)
+      {
+        release(&chunk[i]);
+      }
+    }
+    return (true);
+  }
+
+  // give the chunks back to the heap if all nodes are free
+  static void releaseChunks()
+  {
+    if (_freeCount != _chunks.size() * CALC_STACK_CHUNK)
+    {
+      return;
+    }
+    for (CALC_STACK_NODE *chunk : _chunks)
+    {
+      delete[] chunk;
+    }
+    _chunks = std::vector<CALC_STACK_NODE *>();
+    _free = nullptr;
+    _freeCount = 0;
+  }
+};
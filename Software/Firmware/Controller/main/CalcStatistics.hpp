@@ -0,0 +1,264 @@
+// CalcStatistics.hpp
+
+// statistics of the data points entered with sigma+, the accumulators
+// are updated with every point and the points are not kept
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <Arduino.h>
+#include <ratpak.h>
+#include <CalcEnums.h>
+#include <CalcError.hpp>
+#include <CalcMath.hpp>
+#include <Rational.hpp>
+#include <CalcHistory.hpp>
+
+// the means and the sums of the squared deviations are updated instead of the sums
+// of the values and squares (Welford), the co-moment of x and y the same way.
+// Adding or removing a point is a fixed number of operations, the accumulators
+// keep their values if one of them fails.
+class CalcStatistics
+{
+public:
+  CalcStatistics() : _changed(false)
+  {
+    clear();
+  }
+
+  // forget all points
+  void clear()
+  {
+    _count = Rational(0);
+    _meanX = Rational(0);
+    _meanY = Rational(0);
+    _sxx = Rational(0);
+    _syy = Rational(0);
+    _sxy = Rational(0);
+    _changed = true;
+  }
+
+  // add the point (x, y) or remove it again
+  operation_return_code update(PRAT x, PRAT y, bool add, uint32_t radix, int32_t precision)
+  {
+    if (!add && zerrat(_count.get()))
+    {
+      return (operation_return_code::domain);
+    }
+    // the point is copied, a result calculated with doubles is made exact first
+    operation_return_code rc = CalcMath::refine();
+    if (rc != operation_return_code::success)
+    {
+      return (rc);
+    }
+    Rational px = Rational::copyOf(x);
+    Rational py = Rational::copyOf(y);
+    Rational one(1);
+    operation op = add ? operation::addition : operation::subtraction;
+    Rational count;
+    calc(count, _count, op, one, radix, precision, &rc);
+    if ((rc == operation_return_code::success) && zerrat(count.get()))
+    {
+      // the last point is removed
+      clear();
+      return (rc);
+    }
+    // deviations from the old means
+    Rational dx, dy;
+    calc(dx, px, operation::subtraction, _meanX, radix, precision, &rc);
+    calc(dy, py, operation::subtraction, _meanY, radix, precision, &rc);
+    // mean += dx / count
+    Rational meanX, meanY, t;
+    calc(t, dx, operation::division, count, radix, precision, &rc);
+    calc(meanX, _meanX, op, t, radix, precision, &rc);
+    calc(t, dy, operation::division, count, radix, precision, &rc);
+    calc(meanY, _meanY, op, t, radix, precision, &rc);
+    // sxx += dx * (x - new mean x), sxy uses the deviation of y from its new mean
+    Rational ex, ey;
+    calc(ex, px, operation::subtraction, meanX, radix, precision, &rc);
+    calc(ey, py, operation::subtraction, meanY, radix, precision, &rc);
+    Rational sxx, syy, sxy;
+    calc(t, dx, operation::multiplication, ex, radix, precision, &rc);
+    calc(sxx, _sxx, op, t, radix, precision, &rc);
+    calc(t, dy, operation::multiplication, ey, radix, precision, &rc);
+    calc(syy, _syy, op, t, radix, precision, &rc);
+    calc(t, dx, operation::multiplication, ey, radix, precision, &rc);
+    calc(sxy, _sxy, op, t, radix, precision, &rc);
+    if (rc == operation_return_code::success)
+    {
+      _count = std::move(count);
+      _meanX = std::move(meanX);
+      _meanY = std::move(meanY);
+      _sxx = std::move(sxx);
+      _syy = std::move(syy);
+      _sxy = std::move(sxy);
+      _changed = true;
+    }
+    return (rc);
+  }
+
+  // number of points
+  Rational getCount() const
+  {
+    return (_count.clone());
+  }
+
+  // means of x and y
+  operation_return_code getMean(Rational &x, Rational &y) const
+  {
+    if (zerrat(_count.get()))
+    {
+      return (operation_return_code::divideByZero);
+    }
+    x = _meanX.clone();
+    y = _meanY.clone();
+    return (operation_return_code::success);
+  }
+
+  // standard deviations of x and y, of a sample or of the whole population
+  operation_return_code getStdDev(Rational &x, Rational &y, bool sample, uint32_t radix, int32_t precision) const
+  {
+    operation_return_code rc = operation_return_code::success;
+    Rational n = _count.clone();
+    if (sample)
+    {
+      Rational one(1);
+      calc(n, _count, operation::subtraction, one, radix, precision, &rc);
+    }
+    Rational sx, sy;
+    calc(sx, _sxx, operation::division, n, radix, precision, &rc);
+    calc(sy, _syy, operation::division, n, radix, precision, &rc);
+    squareRoot(sx, radix, precision, &rc);
+    squareRoot(sy, radix, precision, &rc);
+    if (rc == operation_return_code::success)
+    {
+      x = std::move(sx);
+      y = std::move(sy);
+    }
+    return (rc);
+  }
+
+  // least squares line y = slope * x + intercept
+  operation_return_code getRegression(Rational &intercept, Rational &slope, uint32_t radix, int32_t precision) const
+  {
+    operation_return_code rc = operation_return_code::success;
+    Rational m, b, t;
+    calc(m, _sxy, operation::division, _sxx, radix, precision, &rc);
+    calc(t, m, operation::multiplication, _meanX, radix, precision, &rc);
+    calc(b, _meanY, operation::subtraction, t, radix, precision, &rc);
+    if (rc == operation_return_code::success)
+    {
+      intercept = std::move(b);
+      slope = std::move(m);
+    }
+    return (rc);
+  }
+
+  // correlation coefficient of x and y
+  operation_return_code getCorrelation(Rational &r, uint32_t radix, int32_t precision) const
+  {
+    operation_return_code rc = operation_return_code::success;
+    Rational t, c;
+    calc(t, _sxx, operation::multiplication, _syy, radix, precision, &rc);
+    squareRoot(t, radix, precision, &rc);
+    calc(c, _sxy, operation::division, t, radix, precision, &rc);
+    if (rc == operation_return_code::success)
+    {
+      r = std::move(c);
+    }
+    return (rc);
+  }
+
+  // accumulators for the web page
+  PRAT getMeanX() const
+  {
+    return (_meanX.get());
+  }
+
+  PRAT getMeanY() const
+  {
+    return (_meanY.get());
+  }
+
+  // sum of the squared deviations of x from the mean
+  PRAT getSxx() const
+  {
+    return (_sxx.get());
+  }
+
+  PRAT getSyy() const
+  {
+    return (_syy.get());
+  }
+
+  // sum of the products of the deviations of x and y
+  PRAT getSxy() const
+  {
+    return (_sxy.get());
+  }
+
+  // the accumulators are shared with the snapshot
+  void saveState(CALC_SNAPSHOT &state) const
+  {
+    state.statistics[0] = _count.clone();
+    state.statistics[1] = _meanX.clone();
+    state.statistics[2] = _meanY.clone();
+    state.statistics[3] = _sxx.clone();
+    state.statistics[4] = _syy.clone();
+    state.statistics[5] = _sxy.clone();
+  }
+
+  void restoreState(const CALC_SNAPSHOT &state)
+  {
+    _count = state.statistics[0].clone();
+    _meanX = state.statistics[1].clone();
+    _meanY = state.statistics[2].clone();
+    _sxx = state.statistics[3].clone();
+    _syy = state.statistics[4].clone();
+    _sxy = state.statistics[5].clone();
+    _changed = true;
+  }
+
+  // true if the accumulators changed since the last call
+  bool checkChanged()
+  {
+    bool changed = _changed;
+    _changed = false;
+    return (changed);
+  }
+
+private:
+  Rational _count;
+  Rational _meanX;
+  Rational _meanY;
+  Rational _sxx;
+  Rational _syy;
+  Rational _sxy;
+  bool _changed;
+
+  // result = a op b, nothing is done after an error
+  static void calc(Rational &result, const Rational &a, operation op, const Rational &b, uint32_t radix, int32_t precision, operation_return_code *rc)
+  {
+    if (*rc != operation_return_code::success)
+    {
+      return;
+    }
+    // calculate does y op x
+    Rational r = b.clone();
+    *rc = CalcMath::calculate(r, a.get(), op, radix, precision);
+    if (*rc == operation_return_code::success)
+    {
+      result = std::move(r);
+    }
+  }
+
+  static void squareRoot(Rational &x, uint32_t radix, int32_t precision, operation_return_code *rc)
+  {
+    if (*rc == operation_return_code::success)
+    {
+      *rc = CalcMath::calculate(x, nullptr, operation::square_root, radix, precision);
+    }
+  }
+};
@@ -0,0 +1,251 @@
+// CalcWorker.hpp
+
+// runs the calculator on its own task, the main loop keeps
+// serving keyboard, display, clock and network meanwhile
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <new>
+#include <Calculator.hpp>
+
+// the calculation task runs on the core the main loop does not use
+#if portNUM_PROCESSORS > 1
+constexpr BaseType_t CALC_WORKER_CORE = (CONFIG_ARDUINO_RUNNING_CORE == 0) ? 1 : 0;
+#else
+constexpr BaseType_t CALC_WORKER_CORE = tskNO_AFFINITY;
+#endif
+
+// same stack as the main loop, the calculations ran there before
+constexpr uint32_t CALC_WORKER_STACK_SIZE = 8192;
+constexpr UBaseType_t CALC_WORKER_PRIORITY = 1;
+
+// keys that can be typed ahead of a running calculation
+constexpr UBaseType_t CALC_WORKER_QUEUE_SIZE = 16;
+
+// results and events not yet taken by the main loop, a key updates several registers
+constexpr UBaseType_t CALC_WORKER_RESULT_QUEUE_SIZE = 32;
+
+// a key press for the calculator
+typedef struct
+{
+  uint32_t sequence;
+  uint8_t keyCode;
+  bool functionKeyPressed;
+  bool shiftKeyPressed;
+  bool refine; // calculate the exact value of the result instead of a key press
+} CALC_REQUEST;
+
+// kind of a result of the worker task
+enum class calc_event : uint8_t
+{
+  key,             // a key press is done
+  register_update, // a register changed, for the web clients
+  long_operation,  // a long calculation begins or ends
+  preview,         // approximation of a long calculation
+  refine           // the exact value of the result is calculated
+};
+
+// register update for the web clients
+typedef struct
+{
+  String regId;
+  String value;
+} CALC_REGISTER_UPDATE;
+
+// what the calculator did with a key press or an event during the calculation
+typedef struct
+{
+  calc_event event;
+  uint32_t sequence;
+  uint8_t keyCode;
+  bool handled;                 // the calculator used the key or refined the result
+  bool cancelled;               // the key was dropped by a cancel
+  long_operation longOperation; // long_operation event
+  CALC_REGISTER_UPDATE *update; // register_update event, deleted by the receiver
+  CALC_NUMBER *preview;         // preview event, deleted by the receiver
+} CALC_RESULT;
+
+// The calculator belongs to the worker task while it is busy. Other tasks
+// may only read or change calculator state when isBusy returns false.
+// Display and network belong to the main loop, the calculator callbacks
+// running on the worker task post their events with the results.
+class CalcWorker
+{
+public:
+  CalcWorker(Calculator *calculator) : _calculator(calculator),
+                                       _requests(nullptr),
+                                       _results(nullptr),
+                                       _task(nullptr)
+  {
+    _submitted = 0;
+    _completed = 0;
+    _cancelled = 0;
+    _running = 0;
+  }
+
+  // create the queues and start the task
+  bool begin()
+  {
+    if (_task == nullptr)
+    {
+      _requests = xQueueCreate(CALC_WORKER_QUEUE_SIZE, sizeof(CALC_REQUEST));
+      _results = xQueueCreate(CALC_WORKER_RESULT_QUEUE_SIZE, sizeof(CALC_RESULT));
+      if ((_requests != nullptr) && (_results != nullptr))
+      {
+        xTaskCreatePinnedToCore([](void *t)
+                                { static_cast<CalcWorker *>(t)->run(); },
+                                "calc", CALC_WORKER_STACK_SIZE, this, CALC_WORKER_PRIORITY, &_task, CALC_WORKER_CORE);
+      }
+    }
+    return (_task != nullptr);
+  }
+
+  // return if the task runs
+  bool isStarted() const
+  {
+    return (_task != nullptr);
+  }
+
+  // return if the caller runs on the worker task
+  bool isWorkerTask() const
+  {
+    return ((_task != nullptr) && (xTaskGetCurrentTaskHandle() == _task));
+  }
+
+  // pass a register update to the main loop, called on the worker task
+  void postRegisterUpdate(const String &regId, const String &value)
+  {
+    CALC_RESULT result = makeEvent(calc_event::register_update);
+    result.update = new (std::nothrow) CALC_REGISTER_UPDATE{regId, value};
+    if (result.update != nullptr)
+    {
+      xQueueSend(_results, &result, portMAX_DELAY);
+    }
+  }
+
+  // pass the begin or end of a long calculation to the main loop, called on the worker task
+  void postLongOperation(long_operation lo)
+  {
+    CALC_RESULT result = makeEvent(calc_event::long_operation);
+    result.longOperation = lo;
+    xQueueSend(_results, &result, portMAX_DELAY);
+  }
+
+  // pass the approximation of a long calculation to the main loop, called on the worker task
+  void postPreview(const CALC_NUMBER &number)
+  {
+    CALC_RESULT result = makeEvent(calc_event::preview);
+    result.preview = new (std::nothrow) CALC_NUMBER(number);
+    if (result.preview != nullptr)
+    {
+      xQueueSend(_results, &result, portMAX_DELAY);
+    }
+  }
+
+  // queue a key press for the calculator, false if the queue is full
+  bool submit(uint8_t keyCode, bool functionKeyPressed, bool shiftKeyPressed)
+  {
+    CALC_REQUEST request = {0, keyCode, functionKeyPressed, shiftKeyPressed, false};
+    return (queue(request));
+  }
+
+  // queue the exact calculation of a result calculated with doubles,
+  // the main loop reads all digits after it. False if the queue is full.
+  bool submitRefine()
+  {
+    CALC_REQUEST request = {0, 0, false, false, true};
+    return (queue(request));
+  }
+
+  // get the next result without waiting, false if there is none.
+  // The receiver deletes the update and the preview of an event.
+  bool getResult(CALC_RESULT *result)
+  {
+    return (xQueueReceive(_results, result, 0) == pdTRUE);
+  }
+
+  // return if key presses are queued or calculated
+  bool isBusy() const
+  {
+    return (_completed != _submitted);
+  }
+
+  // cancel the running calculation and drop the queued key presses
+  void cancel()
+  {
+    _cancelled = _submitted.load();
+  }
+
+  // called by the calculation, returns true if it has to stop
+  bool isCancelRequested() const
+  {
+    return (_running <= _cancelled);
+  }
+
+private:
+  Calculator *_calculator;
+  QueueHandle_t _requests;
+  QueueHandle_t _results;
+  TaskHandle_t _task;
+  std::atomic<uint32_t> _submitted; // sequence of the last queued key press
+  std::atomic<uint32_t> _completed; // sequence of the last key press done
+  std::atomic<uint32_t> _cancelled; // key presses up to this sequence are cancelled
+  std::atomic<uint32_t> _running;   // sequence of the key press being calculated
+
+  // number and queue a request, false if the queue is full
+  bool queue(CALC_REQUEST &request)
+  {
+    // counted first, the worker may finish before xQueueSend returns
+    request.sequence = ++_submitted;
+    if (xQueueSend(_requests, &request, 0) != pdTRUE)
+    {
+      _submitted--;
+      return (false);
+    }
+    return (true);
+  }
+
+  // task function, calculates the key presses in order
+  void run()
+  {
+    CALC_REQUEST request;
+    while (true)
+    {
+      if (xQueueReceive(_requests, &request, portMAX_DELAY) == pdTRUE)
+      {
+        CALC_RESULT result = makeEvent(request.refine ? calc_event::refine : calc_event::key);
+        result.sequence = request.sequence;
+        result.keyCode = request.keyCode;
+        result.cancelled = true;
+        if (request.sequence > _cancelled)
+        {
+          _running = request.sequence;
+          if (request.refine)
+          {
+            result.handled = _calculator->refine();
+          }
+          else
+          {
+            result.handled = _calculator->onKeyboardEvent(request.keyCode, key_state::pressed, request.functionKeyPressed, request.shiftKeyPressed);
+          }
+          result.cancelled = false;
+        }
+        xQueueSend(_results, &result, portMAX_DELAY);
+        // the result is queued before the worker reports idle
+        _completed = request.sequence;
+      }
+    }
+  }
+
+  // result without a key press
+  static CALC_RESULT makeEvent(calc_event event)
+  {
+    CALC_RESULT result = {event, 0, 0, false, false, long_operation::end, nullptr, nullptr};
+    return (result);
+  }
+};
@@ -15,6 +15,8 @@
 #include <CalcIO.hpp>
 #if CALC_TYPE == CALC_TYPE_RPN
 #include <CalcEngineRPN.hpp>
+#include <CalcProgram.hpp>
+#include <CalcSolver.hpp>
 #else
 #include <CalcEngineALG.hpp>
 #endif
@@ -44,6 +46,8 @@ class Calculator
 protected:
   using notifyLongOperationCb = std::function<void(long_operation lop)>;
   using notifyRegisterUpdateCb = std::function<void(String regId, String value)>;
+  using checkCancelCb = std::function<bool()>;
+  using notifyPreviewCb = std::function<void(CALC_NUMBER number)>;
 
 public:
   Calculator()
@@ -53,7 +57,13 @@ public:
     _cio = nullptr;
     _notifyLongOperation = nullptr;
     _notifyRegisterUpdate = nullptr;
+    _checkCancel = nullptr;
+    _notifyPreview = nullptr;
+    _calculating = false;
     _forceScientific = false;
+#if CALC_TYPE == CALC_TYPE_RPN
+    _viewLevel = 0;
+#endif
     resetScrollInfo();
   }
 
@@ -72,12 +82,31 @@ public:
     SetDecimalSeparator(DECIMAL_SEPARATOR);
     // intialize ratpak constants
     ChangeConstants(RAT_RADIX, SettingsCache::calcPrecision);
+    // let long calculations check for a cancel
+    SetRatPoll(&Calculator::onRatPoll, this, RAT_POLL_INTERVAL);
+    // keep denominators short in chained calculations
+    SetRatBound(RATBOUND_TRIM, RAT_BOUND_GUARD);
+
+    // transcendental operations with rationals or binary floats
+    CalcMath::setBackend(SettingsCache::calcBackend);
+    // time of the operations on this controller, estimated longer ones are rejected
+    CalcMath::calibrateCost(RAT_RADIX, SettingsCache::calcPrecision);
+    CalcMath::setTimeLimit(SettingsCache::calcTimeLimit * 1000);
+    // undo keeps the engine states up to this memory
+    _history.setBudget(SettingsCache::undoMemory * 1024);
 
     // configure calc engine
     _calcEngine.setRadix(RAT_RADIX);
     _calcEngine.setPrecision(SettingsCache::calcPrecision);
     _calcEngine.setFixedDecimals(SettingsCache::fixedDecimals);
+    CalcMath::setScaledIntegers(SettingsCache::fixedDecimals != fixed_decimals::off);
+    CalcMath::setCertifiedDigits(SettingsCache::fastDouble == fast_double::on ? digitCount + CALC_CERTIFY_GUARD_DIGITS : 0);
     _calcEngine.setMaxTrig();
+#if CALC_TYPE == CALC_TYPE_RPN
+    _calcEngine.setUnlimitedStack(SettingsCache::stackMode == stack_mode::unlimited);
+#else
+    _calcEngine.setPrecedence(SettingsCache::algMode == alg_mode::precedence);
+#endif
 
     // clear calc engine
     _calcEngine.clear();
@@ -91,9 +120,18 @@ public:
     // initialize calculator input/output
     _cio = new CalcIO(_digitCount, SettingsCache::maxExpDigits);
     updateNumber();
+
+#if CALC_TYPE == CALC_TYPE_RPN
+    // load the keystroke program
+    _program.begin(SettingsCache::calcPrecision);
+#endif
+
+    // ratpak builds expensive constants on first use, trace the ones needed to boot
+    D_println(LazyConstantsReport().c_str());
   }
 
-  // get registers from calc engine and convert to string
+  // get registers from calc engine and convert to string, the web page
+  // shows all digits, only the proven ones if isRefinePending is true
   void getRegisterStrings(REGISTERSTRINGMAP &regStringMap)
   {
     REGISTERMAP regMap;
@@ -108,14 +146,30 @@ public:
         }
         else
         {
-          regStringMap[value.first] = _calcEngine.getRatString(value.second);
+          regStringMap[value.first] = getWebString(value.second);
         }
       }
       else
       {
-        regStringMap[value.first] = _calcEngine.getRatString(value.second);
+        regStringMap[value.first] = getWebString(value.second);
       }
     }
+#if CALC_TYPE == CALC_TYPE_RPN
+    regStringMap["D:"] = getDeepStackString();
+#endif
+    regStringMap["S:"] = getStatisticsString();
+  }
+
+  // ratpak allocations per operation as text
+  String getMemProfileReport()
+  {
+    return (CalcMath::getMemProfileReport());
+  }
+
+  // clear the allocations per operation
+  void resetMemProfile()
+  {
+    CalcMath::resetMemProfile();
   }
 
   // get error description
@@ -159,6 +213,16 @@ public:
     if (keyState == key_state::pressed)
     {
       KeyboardDecoder::decode(keyCode, functionKeyPressed, shiftKeyPressed, &function, &op, &digit);
+#if CALC_TYPE == CALC_TYPE_RPN
+      bool view = (function == key_function_type::operation) && ((op == operation::view_down) || (op == operation::view_up));
+      if (!view && (_viewLevel != 0))
+      {
+        // any other key shows X again
+        _viewLevel = 0;
+        resetScrollInfo();
+        updateNumber();
+      }
+#endif
 
       switch (function)
       {
@@ -189,11 +253,33 @@ public:
 
       case key_function_type::operation:
       {
-        if (_inputPending)
+#if CALC_TYPE == CALC_TYPE_RPN
+        if (view)
         {
-          numericInput();
+          // only the display changes
+          if (!_inputPending)
+          {
+            viewInput(op);
+          }
+          break;
+        }
+#endif
+        if ((op == operation::undo) || (op == operation::redo))
+        {
+          // typed digits are dropped
+          if (!_inputPending)
+          {
+            historyInput(op);
+          }
+        }
+        else
+        {
+          if (_inputPending)
+          {
+            numericInput();
+          }
+          operationInput(op);
         }
-        operationInput(op);
         // prepare for display
         processResult();
 
@@ -205,6 +291,10 @@ public:
         result = false;
         break;
       }
+#if CALC_TYPE == CALC_TYPE_RPN
+      notifyDeepStack();
+#endif
+      notifyStatistics();
     }
     return (result);
   }
@@ -225,6 +315,8 @@ public:
     SettingsCache::fixedDecimals = (fixed_decimals::fixed_decimals)digit;
     // set the decimals in calc engine
     _calcEngine.setFixedDecimals(digit);
+    // fixed decimals are mostly money, exact decimals are added and multiplied as integers
+    CalcMath::setScaledIntegers(digit != FLOAT_DECIMALS);
   }
 
   // set max exponent length
@@ -263,6 +355,30 @@ public:
     _notifyLongOperation = nullptr;
   }
 
+  // set the callback function, called during calculations and returns true to cancel
+  void attachCheckCancelCb(checkCancelCb callBack)
+  {
+    _checkCancel = callBack;
+  }
+
+  // remove callback function
+  void detachCheckCancelCb()
+  {
+    _checkCancel = nullptr;
+  }
+
+  // set the callback function, gets an approximation of a long operation before its result
+  void attachPreviewCb(notifyPreviewCb callBack)
+  {
+    _notifyPreview = callBack;
+  }
+
+  // remove callback function
+  void detachPreviewCb()
+  {
+    _notifyPreview = nullptr;
+  }
+
   // set the callback function
   void attachRegisterUpadteCb(notifyRegisterUpdateCb callBack)
   {
@@ -282,8 +398,8 @@ public:
   {
     if (p)
     {
-      // not in error state, notify register
-      _notifyRegisterUpdate(regId, _calcEngine.getRatString(p));
+      // not in error state, notify register with all proven digits
+      _notifyRegisterUpdate(regId, getWebString(p));
     }
     else
     {
@@ -298,18 +414,53 @@ public:
     return ("Error (" + String(static_cast<int>(_calcEngine.getOperationReturnCode())) + ") " + CalcError::getErrorText(_calcEngine.getOperationReturnCode()));
   }
 
-  // get reg X string
+  // get reg X string, or the stack level on the display
   String getResultString(NumberFormat format = NumberFormat::Float)
   {
+#if CALC_TYPE == CALC_TYPE_RPN
+    if (_viewLevel != 0)
+    {
+      return (_calcEngine.getRatString(_calcEngine.getStackLevel(_viewLevel), format));
+    }
+#endif
     return (_calcEngine.getRatString(_calcEngine.getResult(), format));
   }
 
-  // provide information for result scrolling
+  // true if the result was calculated with doubles, its exact value is calculated by refine
+  bool isRefinePending() const
+  {
+    return (CalcMath::isRefinePending());
+  }
+
+  // calculate the exact value of a result calculated with doubles, can be cancelled.
+  // Returns false if it was cancelled or failed, the result stays pending then.
+  bool refine()
+  {
+    CalcMath::attachLongOperationCb(std::bind(&Calculator::onLongOperation, this, std::placeholders::_1));
+    _calculating = true;
+    bool result = (CalcMath::refine() == operation_return_code::success);
+    _calculating = false;
+    CalcMath::detachLongOperationCb();
+    if (result && _notifyRegisterUpdate)
+    {
+      // the web page got the proven digits only
+      REGISTERSTRINGMAP regStringMap;
+      getRegisterStrings(regStringMap);
+      for (const auto &value : regStringMap)
+      {
+        _notifyRegisterUpdate(value.first, value.second);
+      }
+    }
+    return (result);
+  }
+
+  // provide information for result scrolling, scrolling shows all
+  // digits, refine has to run before if isRefinePending is true
   bool getScrollInfo(bool *baseNegative, String &scrollString, int *decimalPos, bool *exponenentNegative, String &exponent)
   {
     bool result = false;
     // scroll only if the calc engine is not in error state
-    if ((_calcEngine.getOperationReturnCode() == operation_return_code::success) && !_inputPending)
+    if ((_calcEngine.getOperationReturnCode() == operation_return_code::success) && !_inputPending && !isRefinePending())
     {
       // initialize scrolling if needed
       if (!_scrollInfo.initialized)
@@ -399,9 +550,13 @@ public:
 private:
 #if CALC_TYPE == CALC_TYPE_RPN
   CalcEngineRPN _calcEngine;
+  CalcProgram _program;
+  CalcSolver _solver;
+  size_t _viewLevel; // stack level on the display, X is level 0
 #else
   CalcEngineALG _calcEngine;
 #endif
+  CalcHistory _history;
   Settings *_settings;
   uint8_t _digitCount;
   uint8_t _decimalSeparatorCount;
@@ -410,9 +565,22 @@ private:
   CalcIO *_cio;
   notifyLongOperationCb _notifyLongOperation;
   notifyRegisterUpdateCb _notifyRegisterUpdate;
+  checkCancelCb _checkCancel;
+  notifyPreviewCb _notifyPreview;
+  bool _calculating;
   bool _forceScientific;
   SCROLL_INFO _scrollInfo;
 
+  // string for the web page, a result calculated with doubles has its proven digits only
+  String getWebString(PRAT p)
+  {
+    if (CalcMath::isApproximation(p))
+    {
+      return (RatToString(p, NumberFormat::Float, RAT_RADIX, CalcMath::getCertifiedDigits()).c_str());
+    }
+    return (_calcEngine.getRatString(p));
+  }
+
   // process the result and prepare for display
   uint32_t processResult()
   {
@@ -447,8 +615,11 @@ private:
   {
     PRAT p = nullptr;
     _cio->getPRAT(&p, RAT_RADIX, SettingsCache::calcPrecision);
-    _calcEngine.handleNumericInput(p);
-    destroyrat(p);
+#if CALC_TYPE == CALC_TYPE_RPN
+    recordProgramStep(_program.recordNumber(_cio->getNumber()));
+#endif
+    // the engine takes ownership of the number
+    _calcEngine.handleNumericInput(Rational::adopt(p));
   }
 
   // called if a numeric key was pressed
@@ -458,9 +629,18 @@ private:
     if (_calcEngine.getOperationReturnCode() == operation_return_code::success)
     {
       uint8_t index = MEM_REGISTER_NONE;
-      if (_calcEngine.handleDigitInput(digit, &index))
+      CALC_SNAPSHOT state;
+      _calcEngine.saveState(state);
+      _calculating = true;
+      bool handled = _calcEngine.handleDigitInput(digit, &index);
+      _calculating = false;
+      if (handled)
       {
         _inputPending = false;
+        _history.save(std::move(state));
+#if CALC_TYPE == CALC_TYPE_RPN
+        recordProgramStep(_program.recordDigit(digit));
+#endif
 
         // the calc engine handled the input
         // because of a pending operation
@@ -511,6 +691,7 @@ private:
         if (!_inputPending)
         {
           // just clear the result
+          saveHistory();
           _calcEngine.clearResult();
           updateNumber();
         }
@@ -524,7 +705,22 @@ private:
         _cio->onChangeSign(_inputPending);
         if (!_inputPending)
         {
+          // a shared number is copied before the change, it has to be exact
+          operation_return_code rc = CalcMath::refine();
+          if (rc != operation_return_code::success)
+          {
+            _calcEngine.setOperationReturnCode(rc);
+            break;
+          }
+          saveHistory();
           _calcEngine.negateResult();
+#if CALC_TYPE == CALC_TYPE_RPN
+          // the sign change of a result is a program step, of an input it is part of the number
+          if (_program.isRecording())
+          {
+            recordProgramStep(_program.recordOperation(op));
+          }
+#endif
         }
         break;
 
@@ -555,28 +751,239 @@ private:
   // called if an operator key was pressed
   void operationInput(operation op)
   {
+#if CALC_TYPE == CALC_TYPE_RPN
+    if (programInput(op))
+    {
+      return;
+    }
+#endif
     if (_calcEngine.getOperationReturnCode() == operation_return_code::success)
     {
-      if (_calcEngine.isLongOperation(op) && SettingsCache::showBusyCalc != show_busy_calc::off)
+      saveHistory();
+      // CalcMath reports the calculations estimated to be long
+      CalcMath::attachLongOperationCb(std::bind(&Calculator::onLongOperation, this, std::placeholders::_1));
+      // progressive display shows an approximation first
+      bool preview = SettingsCache::showBusyCalc == show_busy_calc::progressive && _notifyPreview;
+      if (preview)
+      {
+        CalcMath::attachPreviewCb(std::bind(&Calculator::onPreview, this, std::placeholders::_1));
+      }
+      _calculating = true;
+#if CALC_TYPE == CALC_TYPE_RPN
+      if (op == operation::run)
+      {
+        // the program drives the engine directly
+        _program.run(_calcEngine, _checkCancel);
+      }
+      else if (op == operation::solve)
+      {
+        // the program is the function
+        _solver.solve(_calcEngine, _program, SettingsCache::calcPrecision, _checkCancel);
+        D_print(_solver.getReport());
+      }
+      else
+#endif
+      {
+        _calcEngine.onOperation(op);
+      }
+      _calculating = false;
+      if (preview)
       {
-        notifyLongOperation(long_operation::begin);
+        CalcMath::detachPreviewCb();
       }
-      _calcEngine.onOperation(op);
-      if (_calcEngine.isLongOperation(op) && SettingsCache::showBusyCalc != show_busy_calc::off)
+      CalcMath::detachLongOperationCb();
+      // the allocations of the operation are shown with the registers
+      if (_notifyRegisterUpdate)
       {
-        notifyLongOperation(long_operation::end);
+        String report = getMemProfileReport();
+#if CALC_TYPE == CALC_TYPE_RPN
+        if (op == operation::solve)
+        {
+          report = _solver.getReport() + report;
+        }
+#endif
+        _notifyRegisterUpdate("A:", report);
       }
     }
     else
     {
       // only accept specific operations if in error state
-      if (_calcEngine.isErrorRecoveryOperation(op))
+      if (CalcMath::isErrorRecoveryOperation(op))
       {
+        saveHistory();
         _calcEngine.onOperation(op);
       }
     }
   }
 
+  // keep the engine state before a change for undo
+  void saveHistory()
+  {
+    CALC_SNAPSHOT state;
+    _calcEngine.saveState(state);
+    _history.save(std::move(state));
+  }
+
+  // called if undo or redo was pressed, also in error state
+  void historyInput(operation op)
+  {
+    const CALC_SNAPSHOT *state;
+    if (op == operation::undo)
+    {
+      CALC_SNAPSHOT current;
+      _calcEngine.saveState(current);
+      state = _history.undo(std::move(current));
+    }
+    else
+    {
+      state = _history.redo();
+    }
+    if (state != nullptr)
+    {
+      _calcEngine.restoreState(*state);
+    }
+  }
+
+#if CALC_TYPE == CALC_TYPE_RPN
+  // show the next stack level on the display, the registers are not changed
+  void viewInput(operation op)
+  {
+    if (_calcEngine.getOperationReturnCode() != operation_return_code::success)
+    {
+      return;
+    }
+    if (op == operation::view_down)
+    {
+      if (_viewLevel + 1 < _calcEngine.getStackDepth())
+      {
+        _viewLevel++;
+      }
+    }
+    else if (_viewLevel > 0)
+    {
+      _viewLevel--;
+    }
+    resetScrollInfo();
+    _cio->setNumber(_calcEngine.getStackLevel(_viewLevel), RAT_RADIX, SettingsCache::calcPrecision, _calcEngine.getFixedDecimals(), _forceScientific);
+  }
+
+  // the levels below T, one per line, X is level 1 like T is level 4
+  String getDeepStackString()
+  {
+    String s;
+    _calcEngine.getDeepStack(CALC_STACK_WEB_LEVELS, [this, &s](size_t level, PRAT p)
+                             { s += String(level + 1) + ": " + getWebString(p) + "\n"; });
+    size_t depth = _calcEngine.getStackDepth() - RPN_STACK_REGISTERS;
+    if (depth > CALC_STACK_WEB_LEVELS)
+    {
+      s += "... " + String(depth - CALC_STACK_WEB_LEVELS) + " more\n";
+    }
+    return (s);
+  }
+
+  // send the levels below T if they changed
+  void notifyDeepStack()
+  {
+    if (_calcEngine.checkDeepStackChanged() && _notifyRegisterUpdate)
+    {
+      _notifyRegisterUpdate("D:", getDeepStackString());
+    }
+  }
+
+  // record the program operations and the operations done in recording mode,
+  // returns true if the operation is done
+  bool programInput(operation op)
+  {
+    bool result = true;
+    if (op == operation::program)
+    {
+      if (_program.isRecording())
+      {
+        _program.endRecording();
+      }
+      else
+      {
+        _program.beginRecording();
+      }
+    }
+    else if (CalcProgram::isProgramOperation(op))
+    {
+      // only a step of a program
+      recordProgramStep(_program.recordOperation(op));
+    }
+    else
+    {
+      // a program does not run or solve itself, operations ignored in error state are not recorded
+      if ((op != operation::run) && (op != operation::solve) &&
+          ((_calcEngine.getOperationReturnCode() == operation_return_code::success) || CalcMath::isErrorRecoveryOperation(op)))
+      {
+        recordProgramStep(_program.recordOperation(op));
+      }
+      result = false;
+    }
+    return (result);
+  }
+
+  // a full program ends the recording
+  void recordProgramStep(bool recorded)
+  {
+    if (!recorded && _program.isRecording())
+    {
+      _program.endRecording();
+    }
+  }
+#endif
+
+  // the accumulators of the statistics, one per line
+  String getStatisticsString()
+  {
+    const CalcStatistics &statistics = _calcEngine.getStatistics();
+    Rational count = statistics.getCount();
+    String s = "n: " + _calcEngine.getRatString(count.get()) + "\n";
+#if CALC_TYPE == CALC_TYPE_RPN
+    s += "mean x: " + _calcEngine.getRatString(statistics.getMeanX()) + "\n";
+    s += "mean y: " + _calcEngine.getRatString(statistics.getMeanY()) + "\n";
+    s += "Sxx: " + _calcEngine.getRatString(statistics.getSxx()) + "\n";
+    s += "Syy: " + _calcEngine.getRatString(statistics.getSyy()) + "\n";
+    s += "Sxy: " + _calcEngine.getRatString(statistics.getSxy()) + "\n";
+#else
+    s += "mean: " + _calcEngine.getRatString(statistics.getMeanX()) + "\n";
+    s += "Sxx: " + _calcEngine.getRatString(statistics.getSxx()) + "\n";
+#endif
+    return (s);
+  }
+
+  // send the statistics if they changed
+  void notifyStatistics()
+  {
+    if (_calcEngine.checkStatisticsChanged() && _notifyRegisterUpdate)
+    {
+      _notifyRegisterUpdate("S:", getStatisticsString());
+    }
+  }
+
+  // called by ratpak during long calculations, true cancels the calculation
+  static bool onRatPoll(void *param)
+  {
+    Calculator *calculator = static_cast<Calculator *>(param);
+    return (calculator->_calculating && calculator->_checkCancel && calculator->_checkCancel());
+  }
+
+  // called by CalcMath before and after a calculation estimated to be long
+  void onLongOperation(bool begin)
+  {
+    notifyLongOperation(begin ? long_operation::begin : long_operation::end);
+  }
+
+  // format the approximation like a result, processResult replaces it later
+  void onPreview(PRAT p)
+  {
+    if (_cio->setNumber(p, RAT_RADIX, SettingsCache::calcPrecision, _calcEngine.getFixedDecimals(), _forceScientific) == 0)
+    {
+      _notifyPreview(_cio->getNumber());
+    }
+  }
+
   // notify long operation events
   void notifyLongOperation(long_operation value)
   {
@@ -20,12 +20,16 @@
 #include <SettingsCache.hpp>
 #include <DisplayHandler.hpp>
 #include <Calculator.hpp>
+#include <CalcWorker.hpp>
 #include <Clock.hpp>
 #include <Lighting.hpp>
 #include <PIR.hpp>
 #include <GPS.hpp>
 #include <Temperature.hpp>
 #include <MenuHandler.hpp>
+#if CALC_BENCHMARK
+#include <CalcBenchmark.hpp>
+#endif
 #if WEBSOCKET_SUPPORT
 #include <CalcWebSocketServer.hpp>
 #endif
@@ -50,6 +54,23 @@ constexpr uint8_t PIN_RTC = 36;
 // minimum allowed time between two high-voltage switch-on events
 constexpr unsigned long MIN_HVON_INTERVAL = 1000; // in ms
 
+// maximum time a calculation runs without giving other tasks a chance
+constexpr unsigned long CALC_YIELD_INTERVAL = 100; // in ms
+constexpr unsigned long CALC_WATCHDOG_INTERVAL = 1000; // in ms, calculations not estimated to be long
+
+// longest command accepted from the serial monitor
+constexpr size_t MAX_SERIAL_COMMAND_LENGTH = 16;
+
+// keyboard event waiting for the calculator task to be done
+typedef struct
+{
+  uint8_t keyCode;
+  key_state keyState;
+  bool functionKeyPressed;
+  bool shiftKeyPressed;
+  special_keyboard_event specialEvent;
+} DEFERRED_KEY;
+
 // struct needed for digit rotation for cathode poisoning prevention
 typedef struct
 {
@@ -70,7 +91,8 @@ public:
 #if WEBSOCKET_SUPPORT
         _web(PIN_NETACT),
 #endif
-        _menuHandler(&_settings, _displayHandler.getDecimalSeparatorPosition())
+        _menuHandler(&_settings, _displayHandler.getDecimalSeparatorPosition()),
+        _calcWorker(&_calculator)
 
   {
     _highVoltageOn = true;
@@ -80,6 +102,14 @@ public:
     _rotationData = (ROTATIONDATA *)calloc(_displayHandler.getDigitCount() + MAX_SPECIAL_CHARS_DIGITS, sizeof(ROTATIONDATA));
     _rotationStopped = false;
     _scrollResult = false;
+    _calcYieldTimestamp = 0;
+    _calcYieldInterval = CALC_WATCHDOG_INTERVAL;
+    _calcRefreshPending = false;
+    _deferredKeyCount = 0;
+#if WEBSOCKET_SUPPORT
+    _webSyncPending = false;
+    _webSyncRefined = false;
+#endif
   }
 
   virtual ~Controller()
@@ -122,6 +152,12 @@ public:
       // get notified on long operations
       _calculator.attachLongOperationCb(std::bind(&Controller::onLongOperation, this, std::placeholders::_1));
 
+      // progressive display of long operations
+      _calculator.attachPreviewCb(std::bind(&Controller::onCalcPreview, this, std::placeholders::_1));
+
+      // long calculations yield and can be cancelled
+      _calculator.attachCheckCancelCb(std::bind(&Controller::onCheckCancel, this));
+
       // initialize display
       _displayHandler.begin();
       _displayHandler.clearDisplay();
@@ -195,6 +231,16 @@ public:
         break;
       }
 
+#if CALC_BENCHMARK
+      runCalcBenchmark();
+#endif
+
+      // from now on the calculator works on its own task
+      if (!_calcWorker.begin())
+      {
+        result = ERR_CALCWORKER;
+      }
+
       // display initial values
       switch (_deviceMode)
       {
@@ -229,11 +275,31 @@ public:
     // process keyboard input
     _keyboard.process();
 
-    // check if it's time to switch to clock mode or turn the HV off
-    checkAutoOff();
+    // show the calculator results
+    processCalcResults();
+
+    // handle the keys that waited for the calculator
+    processDeferredKeys();
+
+#if WEBSOCKET_SUPPORT
+    // send the registers to new web clients
+    syncWebClients();
+#endif
+
+#if DEBUG
+    // process commands from the serial monitor
+    processSerialCommand();
+#endif
+
+    // the display shows the busy animation while calculating
+    if (!_calcWorker.isBusy())
+    {
+      // check if it's time to switch to clock mode or turn the HV off
+      checkAutoOff();
 
-    // check if it's time to rotate digits for antipoisoning
-    checkAntiPoisoning(&tm);
+      // check if it's time to rotate digits for antipoisoning
+      checkAntiPoisoning(&tm);
+    }
 
     // process gps data
     _gps.process();
@@ -284,8 +350,13 @@ public:
       break;
 
     case device_mode::calculator:
-      // check if we have to scroll the result
-      if (_scrollResult)
+      // check if we have to scroll the result, scrolling shows all digits
+      // and waits for the calculator task to calculate the exact result
+      if (_scrollResult && !_calcWorker.isBusy() && _calculator.isRefinePending())
+      {
+        _calcWorker.submitRefine();
+      }
+      else if (_scrollResult && !_calcWorker.isBusy())
       {
         String scrollString;
         bool baseNegative;
@@ -360,6 +431,14 @@ private:
   KeyboardHandler _keyboard;
   Settings _settings;
   Calculator _calculator;
+  CalcWorker _calcWorker;
+  bool _calcRefreshPending;
+  DEFERRED_KEY _deferredKeys[CALC_WORKER_QUEUE_SIZE];
+  uint8_t _deferredKeyCount;
+#if WEBSOCKET_SUPPORT
+  volatile bool _webSyncPending;
+  bool _webSyncRefined;
+#endif
   bool _scrollResult;
 
   device_mode _deviceMode;
@@ -369,6 +448,11 @@ private:
   ROTATIONDATA *_rotationData;
   bool _rotationStopped;
   unsigned long _hvOffTimestamp;
+  unsigned long _calcYieldTimestamp;
+  unsigned long _calcYieldInterval;
+#if DEBUG
+  String _serialCommand;
+#endif
 
   // turn the high voltage on
   void hvON()
@@ -546,6 +630,71 @@ private:
     }
   }
 
+#if CALC_BENCHMARK
+  // time the benchmark sequences from key press to display
+  void runCalcBenchmark()
+  {
+    fixed_decimals::fixed_decimals fixedDecimals = SettingsCache::fixedDecimals;
+    unsigned long total = 0;
+    unsigned long start = micros();
+    for (const BENCHMARK_KEY &key : BENCHMARK_KEYS)
+    {
+      if (_calculator.onKeyboardEvent(key.keyCode, key_state::pressed, key.functionKeyPressed, false))
+      {
+        refreshCalcDisplay();
+      }
+      if (key.label != nullptr)
+      {
+        unsigned long elapsed = micros() - start;
+        total += elapsed;
+        D_printf("%-10s %8lu us\n", key.label, elapsed);
+        start = micros();
+      }
+    }
+    D_printf("total      %8lu us, base %s\n", total, RATPAK_DECIMAL_BASE ? "10^9" : "2^31");
+    _calculator.setDecimals(fixedDecimals);
+  }
+#endif
+
+#if DEBUG
+  // read a command line from the serial monitor and execute it
+  // mem: print the ratpak allocations per operation
+  // memreset: clear the allocations per operation
+  void processSerialCommand()
+  {
+    while (Serial.available() > 0)
+    {
+      char c = Serial.read();
+      if ((c != '\n') && (c != '\r'))
+      {
+        if (_serialCommand.length() < MAX_SERIAL_COMMAND_LENGTH)
+        {
+          _serialCommand += c;
+        }
+        continue;
+      }
+      if (_calcWorker.isBusy())
+      {
+        D_println("calculator busy");
+      }
+      else if (_serialCommand == "mem")
+      {
+        D_print(_calculator.getMemProfileReport());
+      }
+      else if (_serialCommand == "memreset")
+      {
+        _calculator.resetMemProfile();
+        D_println("memory profile cleared");
+      }
+      else if (!_serialCommand.isEmpty())
+      {
+        D_println("unknown command: " + _serialCommand);
+      }
+      _serialCommand = "";
+    }
+  }
+#endif
+
   // called on a keyboard event
   void onKeyboardEvent(uint8_t keyCode, key_state keyState, bool functionKeyPressed, bool shiftKeyPressed, special_keyboard_event specialEvent)
   {
@@ -591,6 +740,61 @@ private:
     {
       return;
     }
+
+    // while the calculator works, keys are typed ahead and CLS / AC cancels,
+    // shortcuts, mode switches and the keys after them are queued until it is done
+    if (_calcWorker.isBusy() || (_deferredKeyCount > 0))
+    {
+      if ((keyState == key_state::pressed) && (_deviceMode == device_mode::calculator))
+      {
+#if CALC_TYPE == CALC_TYPE_RPN
+        if (keyCode == KEY_CLS)
+#else
+        if (keyCode == KEY_AC)
+#endif
+        {
+          _calcWorker.cancel();
+          _deferredKeyCount = 0;
+          return;
+        }
+        if (!functionKeyPressed && (specialEvent == special_keyboard_event::none) && (_deferredKeyCount == 0))
+        {
+          // a key stops scrolling, the scroll information is reset when scrolling starts again
+          _scrollResult = false;
+          _calcWorker.submit(keyCode, functionKeyPressed, shiftKeyPressed);
+          return;
+        }
+      }
+      // releases are not needed, keys beyond the queue size are dropped
+      if (((keyState == key_state::pressed) || (specialEvent != special_keyboard_event::none)) && (_deferredKeyCount < CALC_WORKER_QUEUE_SIZE))
+      {
+        _deferredKeys[_deferredKeyCount++] = {keyCode, keyState, functionKeyPressed, shiftKeyPressed, specialEvent};
+      }
+      return;
+    }
+    handleKeyboardEvent(keyCode, keyState, functionKeyPressed, shiftKeyPressed, specialEvent);
+  }
+
+  // handle the keys that waited for the calculator, in the order they were pressed
+  void processDeferredKeys()
+  {
+    uint8_t index = 0;
+    while ((index < _deferredKeyCount) && !_calcWorker.isBusy())
+    {
+      DEFERRED_KEY key = _deferredKeys[index++];
+      handleKeyboardEvent(key.keyCode, key.keyState, key.functionKeyPressed, key.shiftKeyPressed, key.specialEvent);
+    }
+    // keep the keys still waiting
+    for (uint8_t i = index; i < _deferredKeyCount; i++)
+    {
+      _deferredKeys[i - index] = _deferredKeys[i];
+    }
+    _deferredKeyCount -= index;
+  }
+
+  // a keyboard event while the calculator is idle
+  void handleKeyboardEvent(uint8_t keyCode, key_state keyState, bool functionKeyPressed, bool shiftKeyPressed, special_keyboard_event specialEvent)
+  {
     switch (specialEvent)
     {
     // switch between clock and calculator mode or leave menu mode
@@ -621,24 +825,17 @@ private:
     switch (_deviceMode)
     {
     case device_mode::calculator:
-      // calculator is keyboard driven, send key event and update display
+      // calculator is keyboard driven, send key event to the calculator task,
+      // the display is updated by processCalcResults
       if (keyState == key_state::pressed)
       {
-        if (_calculator.onKeyboardEvent(keyCode, keyState, functionKeyPressed, shiftKeyPressed))
+        // first we may have to stop scrolling
+        if (_scrollResult)
         {
-          // first we may have to stop scrolling
-          if (_scrollResult)
-          {
-            _scrollResult = false;
-            _calculator.resetScrollInfo();
-          }
-          // show result
-          refreshCalcDisplay();
-          if (keyState == key_state::pressed)
-          {
-            _lighting.refresh();
-          }
+          _scrollResult = false;
+          _calculator.resetScrollInfo();
         }
+        _calcWorker.submit(keyCode, functionKeyPressed, shiftKeyPressed);
       }
       break;
 
@@ -915,10 +1112,38 @@ private:
     }
   }
 
-  // called for long calculations
-  // this is used to display an animation
+  // called for calculations estimated to be long
+  // this is used to display an animation and to yield more often
   void onLongOperation(long_operation lo)
   {
+    switch (lo)
+    {
+    case long_operation::begin:
+      _calcYieldInterval = CALC_YIELD_INTERVAL;
+      break;
+
+    case long_operation::end:
+      _calcYieldInterval = CALC_WATCHDOG_INTERVAL;
+      break;
+    }
+    // the display belongs to the main loop
+    if (_calcWorker.isWorkerTask())
+    {
+      _calcWorker.postLongOperation(lo);
+    }
+    else
+    {
+      showLongOperation(lo);
+    }
+  }
+
+  // start or stop the busy animation
+  void showLongOperation(long_operation lo)
+  {
+    if (SettingsCache::showBusyCalc == show_busy_calc::off)
+    {
+      return;
+    }
     switch (lo)
     {
     case long_operation::begin:
@@ -931,6 +1156,105 @@ private:
     }
   }
 
+  // called with the approximation of a long operation,
+  // the preview replaces the busy animation until the operation ends
+  void onCalcPreview(CALC_NUMBER number)
+  {
+    if (_calcWorker.isWorkerTask())
+    {
+      _calcWorker.postPreview(number);
+    }
+    else
+    {
+      showPreview(number);
+    }
+  }
+
+  // show the approximation of a long operation
+  void showPreview(const CALC_NUMBER &number)
+  {
+    _displayHandler.stopBusyCalcTask();
+    _displayHandler.createPreviewTask(number.baseNegative, number.base, number.exponentNegative, number.exponent);
+  }
+
+  // take the results and events of the calculator task, the display is
+  // updated once all typed ahead keys are calculated
+  void processCalcResults()
+  {
+    CALC_RESULT result;
+    while (_calcWorker.getResult(&result))
+    {
+      switch (result.event)
+      {
+      case calc_event::key:
+        if (result.handled)
+        {
+          _calcRefreshPending = true;
+        }
+        break;
+
+      case calc_event::register_update:
+#if WEBSOCKET_SUPPORT
+        sendRegister(result.update->regId, result.update->value);
+#endif
+        delete result.update;
+        break;
+
+      case calc_event::long_operation:
+        showLongOperation(result.longOperation);
+        break;
+
+      case calc_event::preview:
+        showPreview(*result.preview);
+        delete result.preview;
+        break;
+
+      case calc_event::refine:
+        // the busy animation may have replaced the result
+        _calcRefreshPending = true;
+        if (!result.handled && _scrollResult)
+        {
+          // cancelled, stop scrolling
+          _scrollResult = false;
+          _calculator.resetScrollInfo();
+        }
+        break;
+      }
+    }
+    if (_calcRefreshPending && !_calcWorker.isBusy())
+    {
+      _calcRefreshPending = false;
+      if (_deviceMode == device_mode::calculator)
+      {
+        // show result
+        refreshCalcDisplay();
+        _lighting.refresh();
+      }
+    }
+  }
+
+  // called during calculations, returns true if the calculation has to be cancelled
+  bool onCheckCancel()
+  {
+    // let the idle task of the calculation core run, it feeds the task watchdog,
+    // calculations not estimated to be long yield at most once a second
+    if (millis() - _calcYieldTimestamp > _calcYieldInterval)
+    {
+      vTaskDelay(1);
+      _calcYieldTimestamp = millis();
+    }
+    // the main loop reads the keyboard and passes CLS / AC on
+    if (_calcWorker.isStarted())
+    {
+      return (_calcWorker.isCancelRequested());
+    }
+#if CALC_TYPE == CALC_TYPE_RPN
+    return (_keyboard.scanForKey(KEY_CLS));
+#else
+    return (_keyboard.scanForKey(KEY_AC));
+#endif
+  }
+
 #if WEBSOCKET_SUPPORT
   // display the local IP address
   void displayIP(IPAddress ip)
@@ -957,36 +1281,74 @@ private:
     }
   }
 
-  // client connection callback
+  // client connection callback, called by the network task
   void onClientConnection(uint32_t id)
   {
-    if (_web.getClientCount() == 1)
+    // the calculator may be busy, the main loop sends the registers
+    _webSyncPending = true;
+  }
+
+  // client disconnection callback, called by the network task
+  void onClientDisconnection(uint32_t id)
+  {
+    _webSyncPending = true;
+  }
+
+  // start or stop register notifications after clients connected or
+  // disconnected and send all registers, waits for the calculator to be idle
+  void syncWebClients()
+  {
+    if (!_webSyncPending || _calcWorker.isBusy())
+    {
+      return;
+    }
+    if ((_web.getClientCount() > 0) && _calculator.isRefinePending() && !_webSyncRefined)
+    {
+      // the web page shows all digits, the calculator task calculates them first,
+      // only once as a failed refine leaves the result with its proven digits
+      _webSyncRefined = true;
+      _calcWorker.submitRefine();
+      return;
+    }
+    _webSyncPending = false;
+    _webSyncRefined = false;
+    if (_web.getClientCount() > 0)
     {
-      // first client, start notifications
+      // start notifications
       _calculator.attachRegisterUpadteCb(std::bind(&Controller::onRegisterUpdate, this, std::placeholders::_1, std::placeholders::_2));
+      // get all registers
+      REGISTERSTRINGMAP regStringMap;
+      _calculator.getRegisterStrings(regStringMap);
+      // send all registers to clients
+      for (const auto &value : regStringMap)
+      {
+        _web.updateClients(value.first, value.second);
+      }
+      // and the allocations per operation
+      _web.updateClients("A:", _calculator.getMemProfileReport());
     }
-    // get all registers
-    REGISTERSTRINGMAP regStringMap;
-    _calculator.getRegisterStrings(regStringMap);
-    // send all registers to client
-    for (const auto &value : regStringMap)
+    else
     {
-      _web.updateClient(value.first, value.second, id);
+      // if no clients left, stop notifications
+      _calculator.detachRegisterUpdateCb();
     }
   }
 
-  // client disconnection callback
-  void onClientDisconnection(uint32_t id)
+  // called when a register changes, the network belongs to the main loop
+  void onRegisterUpdate(String regId, String value)
   {
-    if (_web.getClientCount() == 0)
+    if (_calcWorker.isWorkerTask())
     {
-      // if no clients left, stop notifications
-      _calculator.detachRegisterUpdateCb();
+      _calcWorker.postRegisterUpdate(regId, value);
+    }
+    else
+    {
+      sendRegister(regId, value);
     }
   }
 
   // send registers to web clients
-  void onRegisterUpdate(String regId, String value)
+  void sendRegister(const String &regId, const String &value)
   {
     if (_web.isInitialized() && (_web.getClientCount() > 0))
     {
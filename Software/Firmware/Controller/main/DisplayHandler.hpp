@@ -494,21 +494,36 @@ public:
   {
     _taskRun = true;
     _taskEnd = false;
-    if (SettingsCache::showBusyCalc == show_busy_calc::moving_decimal_separator)
+    // progressive display moves the separator until the preview is ready
+    if (SettingsCache::showBusyCalc == show_busy_calc::digit_flickering)
     {
       xTaskCreate([](void *t)
-                  { static_cast<DisplayHandler *>(t)->showBusyCalcMovingDecimalPoint(); },
+                  { static_cast<DisplayHandler *>(t)->showBusyCalcDigitFlickering(); },
                   "busy", 1024, this, tskIDLE_PRIORITY + 5, NULL);
     }
     else
     {
       xTaskCreate([](void *t)
-                  { static_cast<DisplayHandler *>(t)->showBusyCalcDigitFlickering(); },
+                  { static_cast<DisplayHandler *>(t)->showBusyCalcMovingDecimalPoint(); },
                   "busy", 1024, this, tskIDLE_PRIORITY + 5, NULL);
     }
   }
 
-  // stop busy animation task
+  // create task showing the approximation of a long calculation
+  void createPreviewTask(bool baseNegative, String base, bool exponentNegative, String exponent)
+  {
+    _previewBaseNegative = baseNegative;
+    _previewBase = base;
+    _previewExponentNegative = exponentNegative;
+    _previewExponent = exponent;
+    _taskRun = true;
+    _taskEnd = false;
+    xTaskCreate([](void *t)
+                { static_cast<DisplayHandler *>(t)->showPreview(); },
+                "preview", 2048, this, tskIDLE_PRIORITY + 5, NULL);
+  }
+
+  // stop busy animation or preview task
   void stopBusyCalcTask()
   {
     _taskRun = false;
@@ -534,9 +549,13 @@ public:
   }
 
 private:
-  volatile bool _taskRun;
-  volatile bool _taskEnd;
+  volatile bool _taskRun = false;
+  volatile bool _taskEnd = true;
   uint8_t _decimalPositionOffset;
+  bool _previewBaseNegative;
+  String _previewBase;
+  bool _previewExponentNegative;
+  String _previewExponent;
 
   // convert to 12 hour format
   int convert24to12(int hour24) const
@@ -647,4 +666,53 @@ private:
     // deletes itself
     vTaskDelete(NULL);
   }
+
+  // display the approximation at once, the decimal separator blinks every 250 milliseconds
+  void showPreview()
+  {
+    if (_taskRun)
+    {
+      showCalc(_previewBaseNegative, _previewBase, _previewExponentNegative, _previewExponent);
+      // the separator of the number, behind the last digit for integers
+      int digit = 0;
+      int decimalSeparator = -1;
+      for (int i = 0; i < _previewBase.length(); i++)
+      {
+        if (_previewBase[i] == DECIMAL_SEPARATOR)
+        {
+          decimalSeparator = digit - 1;
+        }
+        else if (isDigit(_previewBase[i]))
+        {
+          digit++;
+        }
+      }
+      if (decimalSeparator < 0)
+      {
+        decimalSeparator = digit - 1;
+      }
+      decimalSeparator += getDspOffset();
+      display_state state = display_state::on;
+      for (;;)
+      {
+        for (int i = 0; i < 25 && _taskRun; i++)
+        {
+          vTaskDelay(10 / portTICK_PERIOD_MS);
+        }
+        if (_taskRun)
+        {
+          state = (state == display_state::on) ? display_state::off : display_state::on;
+          setDecimalSeparator(decimalSeparator, state);
+          show();
+        }
+        else
+        {
+          break;
+        }
+      }
+    }
+    _taskEnd = true;
+    // deletes itself
+    vTaskDelete(NULL);
+  }
 };
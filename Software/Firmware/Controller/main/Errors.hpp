@@ -11,6 +11,7 @@
 
 constexpr auto ERR_SUCCESS = 0;
 constexpr auto ERR_INITSETTINGS = 1;
+constexpr auto ERR_CALCWORKER = 2;
 
 class Errors
 {
@@ -31,6 +32,10 @@ public:
     case ERR_INITSETTINGS:
       text = "Failed to initialize settings";
       break;
+
+    case ERR_CALCWORKER:
+      text = "Failed to start calculation task";
+      break;
     }
     return (text);
   }
@@ -434,46 +434,57 @@ public:
       switch (keyCode)
       {
       case KEY_0:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_count;
         break;
 
       case KEY_1:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_add;
         break;
 
       case KEY_2:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::view_down;
         break;
       case KEY_3:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_subtract;
         break;
 
       case KEY_4:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_mean;
         break;
 
       case KEY_5:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_stdev;
         break;
 
       case KEY_6:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_pop_stdev;
         break;
 
       case KEY_7:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_regression;
         break;
 
       case KEY_8:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::view_up;
         break;
 
       case KEY_9:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_correlation;
         break;
 
       case KEY_00:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_clear;
         break;
 
       case KEY_DEG:
@@ -542,7 +553,8 @@ public:
         break;
 
       case KEY_EXP:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::solve;
         break;
 
       case KEY_CHS:
@@ -562,23 +574,28 @@ public:
         break;
 
       case KEY_DIV:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::test_x_le_y;
         break;
 
       case KEY_MUL:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::test_x_eq_0;
         break;
 
       case KEY_MINUS:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::decrement_skip_zero;
         break;
 
       case KEY_PLUS:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::goto_start;
         break;
 
       case KEY_ENTER:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::redo;
         break;
 
       case KEY_XY:
@@ -592,15 +609,18 @@ public:
         break;
 
       case KEY_CLR:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::undo;
         break;
 
       case KEY_STO:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::program;
         break;
 
       case KEY_RCL:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::run;
         break;
       }
     }
@@ -1012,30 +1032,36 @@ public:
       switch (keyCode)
       {
       case KEY_0:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_count;
         break;
 
       case KEY_1:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_add;
         break;
 
       case KEY_2:
         // not defined
         break;
       case KEY_3:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_subtract;
         break;
 
       case KEY_4:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_mean;
         break;
 
       case KEY_5:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_stdev;
         break;
 
       case KEY_6:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_pop_stdev;
         break;
 
       case KEY_7:
@@ -1051,7 +1077,8 @@ public:
         break;
 
       case KEY_00:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::stat_clear;
         break;
 
       case KEY_DEG:
@@ -1060,7 +1087,8 @@ public:
         break;
 
       case KEY_C:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::undo;
         break;
 
       case KEY_AC:
@@ -1139,11 +1167,13 @@ public:
         break;
 
       case KEY_DIV:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::open_parenthesis;
         break;
 
       case KEY_MUL:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::close_parenthesis;
         break;
 
       case KEY_MINUS:
@@ -1155,7 +1185,8 @@ public:
         break;
 
       case KEY_EQUALS:
-        // not defined
+        *function = key_function_type::operation;
+        *op = operation::redo;
         break;
 
       case KEY_MC:
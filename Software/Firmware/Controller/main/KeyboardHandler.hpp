@@ -105,6 +105,9 @@ constexpr uint8_t KEY_SYNC = 0xFE;
 // size of key info
 constexpr uint8_t KEY_INFO_SIZE = 3;
 
+// key events kept while scanning for a key during a calculation
+constexpr uint8_t KEY_QUEUE_SIZE = 16;
+
 // keyboard transmission speed
 constexpr unsigned long KEYBOARD_COMM_SPEED = 4800;
 
@@ -147,6 +150,13 @@ enum class special_keyboard_event : uint8_t
   mode_switch
 };
 
+// key event as received by the keyboard
+typedef struct
+{
+  uint8_t key;
+  key_state state;
+} KEY_EVENT;
+
 class KeyboardHandler
 {
 
@@ -171,6 +181,8 @@ public:
     _notify = nullptr;
     _notifyRaw = nullptr;
     _lastKeyTimestamp = millis();
+    _queueHead = 0;
+    _queueCount = 0;
   }
 
   virtual ~KeyboardHandler()
@@ -217,6 +229,14 @@ public:
   void process()
   {
     uint8_t buffer[KEY_INFO_SIZE];
+    // events received while scanning come first
+    while (_queueCount > 0)
+    {
+      KEY_EVENT event = _queue[_queueHead];
+      _queueHead = (_queueHead + 1) % KEY_QUEUE_SIZE;
+      _queueCount--;
+      dispatch(event.key, event.state);
+    }
     if (_serialPort)
     {
       while (_serialPort->available())
@@ -229,14 +249,7 @@ public:
           {
             // we have enough bytes to read
             _serialPort->readBytes(buffer, KEY_INFO_SIZE);
-            if (_notifyRaw)
-            {
-              _notifyRaw(buffer[1], (key_state)buffer[2]);
-            }
-            if (_notify)
-            {
-              notifyKeyboardEvent(buffer[1], (key_state)buffer[2]);
-            }
+            dispatch(buffer[1], (key_state)buffer[2]);
           }
         }
         else
@@ -248,6 +261,44 @@ public:
     }
   }
 
+  // check without blocking if the key was pressed, used during long calculations
+  // the key press is consumed, other events are kept for process
+  bool scanForKey(uint8_t key)
+  {
+    bool found = false;
+    uint8_t buffer[KEY_INFO_SIZE];
+    if (_serialPort)
+    {
+      while (_serialPort->available() && _queueCount < KEY_QUEUE_SIZE)
+      {
+        if (_serialPort->peek() == KEY_SYNC)
+        {
+          if (_serialPort->available() < KEY_INFO_SIZE)
+          {
+            // rest of the event not received yet
+            break;
+          }
+          _serialPort->readBytes(buffer, KEY_INFO_SIZE);
+          if (!found && buffer[1] == key && (key_state)buffer[2] == key_state::pressed)
+          {
+            found = true;
+          }
+          else
+          {
+            _queue[(_queueHead + _queueCount) % KEY_QUEUE_SIZE] = {buffer[1], (key_state)buffer[2]};
+            _queueCount++;
+          }
+        }
+        else
+        {
+          // we are out of sync, dismiss byte
+          _serialPort->read();
+        }
+      }
+    }
+    return (found);
+  }
+
   // provide extended information about the keyboard event and notify
   void notifyKeyboardEvent(uint8_t key, key_state state)
   {
@@ -474,6 +525,22 @@ private:
   bool _functionKeyHold;
   bool _keyPressed;
   unsigned long _lastKeyTimestamp;
+  KEY_EVENT _queue[KEY_QUEUE_SIZE];
+  uint8_t _queueHead;
+  uint8_t _queueCount;
+
+  // notify a key event as received by the keyboard
+  void dispatch(uint8_t key, key_state state)
+  {
+    if (_notifyRaw)
+    {
+      _notifyRaw(key, state);
+    }
+    if (_notify)
+    {
+      notifyKeyboardEvent(key, state);
+    }
+  }
 
   // helper function to send a 2 byte value to the keyboard
   void writeUInt(uint16_t value) const
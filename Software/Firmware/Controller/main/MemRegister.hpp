@@ -9,13 +9,13 @@
 
 #include <Arduino.h>
 #include <ratpak.h>
+#include <Rational.hpp>
 
 class MemRegister
 {
 public:
   MemRegister()
   {
-    _reg = nullptr;
   }
 
   virtual ~MemRegister()
@@ -26,19 +26,32 @@ public:
   {
     if (!zerrat(p))
     {
-      DUPRAT(_reg, p);
+      _reg.assign(p);
     }
     else
     {
-      destroyrat(_reg);
+      _reg.reset();
+    }
+  }
+
+  // takes ownership of the value
+  void set(Rational &&r)
+  {
+    if (!r.empty() && !zerrat(r.get()))
+    {
+      _reg = std::move(r);
+    }
+    else
+    {
+      _reg.reset();
     }
   }
 
   PRAT get() const
   {
-    if (_reg != nullptr)
+    if (!_reg.empty())
     {
-      return (_reg);
+      return (_reg.get());
     }
     else
     {
@@ -48,9 +61,15 @@ public:
 
   void clear()
   {
-    destroyrat(_reg);
+    _reg.reset();
+  }
+
+  // shares the value, empty if the register is zero
+  Rational clone() const
+  {
+    return (_reg.clone());
   }
 
 private:
-  PRAT _reg;
-};
+  Rational _reg;
+};
\ No newline at end of file
@@ -0,0 +1,312 @@
+// Rational.hpp
+
+// owning wrapper for ratpak rationals
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <utility>
+#include <ratpak.h>
+
+// owns a PRAT and releases it when going out of scope, also when a ratpak
+// call throws. Moving a Rational moves the pointer, copies have to be made
+// explicitly with clone(). Clones share the number until one of them is
+// modified (copy on write), so handing values between registers is cheap.
+// Sharing is not thread safe, a Rational and its clones belong to one task.
+class Rational
+{
+public:
+  // empty rational
+  Rational() : _p(nullptr)
+  {
+  }
+
+  // rational from an integer
+  explicit Rational(int32_t i) : _p(i32torat(i))
+  {
+  }
+
+  // take ownership of a PRAT
+  static Rational adopt(PRAT p)
+  {
+    Rational r;
+    r._p = p;
+    return (r);
+  }
+
+  // deep copy of a PRAT
+  static Rational copyOf(PRAT p)
+  {
+    Rational r;
+    r.assign(p);
+    return (r);
+  }
+
+  Rational(Rational &&other) noexcept : _p(other._p)
+  {
+    other._p = nullptr;
+  }
+
+  Rational &operator=(Rational &&other) noexcept
+  {
+    if (this != &other)
+    {
+      unref();
+      _p = other._p;
+      other._p = nullptr;
+    }
+    return (*this);
+  }
+
+  Rational(const Rational &) = delete;
+  Rational &operator=(const Rational &) = delete;
+
+  ~Rational()
+  {
+    unref();
+  }
+
+  // copy that shares the number until one side modifies it
+  Rational clone() const
+  {
+    Rational r;
+    if (_p != nullptr)
+    {
+      _p->cshare++;
+      r._p = _p;
+    }
+    return (r);
+  }
+
+  // replace the value by a copy of p
+  void assign(PRAT p)
+  {
+    PRAT q = nullptr;
+    if (p != nullptr)
+    {
+      DUPRAT(q, p);
+    }
+    unref();
+    _p = q;
+  }
+
+  // replace the number in place, the clones sharing it get the new value as well
+  void replaceShared(Rational &&other)
+  {
+    PRAT q = other.release();
+    std::swap(_p->pp, q->pp);
+    std::swap(_p->pq, q->pq);
+    destroyrat(q);
+  }
+
+  // release the value
+  void reset()
+  {
+    unref();
+  }
+
+  // give up ownership, the caller has to destroy the returned PRAT
+  PRAT release()
+  {
+    unshare();
+    PRAT p = _p;
+    _p = nullptr;
+    return (p);
+  }
+
+  // true if the number is shared with a clone
+  bool shared() const
+  {
+    return ((_p != nullptr) && (_p->cshare > 0));
+  }
+
+  // heap used by a number, a shared number is counted fully
+  static uint32_t bytes(PRAT p)
+  {
+    if (p == nullptr)
+    {
+      return (0);
+    }
+    return (sizeof(RAT) + 2 * sizeof(NUMBER) + (p->pp->cdigit + p->pq->cdigit) * sizeof(MANTTYPE));
+  }
+
+  // true if there is no value
+  bool empty() const
+  {
+    return (_p == nullptr);
+  }
+
+  // the owned PRAT for read access
+  PRAT get() const
+  {
+    return (_p);
+  }
+
+  // address of the owned PRAT for in place ratpak calls,
+  // a shared number is copied first
+  PRAT *ptr()
+  {
+    unshare();
+    return (&_p);
+  }
+
+  // change sign
+  void negate()
+  {
+    unshare();
+    _p->pp->sign *= -1;
+  }
+
+  // in place arithmetic, uses the precision of the current ratpak context
+  Rational &operator+=(PRAT y)
+  {
+    addrat(ptr(), y, g_ratctx->precision);
+    return (*this);
+  }
+
+  Rational &operator-=(PRAT y)
+  {
+    subrat(ptr(), y, g_ratctx->precision);
+    return (*this);
+  }
+
+  Rational &operator*=(PRAT y)
+  {
+    mulrat(ptr(), y, g_ratctx->precision);
+    return (*this);
+  }
+
+  Rational &operator/=(PRAT y)
+  {
+    divrat(ptr(), y, g_ratctx->precision);
+    return (*this);
+  }
+
+  Rational &operator%=(PRAT y)
+  {
+    modrat(ptr(), y);
+    return (*this);
+  }
+
+  Rational &operator+=(const Rational &y)
+  {
+    return (*this += y._p);
+  }
+
+  Rational &operator-=(const Rational &y)
+  {
+    return (*this -= y._p);
+  }
+
+  Rational &operator*=(const Rational &y)
+  {
+    return (*this *= y._p);
+  }
+
+  Rational &operator/=(const Rational &y)
+  {
+    return (*this /= y._p);
+  }
+
+  Rational &operator%=(const Rational &y)
+  {
+    return (*this %= y._p);
+  }
+
+  Rational operator+(const Rational &y) const
+  {
+    Rational r = clone();
+    r += y;
+    return (r);
+  }
+
+  Rational operator-(const Rational &y) const
+  {
+    Rational r = clone();
+    r -= y;
+    return (r);
+  }
+
+  Rational operator*(const Rational &y) const
+  {
+    Rational r = clone();
+    r *= y;
+    return (r);
+  }
+
+  Rational operator/(const Rational &y) const
+  {
+    Rational r = clone();
+    r /= y;
+    return (r);
+  }
+
+  Rational operator-() const
+  {
+    Rational r = clone();
+    r.negate();
+    return (r);
+  }
+
+  // comparisons, use the precision of the current ratpak context
+  bool operator==(const Rational &y) const
+  {
+    return (rat_equ(_p, y._p, g_ratctx->precision));
+  }
+
+  bool operator!=(const Rational &y) const
+  {
+    return (!rat_equ(_p, y._p, g_ratctx->precision));
+  }
+
+  bool operator<(const Rational &y) const
+  {
+    return (rat_lt(_p, y._p, g_ratctx->precision));
+  }
+
+  bool operator<=(const Rational &y) const
+  {
+    return (rat_le(_p, y._p, g_ratctx->precision));
+  }
+
+  bool operator>(const Rational &y) const
+  {
+    return (rat_gt(_p, y._p, g_ratctx->precision));
+  }
+
+  bool operator>=(const Rational &y) const
+  {
+    return (rat_ge(_p, y._p, g_ratctx->precision));
+  }
+
+private:
+  PRAT _p;
+
+  // drop this owner, the last one destroys the number
+  void unref()
+  {
+    if ((_p != nullptr) && (_p->cshare > 0))
+    {
+      _p->cshare--;
+      _p = nullptr;
+    }
+    else
+    {
+      destroyrat(_p);
+    }
+  }
+
+  // get an own copy of a shared number before modifying it
+  void unshare()
+  {
+    if (shared())
+    {
+      PRAT p = nullptr;
+      DUPRAT(p, _p);
+      _p->cshare--;
+      _p = p;
+    }
+  }
+};
@@ -0,0 +1,415 @@
+// ScaledInt.hpp
+
+// decimal numbers as 128 bit integers with a power of ten scale
+// fast path for the basic operations on exact decimals
+
+// Copyright (C) 2020-2025 highvoltglow
+// Licensed under the MIT License
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <ratpak.h>
+
+// largest scale, 10^38 still fits in 128 bits
+constexpr int32_t SCALED_INT_MAX_SCALE = 38;
+
+// 128 bit natural number, least significant limb first
+typedef std::array<uint32_t, 4> MAG128;
+
+// the value is mantissa * 10^-scale, the mantissa has no trailing decimal
+// zeros unless the scale is 0. The operations are exact and need no heap,
+// they return false on an overflow or if the result is no exact decimal,
+// the rationals have to do the operation then.
+class ScaledInt
+{
+public:
+  // zero
+  ScaledInt() : _neg(false), _scale(0), _mant({0, 0, 0, 0})
+  {
+  }
+
+  // exact decimal from a ratpak rational, false if there is none or it does not fit
+  static bool fromRat(PRAT p, ScaledInt *r)
+  {
+    MAG128 num;
+    MAG128 den;
+    if (!fromNum(p->pp, &num) || !fromNum(p->pq, &den) || isZero(den))
+    {
+      return (false);
+    }
+    if (isZero(num))
+    {
+      *r = ScaledInt();
+      return (true);
+    }
+    // the BASEX exponents go into the numerator or the denominator
+    for (int32_t e = p->pp->exp - p->pq->exp; e != 0; e += (e > 0 ? -1 : 1))
+    {
+      if (!mulSmall(e > 0 ? num : den, BASEX))
+      {
+        return (false);
+      }
+    }
+    r->_neg = (p->pp->sign < 0) != (p->pq->sign < 0);
+    return (r->setQuotient(num, den, 0));
+  }
+
+  // ratpak rational mantissa / 10^scale
+  PRAT toRat() const
+  {
+    MAG128 den = {1, 0, 0, 0};
+    for (int32_t i = 0; i < _scale; i++)
+    {
+      mulSmall(den, 10);
+    }
+    PRAT p = nullptr;
+    createrat(p);
+    p->cshare = 0;
+    p->pp = toNum(_mant);
+    p->pp->sign = _neg ? -1 : 1;
+    p->pq = toNum(den);
+    p->pq->sign = 1;
+    return (p);
+  }
+
+  bool isZero() const
+  {
+    return (isZero(_mant));
+  }
+
+  // a + b
+  static bool add(const ScaledInt &a, const ScaledInt &b, ScaledInt *r)
+  {
+    // both mantissas at the larger scale
+    int32_t scale = std::max(a._scale, b._scale);
+    MAG128 ma = a._mant;
+    MAG128 mb = b._mant;
+    if (!mulPow10(ma, scale - a._scale) || !mulPow10(mb, scale - b._scale))
+    {
+      return (false);
+    }
+    if (a._neg == b._neg)
+    {
+      if (!addMag(ma, mb, &r->_mant))
+      {
+        return (false);
+      }
+      r->_neg = a._neg;
+    }
+    else if (cmpMag(ma, mb) >= 0)
+    {
+      r->_mant = subMag(ma, mb);
+      r->_neg = a._neg;
+    }
+    else
+    {
+      r->_mant = subMag(mb, ma);
+      r->_neg = b._neg;
+    }
+    r->_scale = scale;
+    r->normalize();
+    return (true);
+  }
+
+  // a - b
+  static bool sub(const ScaledInt &a, const ScaledInt &b, ScaledInt *r)
+  {
+    ScaledInt nb = b;
+    nb._neg = !b._neg;
+    return (add(a, nb, r));
+  }
+
+  // a * b
+  static bool mul(const ScaledInt &a, const ScaledInt &b, ScaledInt *r)
+  {
+    if (!mulMag(a._mant, b._mant, &r->_mant))
+    {
+      return (false);
+    }
+    r->_neg = a._neg != b._neg;
+    r->_scale = a._scale + b._scale;
+    r->normalize();
+    return (r->_scale <= SCALED_INT_MAX_SCALE);
+  }
+
+  // a / b, b is not zero, false if the quotient is no exact decimal
+  static bool div(const ScaledInt &a, const ScaledInt &b, ScaledInt *r)
+  {
+    r->_neg = a._neg != b._neg;
+    return (r->setQuotient(a._mant, b._mant, a._scale - b._scale));
+  }
+
+  // divide by 10^n
+  bool divPow10(int32_t n)
+  {
+    _scale += n;
+    normalize();
+    return (_scale <= SCALED_INT_MAX_SCALE);
+  }
+
+private:
+  bool _neg;
+  int32_t _scale;
+  MAG128 _mant;
+
+  // num / den * 10^-scale, false if it is no exact decimal
+  bool setQuotient(MAG128 num, MAG128 den, int32_t scale)
+  {
+    // den = 2^a * 5^b * rest, the rest has to divide num
+    MAG128 q;
+    int32_t a = trailingZeros(den);
+    int32_t b = 0;
+    shiftRight(den, a);
+    while (divSmall(den, 5, &q) == 0)
+    {
+      den = q;
+      b++;
+    }
+    if (cmpMag(den, {1, 0, 0, 0}) != 0)
+    {
+      MAG128 rem;
+      divMag(num, den, &q, &rem);
+      if (!isZero(rem))
+      {
+        return (false);
+      }
+      num = q;
+    }
+    // 2^a * 5^b is widened to 10^max(a, b)
+    for (; a < b; a++)
+    {
+      if (!mulSmall(num, 2))
+      {
+        return (false);
+      }
+    }
+    for (; b < a; b++)
+    {
+      if (!mulSmall(num, 5))
+      {
+        return (false);
+      }
+    }
+    scale += a;
+    if ((scale < 0) && !mulPow10(num, -scale))
+    {
+      return (false);
+    }
+    _mant = num;
+    _scale = std::max(scale, 0);
+    normalize();
+    return (_scale <= SCALED_INT_MAX_SCALE);
+  }
+
+  // remove trailing zeros, zero has no sign
+  void normalize()
+  {
+    MAG128 q;
+    while ((_scale > 0) && (divSmall(_mant, 10, &q) == 0))
+    {
+      _mant = q;
+      _scale--;
+    }
+    if (isZero(_mant))
+    {
+      _neg = false;
+      _scale = 0;
+    }
+  }
+
+  // natural number from a ratpak number, without the exponent
+  static bool fromNum(PNUMBER pnum, MAG128 *m)
+  {
+    *m = {0, 0, 0, 0};
+    for (int32_t i = pnum->cdigit - 1; i >= 0; i--)
+    {
+      if (!mulSmall(*m, BASEX) || !addMag(*m, {pnum->mant[i], 0, 0, 0}, m))
+      {
+        return (false);
+      }
+    }
+    return (true);
+  }
+
+  // ratpak integer from a natural number
+  static PNUMBER toNum(MAG128 m)
+  {
+    // 128 bits are at most 5 digits of 2^31 or 10^9
+    MANTTYPE digits[5];
+    int32_t count = 0;
+    do
+    {
+      digits[count++] = divSmall(m, BASEX, &m);
+    } while (!isZero(m));
+    PNUMBER pnum = _createnum(static_cast<uint32_t>(count));
+    pnum->cdigit = count;
+    pnum->exp = 0;
+    for (int32_t i = 0; i < count; i++)
+    {
+      pnum->mant[i] = digits[i];
+    }
+    return (pnum);
+  }
+
+  static bool isZero(const MAG128 &m)
+  {
+    return ((m[0] | m[1] | m[2] | m[3]) == 0);
+  }
+
+  static int cmpMag(const MAG128 &a, const MAG128 &b)
+  {
+    for (size_t i = 4; i-- > 0;)
+    {
+      if (a[i] != b[i])
+      {
+        return (a[i] < b[i] ? -1 : 1);
+      }
+    }
+    return (0);
+  }
+
+  // false on overflow
+  static bool addMag(const MAG128 &a, const MAG128 &b, MAG128 *r)
+  {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < 4; i++)
+    {
+      carry += static_cast<uint64_t>(a[i]) + b[i];
+      (*r)[i] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    return (carry == 0);
+  }
+
+  // a - b modulo 2^128
+  static MAG128 subMag(const MAG128 &a, const MAG128 &b)
+  {
+    MAG128 r;
+    int64_t borrow = 0;
+    for (size_t i = 0; i < 4; i++)
+    {
+      int64_t d = static_cast<int64_t>(a[i]) - b[i] - borrow;
+      borrow = d < 0 ? 1 : 0;
+      r[i] = static_cast<uint32_t>(d);
+    }
+    return (r);
+  }
+
+  // m * k in place, false on overflow
+  static bool mulSmall(MAG128 &m, uint32_t k)
+  {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < 4; i++)
+    {
+      carry += static_cast<uint64_t>(m[i]) * k;
+      m[i] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    return (carry == 0);
+  }
+
+  // m * 10^n in place, false on overflow
+  static bool mulPow10(MAG128 &m, int32_t n)
+  {
+    for (int32_t i = 0; i < n; i++)
+    {
+      if (!mulSmall(m, 10))
+      {
+        return (false);
+      }
+    }
+    return (true);
+  }
+
+  // false on overflow
+  static bool mulMag(const MAG128 &a, const MAG128 &b, MAG128 *r)
+  {
+    uint32_t t[8] = {};
+    for (size_t i = 0; i < 4; i++)
+    {
+      uint64_t carry = 0;
+      for (size_t j = 0; j < 4; j++)
+      {
+        carry += static_cast<uint64_t>(a[i]) * b[j] + t[i + j];
+        t[i + j] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+      }
+      t[i + 4] = static_cast<uint32_t>(carry);
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+      (*r)[i] = t[i];
+    }
+    return ((t[4] | t[5] | t[6] | t[7]) == 0);
+  }
+
+  // q = m / d, returns the remainder
+  static uint32_t divSmall(const MAG128 &m, uint32_t d, MAG128 *q)
+  {
+    uint64_t rem = 0;
+    for (size_t i = 4; i-- > 0;)
+    {
+      uint64_t cur = (rem << 32) | m[i];
+      // the upper limbs are mostly zero, the 64 bit division is slow without hardware
+      if (cur < d)
+      {
+        (*q)[i] = 0;
+        rem = cur;
+        continue;
+      }
+      (*q)[i] = static_cast<uint32_t>(cur / d);
+      rem = cur % d;
+    }
+    return (static_cast<uint32_t>(rem));
+  }
+
+  // number of trailing zero bits, 0 for zero
+  static int32_t trailingZeros(const MAG128 &m)
+  {
+    for (size_t i = 0; i < 4; i++)
+    {
+      if (m[i] != 0)
+      {
+        return (static_cast<int32_t>(i * 32 + __builtin_ctz(m[i])));
+      }
+    }
+    return (0);
+  }
+
+  // m / 2^n in place, n < 128
+  static void shiftRight(MAG128 &m, int32_t n)
+  {
+    size_t limbs = static_cast<size_t>(n / 32);
+    uint32_t bits = static_cast<uint32_t>(n % 32);
+    for (size_t i = 0; i < 4; i++)
+    {
+      uint64_t lo = (i + limbs < 4) ? m[i + limbs] : 0;
+      uint64_t hi = (i + limbs + 1 < 4) ? m[i + limbs + 1] : 0;
+      m[i] = static_cast<uint32_t>(((hi << 32) | lo) >> bits);
+    }
+  }
+
+  // u = q * v + r, bit by bit
+  static void divMag(const MAG128 &u, const MAG128 &v, MAG128 *q, MAG128 *r)
+  {
+    *q = {0, 0, 0, 0};
+    *r = {0, 0, 0, 0};
+    for (int32_t bit = 127; bit >= 0; bit--)
+    {
+      // r = 2 * r + next bit of u, the bit shifted out is kept in carry
+      bool carry = ((*r)[3] & 0x80000000) != 0;
+      for (size_t i = 4; i-- > 1;)
+      {
+        (*r)[i] = ((*r)[i] << 1) | ((*r)[i - 1] >> 31);
+      }
+      (*r)[0] = ((*r)[0] << 1) | ((u[bit / 32] >> (bit % 32)) & 1);
+      if (carry || (cmpMag(*r, v) >= 0))
+      {
+        *r = subMag(*r, v);
+        (*q)[bit / 32] |= 1u << (bit % 32);
+      }
+    }
+  }
+};
@@ -81,11 +81,17 @@ public:
     _settings[setting_id::timercolor] = new Setting(setting_id::timercolor, "timercolor", setting_type::rgb, Helper::rgbToInt(255, 255, 255), 0, MAX_RGB_INT);
     _settings[setting_id::fixeddecimals] = new Setting(setting_id::fixeddecimals, "fixeddecimals", setting_type::numeric, fixed_decimals::off, fixed_decimals::off, fixed_decimals::eight);
     _settings[setting_id::anglemode] = new Setting(setting_id::anglemode, "anglemode", setting_type::numeric, angle_mode::degrees, angle_mode::degrees, angle_mode::radians);
-    _settings[setting_id::showbusycalc] = new Setting(setting_id::showbusycalc, "showbusycalc", setting_type::numeric, show_busy_calc::moving_decimal_separator, show_busy_calc::off, show_busy_calc::digit_flickering);
+    _settings[setting_id::showbusycalc] = new Setting(setting_id::showbusycalc, "showbusycalc", setting_type::numeric, show_busy_calc::moving_decimal_separator, show_busy_calc::off, show_busy_calc::progressive);
     _settings[setting_id::maxexpdigits] = new Setting(setting_id::maxexpdigits, "maxexpdigits", setting_type::numeric, 4, 2, 4);
     _settings[setting_id::scrolldelay] = new Setting(setting_id::scrolldelay, "scrolldelay", setting_type::numeric, 5, 1, 20);
     _settings[setting_id::calcprecision] = new Setting(setting_id::calcprecision, "calcprecision", setting_type::numeric, 32, 20, 32);
     _settings[setting_id::brightness] = new Setting(setting_id::brightness, "brightness", setting_type::numeric, 8, 1, 15);
+    _settings[setting_id::calcbackend] = new Setting(setting_id::calcbackend, "calcbackend", setting_type::numeric, CALC_BACKEND, calc_backend::rational, calc_backend::binary_float);
+    _settings[setting_id::calctimelimit] = new Setting(setting_id::calctimelimit, "calctimelimit", setting_type::numeric, 30, 0, 600);
+    _settings[setting_id::algmode] = new Setting(setting_id::algmode, "algmode", setting_type::numeric, alg_mode::precedence, alg_mode::immediate, alg_mode::precedence);
+    _settings[setting_id::undomemory] = new Setting(setting_id::undomemory, "undomemory", setting_type::numeric, 8, 0, 64);
+    _settings[setting_id::stackmode] = new Setting(setting_id::stackmode, "stackmode", setting_type::numeric, stack_mode::classic, stack_mode::classic, stack_mode::unlimited);
+    _settings[setting_id::fastdouble] = new Setting(setting_id::fastdouble, "fastdouble", setting_type::numeric, fast_double::off, fast_double::off, fast_double::on);
   }
 
   virtual ~Settings()
@@ -298,6 +304,12 @@ public:
     getSetting(setting_id::scrolldelay, &SettingsCache::scrollDelay);
     getSetting(setting_id::calcprecision, &SettingsCache::calcPrecision);
     getSetting(setting_id::brightness, &SettingsCache::brightness);
+    getSetting(setting_id::calcbackend, reinterpret_cast<int *>(&SettingsCache::calcBackend));
+    getSetting(setting_id::calctimelimit, &SettingsCache::calcTimeLimit);
+    getSetting(setting_id::algmode, reinterpret_cast<int *>(&SettingsCache::algMode));
+    getSetting(setting_id::undomemory, &SettingsCache::undoMemory);
+    getSetting(setting_id::stackmode, reinterpret_cast<int *>(&SettingsCache::stackMode));
+    getSetting(setting_id::fastdouble, reinterpret_cast<int *>(&SettingsCache::fastDouble));
   }
 
   // reset all settings to the default value
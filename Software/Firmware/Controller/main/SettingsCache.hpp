@@ -65,4 +65,10 @@ public:
   inline static int scrollDelay;
   inline static int calcPrecision;
   inline static int brightness;
+  inline static calc_backend::calc_backend calcBackend;
+  inline static int calcTimeLimit;
+  inline static alg_mode::alg_mode algMode;
+  inline static int undoMemory;
+  inline static stack_mode::stack_mode stackMode;
+  inline static fast_double::fast_double fastDouble;
 };
\ No newline at end of file